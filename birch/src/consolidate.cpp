@@ -2,7 +2,39 @@
 #include <stdexcept>
 #include <boost/algorithm/string/trim.hpp>
 
-uon::Value consolidate(std::map<std::string, uon::Value> reports)
+namespace {
+
+// paths used inside the per-result loops, parsed once
+namespace paths {
+
+const uon::Path type("type");
+const uon::Path message("message");
+const uon::Path filename("filename");
+const uon::Path row("row");
+const uon::Path severity("severity");
+const uon::Path file("file");
+const uon::Path line("line");
+const uon::Path hosts("hosts");
+const uon::Path name("name");
+const uon::Path status("status");
+const uon::Path result("result");
+const uon::Path details("details");
+
+} // namespace: paths
+
+// queries used per task, compiled once
+namespace queries {
+
+const uon::Query warnings("details.*[type=warning]");
+const uon::Query errors("details.*[type=error]");
+const uon::Query tests("details.tests.*.*");
+const uon::Query failed_tests("details.*.*[result=Error]");
+
+} // namespace: queries
+
+} // namespace
+
+uon::Value consolidate(uon::ObjectView reports)
 {
 	if(reports.size() == 0)
 	{
@@ -20,7 +52,7 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 	// meta: archs
 	uon::Object meta_archs;
 
-	for(auto report : reports)
+	for(auto& report : reports)
 	{
 		auto host_descr = report.second.get("meta.arch.host.descriptor").to_string();
 
@@ -32,9 +64,9 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 	// meta: buildgap
 	uon::Array meta_buildgap;
 
-	for(auto report : reports)
+	for(auto& report : reports)
 	{
-		auto buildgap = report.second.get("meta.buildgap").to_array();
+		auto buildgap = report.second.getref("meta.buildgap").array_view();
 
 		meta_buildgap.insert(meta_buildgap.end(), buildgap.begin(), buildgap.end());
 	}
@@ -46,7 +78,7 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 	// meta: trigger
 	uon::Array meta_trigger;
 
-	for(auto report : reports)
+	for(auto& report : reports)
 	{
 		auto trigger = report.second.get("meta.trigger", uon::Null());
 
@@ -67,11 +99,11 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 
 	uon::Object tasks_cs;
 
-	for(auto report : reports)
+	for(auto& report : reports)
 	{
 		auto host_descr = report.second.get("meta.arch.host.descriptor").to_string();
 
-		for(auto task : report.second.get("tasks").to_object())
+		for(auto& task : report.second.getref("tasks").object_view())
 		{
 			uon::Value& task_cs = tasks_cs[task.first];
 
@@ -144,18 +176,18 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 			if(type == "build:cmake")
 			{
 				// consolidate results
-				auto results_cs = task_cs.get("details", uon::Array()).to_array();
+				auto results_cs = task_cs.get(paths::details, uon::Array()).to_array();
 
-				for(auto result : task.second.get("details.results", uon::Array()).to_array())
+				for(auto& result : uon::ArrayView(task.second.find("details.results")))
 				{
 					auto entry_cs = results_cs.end();
 
 					for(auto i = results_cs.begin(); i != results_cs.end(); ++i)
 					{
-						if(    i->get("type") == result.get("type")
-							&& i->get("message") == result.get("message")
-							&& i->get("filename") == result.get("filename")
-							&& i->get("row") == result.get("row")
+						if(    i->get(paths::type) == result.get(paths::type)
+							&& i->get(paths::message) == result.get(paths::message)
+							&& i->get(paths::filename) == result.get(paths::filename)
+							&& i->get(paths::row) == result.get(paths::row)
 							// && i->get("column") == result.get("column")
 						)
 						{
@@ -170,54 +202,39 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 						entry_cs = results_cs.end() - 1;
 					}
 
-					auto hosts_cs = entry_cs->get("hosts", uon::Array()).to_array();
+					auto hosts_cs = entry_cs->get(paths::hosts, uon::Array()).to_array();
 
 					if(std::find(hosts_cs.begin(), hosts_cs.end(), uon::Value(host_descr)) == hosts_cs.end())
 					{
 						hosts_cs.push_back(uon::Value(host_descr));
 					}
 
-					entry_cs->set("hosts", hosts_cs);
+					entry_cs->set(paths::hosts, hosts_cs);
 				}
 
-				task_cs.set("details", results_cs);
+				task_cs.set(paths::details, results_cs);
 
 				// consolidate warnings and errors
-				std::size_t warnings_cs = 0, errors_cs = 0;
-
-				for(auto i : results_cs)
-				{
-					if(i.get("type").to_string() == "error")
-					{
-						errors_cs += 1;
-					}
-					else
-					if(i.get("type").to_string() == "warning")
-					{
-						warnings_cs += 1;
-					}
-				}
-
-				task_cs.set( "warnings", warnings_cs );
-				task_cs.set( "errors", errors_cs );
+				task_cs.set( "warnings", (std::uint64_t)queries::warnings.count(task_cs) );
+				task_cs.set( "errors", (std::uint64_t)queries::errors.count(task_cs) );
 			}
 			else
 			if(type == "analysis:cppcheck")
 			{
 				// consolidate results
-				auto results_cs = task_cs.get("details", uon::Array()).to_array();
+				auto results_cs = task_cs.get(paths::details, uon::Array()).to_array();
 
-				for(auto result : task.second.get("details.errors", uon::Array()).to_array())
+				for(auto& result : uon::ArrayView(task.second.find("details.errors")))
 				{
 					auto entry_cs = results_cs.end();
 
 					for(auto i = results_cs.begin(); i != results_cs.end(); ++i)
 					{
-						if(    i->get("type") == result.get("type")
-							&& i->get("message") == result.get("message")
-							&& i->get("severity") == result.get("severity")
-							&& i->get("file") == result.get("file")
-							&& i->get("line") == result.get("line")
+						if(    i->get(paths::type) == result.get(paths::type)
+							&& i->get(paths::message) == result.get(paths::message)
+							&& i->get(paths::severity) == result.get(paths::severity)
+							&& i->get(paths::file) == result.get(paths::file)
+							&& i->get(paths::line) == result.get(paths::line)
 						)
 						{
 							entry_cs = i;
@@ -231,17 +248,17 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 						entry_cs = results_cs.end() - 1;
 					}
 
-					auto hosts_cs = entry_cs->get("hosts", uon::Array()).to_array();
+					auto hosts_cs = entry_cs->get(paths::hosts, uon::Array()).to_array();
 
 					if(std::find(hosts_cs.begin(), hosts_cs.end(), uon::Value(host_descr)) == hosts_cs.end())
 					{
 						hosts_cs.push_back(uon::Value(host_descr));
 					}
 
-					entry_cs->set("hosts", hosts_cs);
+					entry_cs->set(paths::hosts, hosts_cs);
 				}
 
-				task_cs.set("details", results_cs);
+				task_cs.set(paths::details, results_cs);
 
 				// consolidate warnings
 				task_cs.set( "warnings", results_cs.size() );
@@ -249,52 +266,40 @@ uon::Value consolidate(std::map<std::string, uon::Value> reports)
 			else
 			if(type == "test:googletest")
 			{
-				for(auto testsuite : task.second.get("details.tests", uon::Object()).to_object())
+				queries::tests.for_each(task.second, [&](const uon::Value& test, const uon::VisitPath& path)
 				{
-					for(auto test : testsuite.second.to_object())
-					{
-						auto test_cs = task_cs.get({"details", testsuite.first, test.first}, uon::Object{
-							{"name", test.second.get("name")},
-							{"result", test.second.get("result")},
-							{"status", test.second.get("status")},
-							{"message", uon::Object()}
-						});
-
-						if(test.second.get("result") == "Error")
-						{
-							test_cs.set("result", "Error");
-						}
-
-						if(test_cs.get("status") != test.second.get("status"))
-						{
-							test_cs.set("status", "mixed");
-						}
+					// details.tests.<testsuite>.<test>
+					uon::Path test_path({"details", *path[2].key, *path[3].key});
 
-						auto msg = boost::trim_copy(test.second.get("message").to_string());
+					auto test_cs = task_cs.get(test_path, uon::Object{
+						{"name", test.get(paths::name)},
+						{"result", test.get(paths::result)},
+						{"status", test.get(paths::status)},
+						{"message", uon::Object()}
+					});
 
-						if(msg.length() > 0)
-						{
-							test_cs.set( {"message", host_descr}, msg );
-						}
+					if(test.get(paths::result) == "Error")
+					{
+						test_cs.set(paths::result, "Error");
+					}
 
-						task_cs.set( {"details", testsuite.first, test.first}, test_cs );
+					if(test_cs.get(paths::status) != test.get(paths::status))
+					{
+						test_cs.set(paths::status, "mixed");
 					}
-				}
 
-				std::size_t errors = 0;
+					auto msg = boost::trim_copy(test.get(paths::message).to_string());
 
-				for(auto testsuite : task_cs.get("details", uon::Object()).to_object())
-				{
-					for(auto test : testsuite.second.to_object())
+					if(msg.length() > 0)
 					{
-						if(test.second.get("result") == "Error")
-						{
-							errors += 1;
-						}
+						test_cs.set( {"message", host_descr}, msg );
 					}
-				}
 
-				task_cs.set( "errors", (std::uint64_t)errors );
+					task_cs.set( test_path, std::move(test_cs) );
+					return uon::Visit::next;
+				});
+
+				task_cs.set( "errors", (std::uint64_t)queries::failed_tests.count(task_cs) );
 			}
 		}
 	}
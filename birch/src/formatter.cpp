@@ -69,7 +69,14 @@ std::string github_link(std::string repo_url, std::string commit, std::string ty
 
 } // namespace: _html
 
-void html(uon::Value input, std::ostream& output)
+namespace queries {
+
+// consolidated googletest details are details.<testsuite>.<test>
+const uon::Query tests("details.*.*");
+
+} // namespace: queries
+
+void html(const uon::Value& input, std::ostream& output)
 {
 	using namespace _html;
 
@@ -106,7 +113,7 @@ void html(uon::Value input, std::ostream& output)
 	output << "<tr><th>Commit:</th><td>" << _html::github_link(meta.get("repository", uon::null).to_string(), meta.get("commit.id.long", uon::null).to_string(), "tree", "", boost::optional<std::size_t>(), meta.get("commit.id.long", uon::null).to_string()) << "</td></tr>" << std::endl;
 	output << "<tr><th>Timestamp:</th><td>" << _html::escape(meta.get("commit.timestamp.default", uon::null).to_string()) << "</td></tr>" << std::endl;
 	output << "<tr><th>Architectures:</th><td><ul>" << std::endl;
-	for(auto arch : meta.get("archs").to_array())
+	for(auto& arch : meta.getref("archs").array_view())
 	{
 		output << "<li>" << _html::escape(arch.get("host.descriptor", uon::null).to_string()) << "</li>" << std::endl;
 	}
@@ -117,14 +124,14 @@ void html(uon::Value input, std::ostream& output)
 
 	output << "<h1>Tasks</h1>" << std::endl << std::endl;
 
-	auto tasks = input.get("tasks", uon::null).to_object();
+	uon::ObjectView tasks(input.find("tasks"));
 
 	if(tasks.size() > 0)
 	{
 		output << "<table class=\"tasks table table-condensed table-hover table-bordered\">" << std::endl;
 		output << "<tr><th>Name</th><th>Type</th><th>Warnings</th><th>Errors</th><th>Status</th></tr>" << std::endl;
 
-		for(auto task : tasks)
+		for(auto& task : tasks)
 		{
 			auto status = task.second.get("status.consolidated", uon::null).to_string();
 
@@ -156,7 +163,7 @@ void html(uon::Value input, std::ostream& output)
 
 	output << std::endl;
 
-	for(auto task : tasks)
+	for(auto& task : tasks)
 	{
 		output << "<h2><a name=\"" << task.first << "\">Task: " << _html::escape(task.first) << "</a></h2>" << std::endl << std::endl;
 
@@ -166,13 +173,13 @@ void html(uon::Value input, std::ostream& output)
 		output << "<tr><th>Type:</th><td>" << _html::escape(taskType) << "</td></tr>" << std::endl;
 		output << "<tr><th>Messages:</th><td>";
 
-		auto messages = task.second.get("message", uon::null).to_object();
+		uon::ObjectView messages(task.second.find("message"));
 
 		if(messages.size() > 0)
 		{
 			output << "<table class=\"task-messages\">";
 
-			for(auto message : messages)
+			for(auto& message : messages)
 			{
 				output << "<tr><td>" << _html::escape(message.first) << ":</td><td>" << _html::escape(message.second.to_string()) << "</td></tr>";
 			}
@@ -206,14 +213,14 @@ void html(uon::Value input, std::ostream& output)
 
 		if(taskType == "analysis:cppcheck")
 		{
-			auto errors = task.second.get("details", uon::null).to_array();
+			uon::ArrayView errors(task.second.find("details"));
 
 			if(errors.size() > 0)
 			{
 				output << "<table class=\"task-analysis-cppcheck table table-condensed table-hover table-bordered\">" << std::endl;
 				output << "<tr><th>Type</th><th>Severity</th><th>Message</th><th>File</th><th>Line</th></tr>" << std::endl;
 
-				for(auto error : errors)
+				for(auto& error : errors)
 				{
 					output << "<tr class=\"warning\"><td>"
 						<< _html::escape(error.get("type", uon::null).to_string()) << "</td><td>"
@@ -233,14 +240,14 @@ void html(uon::Value input, std::ostream& output)
 		else
 		if(taskType == "build:cmake")
 		{
-			auto results = task.second.get("details", uon::null).to_array();
+			uon::ArrayView results(task.second.find("details"));
 
 			if(results.size() > 0)
 			{
 				output << "<table class=\"task-build-cmake table table-condensed table-hover table-bordered\">" << std::endl;
 				output << "<tr><th>Type</th><th>Message</th><th>File</th><th>Row</th><th>Column</th></tr>" << std::endl;
 
-				for(auto result : results)
+				for(auto& result : results)
 				{
 					if(result.get("type", uon::null).to_string() == "warning")
 					{
@@ -279,18 +286,34 @@ void html(uon::Value input, std::ostream& output)
 		else
 		if(taskType == "test:googletest")
 		{
-			auto tests = task.second.get("details", uon::null).to_object();
+			uon::ObjectView tests(task.second.find("details"));
 
 			if(tests.size() > 0)
 			{
 				output << "<table class=\"task-test-googletest table table-condensed table-hover table-bordered\">" << std::endl;
 				output << "<tr><th>Name</th><th>Status</th><th>Result</th></tr>" << std::endl;
 
-				for(auto testsuite : tests)
+				queries::tests.for_each(task.second, [&](const uon::Value& test, const uon::VisitPath&)
 				{
-					for(auto test : testsuite.second.to_object())
+					if(test.get("result", uon::null).to_string() == "Ok")
 					{
-						if(test.second.get("result", uon::null).to_string() == "Ok")
+						output << "<tr class=\"success\">";
+					}
+					else
+					{
+						output << "<tr class=\"danger\">";
+					}
+
+					output << "<td>"
+						<< _html::escape(test.get("name", uon::null).to_string()) << "</td><td>"
+						<< _html::escape(test.get("status", uon::null).to_string()) << "</td><td>"
+						<< _html::escape(test.get("result", uon::null).to_string()) << "</td></tr>" << std::endl;
+
+					uon::ObjectView messages(test.find("message"));
+
+					if(messages.size() > 0)
+					{
+						if(test.get("result", uon::null).to_string() == "Ok")
 						{
 							output << "<tr class=\"success\">";
 						}
@@ -299,35 +322,18 @@ void html(uon::Value input, std::ostream& output)
 							output << "<tr class=\"danger\">";
 						}
 
-						output << "<td>"
-							<< _html::escape(test.second.get("name", uon::null).to_string()) << "</td><td>"
-							<< _html::escape(test.second.get("status", uon::null).to_string()) << "</td><td>"
-							<< _html::escape(test.second.get("result", uon::null).to_string()) << "</td></tr>" << std::endl;
+						output << "<td colspan=\"3\"><table class=\"task-test-googletest-messages\">";
 
-						auto messages = test.second.get("message", uon::null).to_object();
-
-						if(messages.size() > 0)
+						for(auto& message : messages)
 						{
-							if(test.second.get("result", uon::null).to_string() == "Ok")
-							{
-								output << "<tr class=\"success\">";
-							}
-							else
-							{
-								output << "<tr class=\"danger\">";
-							}
-
-							output << "<td colspan=\"3\"><table class=\"task-test-googletest-messages\">";
-
-							for(auto message : messages)
-							{
-								output << "<tr><td style=\"font-size: 0.7em;\">" << _html::escape(message.first) << ":</td><td style=\"font-size: 0.7em;\">" << _html::escape(message.second.to_string()) << "</td></tr>";
-							}
-
-							output << "</table></td></tr>";
+							output << "<tr><td style=\"font-size: 0.7em;\">" << _html::escape(message.first) << ":</td><td style=\"font-size: 0.7em;\">" << _html::escape(message.second.to_string()) << "</td></tr>";
 						}
+
+						output << "</table></td></tr>";
 					}
-				}
+
+					return uon::Visit::next;
+				});
 
 				output << "</table>" << std::endl;
 				output << std::endl;
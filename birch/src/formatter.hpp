@@ -5,6 +5,6 @@
 
 namespace formatter {
 
-extern void html(uon::Value input, std::ostream& output);
+extern void html(const uon::Value& input, std::ostream& output);
 
 } // namespace: formatter
@@ -7,8 +7,8 @@
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
-extern uon::Value consolidate(std::map<std::string, uon::Value> reports);
-extern void notify(uon::Value report);
+extern uon::Value consolidate(uon::ObjectView reports);
+extern void notify(const uon::Value& report);
 
 static std::string collection = std::string("timberyard.reports");
 
@@ -104,13 +104,13 @@ int main(int argc, char** argv)
 
 			boost::filesystem::path input = boost::filesystem::absolute(argInput);
 
-			// read report
-			uon::Value report = uon::read_json(input / "reports" / "oak.json" );
+			// read report, only the meta data is looked at until it is verified
+			uon::LazyDocument document(input / "reports" / "oak.json");
 
 			// verify result
 			if(!argNode.empty())
 			{
-				if(report.get("meta.system.name").to_string() != argNode)
+				if(document.get("meta.system.name").to_string() != argNode)
 				{
 					throw std::runtime_error("invalid system name in report");
 				}
@@ -146,15 +146,20 @@ int main(int argc, char** argv)
 			std::cout << "creating mongo query and op..." << std::endl;
 
 			uon::Value query;
-			query.set("repository", report.get("meta.repository").to_string());
-			query.set("branch", report.get("meta.branch").to_string());
-			query.set("commit", report.get("meta.commit.id.long").to_string());
+			query.set("repository", document.get("meta.repository").to_string());
+			query.set("branch", document.get("meta.branch").to_string());
+			query.set("commit", document.get("meta.commit.id.long").to_string());
 
-			uon::Value op;
+			auto id = document.get("meta.id").to_string();
+			auto host = uon::escape_mongo_key(document.get("meta.arch.host.descriptor").to_string());
+
+			uon::Value report = document.value();
 			report.escape_mongo();
-			op.set( std::vector<std::string>{"$set", "hosts."+uon::escape_mongo_key(report.get("meta.arch.host.descriptor").to_string())}, report );
-			op.set( std::vector<std::string>{"$addToSet", "tasks.consolidation"}, report.get("meta.id").to_string() );
-			op.set( std::vector<std::string>{"$addToSet", "tasks.notification"}, report.get("meta.id").to_string() );
+
+			uon::Value op;
+			op.set( std::vector<std::string>{"$set", "hosts."+host}, std::move(report) );
+			op.set( std::vector<std::string>{"$addToSet", "tasks.consolidation"}, id );
+			op.set( std::vector<std::string>{"$addToSet", "tasks.notification"}, id );
 			op.set( std::vector<std::string>{"$set", "tasks.notification_timeout"}, (std::uint64_t)(std::time(nullptr) + (60 * 5)) );	// 5 minute timeout
 
 			auto mquery = uon::to_mongo_bson(query);
@@ -193,16 +198,19 @@ int main(int argc, char** argv)
 
 			std::cerr << "Handling report " << report.get("_id").to_string() << std::endl;
 
-			auto consolidated = consolidate(report.get("hosts").to_object());
+			auto consolidated = consolidate(report.getref("hosts").object_view());
 
 			std::cout << "creating mongo query and op..." << std::endl;
 
 			query = uon::null;
 			query.set("_id", report.get("_id"));
 
-			uon::Value obj;
+			// only what changed since the last consolidation is written
+			auto previous = report.get("consolidated", uon::null);
+			previous.escape_mongo();
 			consolidated.escape_mongo();
-			obj.set( std::vector<std::string>{"$set", "consolidated"}, consolidated );
+
+			uon::Value obj = uon::to_mongo_update(uon::diff(previous, consolidated), "consolidated");
 			obj.set( std::vector<std::string>{"$pull", "tasks.consolidation", "$in"}, report.get("tasks.consolidation").to_array() );
 
 			auto mquery = uon::to_mongo_bson(query);
@@ -243,7 +251,7 @@ int main(int argc, char** argv)
 
 			std::cerr << "Handling report " << report.get("_id").to_string() << std::endl;
 
-			notify(report.get("consolidated"));
+			notify(report.getref("consolidated"));
 
 			std::cout << "creating mongo query and op..." << std::endl;
 
@@ -4,7 +4,7 @@
 #include "formatter.hpp"
 #include "process.hpp"
 
-void notify(uon::Value report)
+void notify(const uon::Value& report)
 {
 	// generate set of receivers
 	std::set<std::string> receivers = { };
@@ -12,13 +12,13 @@ void notify(uon::Value report)
 	receivers.insert(report.get("meta.commit.author.email").to_string());
 	receivers.insert(report.get("meta.commit.committer.email").to_string());
 
-	for(auto buildgap : report.get("meta.buildgap").to_array())
+	for(auto& buildgap : report.getref("meta.buildgap").array_view())
 	{
 		receivers.insert(buildgap.get("author.email").to_string());
 		receivers.insert(buildgap.get("committer.email").to_string());
 	}
 
-	for(auto trigger : report.get("meta.trigger", uon::Null()).to_array())
+	for(auto& trigger : uon::ArrayView(report.find("meta.trigger")))
 	{
 		auto email = trigger.get("email", uon::Null());
 
@@ -0,0 +1,128 @@
+#include "uon.hpp"
+
+#include <iterator>
+
+namespace uon
+{
+
+Handler::~Handler()
+{
+}
+
+ValueBuilder::ValueBuilder()
+	: _depth(0)
+{
+}
+
+void ValueBuilder::null()
+{
+	add(Value());
+}
+
+void ValueBuilder::boolean(Boolean value)
+{
+	add(Value(value));
+}
+
+void ValueBuilder::integer(Integer value)
+{
+	add(Value(value));
+}
+
+void ValueBuilder::unsigned_integer(Unsigned value)
+{
+	add(Value(value));
+}
+
+void ValueBuilder::real(Real value)
+{
+	add(Value(value));
+}
+
+void ValueBuilder::string(const char* data, std::size_t length)
+{
+	add(Value(String(data, length)));
+}
+
+void ValueBuilder::begin_object()
+{
+	// frames are kept when closed, so their containers' capacity is reused
+	if(_depth == _stack.size())
+	{
+		_stack.emplace_back();
+	}
+
+	auto& frame = _stack[_depth++];
+	frame.object = true;
+	frame.members.clear();
+}
+
+void ValueBuilder::key(const char* data, std::size_t length)
+{
+	_scratch.assign(data, length);
+	auto key = _keys.find(_scratch);
+
+	if(key == _keys.end())
+	{
+		key = _keys.emplace(_scratch, Key(_scratch)).first;
+	}
+
+	_stack[_depth-1].key = key->second;
+}
+
+void ValueBuilder::end_object()
+{
+	auto& frame = _stack[--_depth];
+	Object::container_type members(std::make_move_iterator(frame.members.begin()), std::make_move_iterator(frame.members.end()));
+	frame.members.clear();
+
+	add(Value(Object(std::move(members))));
+}
+
+void ValueBuilder::begin_array()
+{
+	if(_depth == _stack.size())
+	{
+		_stack.emplace_back();
+	}
+
+	auto& frame = _stack[_depth++];
+	frame.object = false;
+	frame.elements.clear();
+}
+
+void ValueBuilder::end_array()
+{
+	auto& frame = _stack[--_depth];
+	Array elements(std::make_move_iterator(frame.elements.begin()), std::make_move_iterator(frame.elements.end()));
+	frame.elements.clear();
+
+	add(Value(std::move(elements)));
+}
+
+Value ValueBuilder::result()
+{
+	return std::move(_result);
+}
+
+void ValueBuilder::add(Value&& value)
+{
+	if(_depth == 0)
+	{
+		_result = std::move(value);
+		return;
+	}
+
+	auto& frame = _stack[_depth-1];
+
+	if(frame.object)
+	{
+		frame.members.push_back(Object::value_type(frame.key, std::move(value)));
+	}
+	else
+	{
+		frame.elements.push_back(std::move(value));
+	}
+}
+
+}
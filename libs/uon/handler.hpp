@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace uon
+{
+	// Receives the events of a SAX style reader (see read_json). Strings and
+	// keys are passed as pointer and length and are only valid for the
+	// duration of the call.
+	class Handler
+	{
+	public:
+		virtual ~Handler();
+
+		virtual void null() = 0;
+		virtual void boolean(Boolean value) = 0;
+		virtual void integer(Integer value) = 0;
+		virtual void unsigned_integer(Unsigned value) = 0;
+		virtual void real(Real value) = 0;
+		virtual void string(const char* data, std::size_t length) = 0;
+
+		virtual void begin_object() = 0;
+		virtual void key(const char* data, std::size_t length) = 0;
+		virtual void end_object() = 0;
+
+		virtual void begin_array() = 0;
+		virtual void end_array() = 0;
+	};
+
+	// Handler that builds a Value. Object members are collected and sorted
+	// once per object instead of being inserted one by one.
+	class ValueBuilder : public Handler
+	{
+	public:
+		ValueBuilder();
+
+		void null() override;
+		void boolean(Boolean value) override;
+		void integer(Integer value) override;
+		void unsigned_integer(Unsigned value) override;
+		void real(Real value) override;
+		void string(const char* data, std::size_t length) override;
+
+		void begin_object() override;
+		void key(const char* data, std::size_t length) override;
+		void end_object() override;
+
+		void begin_array() override;
+		void end_array() override;
+
+		// the completed value, moved out of the builder
+		Value result();
+
+	private:
+		struct Frame
+		{
+			bool object;
+			Key key;
+			Object::container_type members;
+			Array elements;
+		};
+
+		void add(Value&& value);
+
+		std::vector<Frame> _stack;
+		std::size_t _depth;
+
+		// the keys of this document, so each is interned once
+		std::unordered_map<std::string, Key> _keys;
+		std::string _scratch;
+		Value _result;
+	};
+}
@@ -0,0 +1,272 @@
+#include "key.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace uon
+{
+
+// a string of the table and the number of keys referring to it
+struct Key::Entry
+{
+	std::string text;
+	std::atomic<std::size_t> references;
+
+	explicit Entry(const std::string& text)
+		: text(text), references(0)
+	{ }
+
+	// function local statics, so keys can be interned during static
+	// initialization of other translation units
+	static std::mutex& mutex()
+	{
+		static std::mutex mutex;
+		return mutex;
+	}
+
+	static std::unordered_map<std::string, std::unique_ptr<Entry>>& table()
+	{
+		static std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+		return entries;
+	}
+};
+
+namespace
+{
+	const std::string& empty_string()
+	{
+		static const std::string empty;
+		return empty;
+	}
+}
+
+// References only go from zero to one and back under the lock, so an
+// entry is never found in the table while it is being removed.
+Key::Entry* Key::intern(const std::string& key)
+{
+	if(key.empty())
+	{
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lock(Entry::mutex());
+
+	auto& entry = Entry::table()[key];
+
+	if(!entry)
+	{
+		entry.reset(new Entry(key));
+	}
+
+	entry->references.fetch_add(1, std::memory_order_relaxed);
+	return entry.get();
+}
+
+void Key::release(Entry* entry)
+{
+	if(!entry)
+	{
+		return;
+	}
+
+	auto references = entry->references.load(std::memory_order_relaxed);
+
+	while(references > 1)
+	{
+		if(entry->references.compare_exchange_weak(references, references - 1, std::memory_order_acq_rel))
+		{
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(Entry::mutex());
+
+	if(entry->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		Entry::table().erase(Entry::table().find(entry->text));
+	}
+}
+
+Key::Key()
+	: _key(nullptr)
+{
+}
+
+Key::Key(const std::string& key)
+	: _key(intern(key))
+{
+}
+
+Key::Key(const char* key)
+	: _key(intern(std::string(key)))
+{
+}
+
+Key::Key(const Key& other)
+	: _key(other._key)
+{
+	if(_key)
+	{
+		_key->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+Key::Key(Key&& other) noexcept
+	: _key(other._key)
+{
+	other._key = nullptr;
+}
+
+Key::~Key()
+{
+	release(_key);
+}
+
+Key& Key::operator=(const Key& other)
+{
+	if(other._key)
+	{
+		other._key->references.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	release(_key);
+	_key = other._key;
+	return *this;
+}
+
+Key& Key::operator=(Key&& other) noexcept
+{
+	if(this != &other)
+	{
+		release(_key);
+		_key = other._key;
+		other._key = nullptr;
+	}
+
+	return *this;
+}
+
+const std::string& Key::str() const
+{
+	return _key ? _key->text : empty_string();
+}
+
+Key::operator const std::string&() const
+{
+	return str();
+}
+
+bool Key::empty() const
+{
+	return !_key;
+}
+
+std::size_t Key::size() const
+{
+	return str().size();
+}
+
+const char* Key::c_str() const
+{
+	return str().c_str();
+}
+
+std::size_t Key::hash() const
+{
+	return std::hash<const Entry*>()(_key);
+}
+
+std::size_t Key::interned()
+{
+	std::lock_guard<std::mutex> lock(Entry::mutex());
+	return Entry::table().size();
+}
+
+bool Key::operator==(const Key& other) const
+{
+	return _key == other._key;
+}
+
+bool Key::operator!=(const Key& other) const
+{
+	return _key != other._key;
+}
+
+bool Key::operator<(const Key& other) const
+{
+	return _key != other._key && str() < other.str();
+}
+
+bool operator==(const Key& a, const std::string& b)
+{
+	return a.str() == b;
+}
+
+bool operator==(const std::string& a, const Key& b)
+{
+	return a == b.str();
+}
+
+bool operator==(const Key& a, const char* b)
+{
+	return a.str() == b;
+}
+
+bool operator==(const char* a, const Key& b)
+{
+	return a == b.str();
+}
+
+bool operator!=(const Key& a, const std::string& b)
+{
+	return a.str() != b;
+}
+
+bool operator!=(const std::string& a, const Key& b)
+{
+	return a != b.str();
+}
+
+bool operator!=(const Key& a, const char* b)
+{
+	return a.str() != b;
+}
+
+bool operator!=(const char* a, const Key& b)
+{
+	return a != b.str();
+}
+
+std::string operator+(const Key& a, const std::string& b)
+{
+	return a.str() + b;
+}
+
+std::string operator+(const std::string& a, const Key& b)
+{
+	return a + b.str();
+}
+
+std::string operator+(const Key& a, const char* b)
+{
+	return a.str() + b;
+}
+
+std::string operator+(const char* a, const Key& b)
+{
+	return a + b.str();
+}
+
+std::ostream& operator<<(std::ostream& stream, const Key& key)
+{
+	return stream << key.str();
+}
+
+std::size_t hash_value(const Key& key)
+{
+	return key.hash();
+}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <ostream>
+#include <functional>
+
+namespace uon
+{
+	// A Key is an interned object key. All live keys with the same text
+	// share a single string in a process wide table, so a key is one
+	// pointer wide, copying it is an atomic increment and comparing two
+	// keys for equality is a pointer comparison. Strings are counted and
+	// leave the table with their last key, so long running processes only
+	// keep the keys of the values they hold. Interning takes a lock; lookups
+	// go by text (see Object::find and Path) and do not intern.
+	class Key
+	{
+	public:
+		Key();
+		Key(const std::string& key);
+		Key(const char* key);
+
+		Key(const Key& other);
+		Key(Key&& other) noexcept;
+		~Key();
+
+		Key& operator=(const Key& other);
+		Key& operator=(Key&& other) noexcept;
+
+		const std::string& str() const;
+		operator const std::string&() const;
+
+		bool empty() const;
+		std::size_t size() const;
+		const char* c_str() const;
+
+		std::size_t hash() const;
+
+		bool operator==(const Key& other) const;
+		bool operator!=(const Key& other) const;
+		bool operator<(const Key& other) const;
+
+		// the number of distinct keys alive
+		static std::size_t interned();
+
+	private:
+		struct Entry;
+
+		static Entry* intern(const std::string& key);
+		static void release(Entry* entry);
+
+		// nullptr for the empty key
+		Entry* _key;
+	};
+
+	bool operator==(const Key& a, const std::string& b);
+	bool operator==(const std::string& a, const Key& b);
+	bool operator==(const Key& a, const char* b);
+	bool operator==(const char* a, const Key& b);
+
+	bool operator!=(const Key& a, const std::string& b);
+	bool operator!=(const std::string& a, const Key& b);
+	bool operator!=(const Key& a, const char* b);
+	bool operator!=(const char* a, const Key& b);
+
+	std::string operator+(const Key& a, const std::string& b);
+	std::string operator+(const std::string& a, const Key& b);
+	std::string operator+(const Key& a, const char* b);
+	std::string operator+(const char* a, const Key& b);
+
+	std::ostream& operator<<(std::ostream& stream, const Key& key);
+
+	std::size_t hash_value(const Key& key);
+}
+
+namespace std
+{
+	template<>
+	struct hash<uon::Key>
+	{
+		std::size_t operator()(const uon::Key& key) const
+		{
+			return key.hash();
+		}
+	};
+}
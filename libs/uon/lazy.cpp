@@ -0,0 +1,367 @@
+#include "uon.hpp"
+
+#include <cstring>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace uon {
+
+namespace
+{
+	inline bool is_whitespace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	inline bool is_delimiter(char c)
+	{
+		return c == ',' || c == '}' || c == ']' || is_whitespace(c);
+	}
+}
+
+struct LazyDocument::Mapping
+{
+	boost::interprocess::file_mapping file;
+	boost::interprocess::mapped_region region;
+};
+
+LazyDocument::LazyDocument(boost::filesystem::path input)
+	: _data(nullptr)
+	, _length(0)
+{
+	if(!boost::filesystem::is_regular_file(input))
+	{
+		throw std::runtime_error("failed to open " + input.string());
+	}
+
+	// an empty file cannot be mapped, it is read as empty input
+	if(boost::filesystem::file_size(input) > 0)
+	{
+		_mapping.reset(new Mapping());
+		_mapping->file = boost::interprocess::file_mapping(input.string().c_str(), boost::interprocess::read_only);
+		_mapping->region = boost::interprocess::mapped_region(_mapping->file, boost::interprocess::read_only);
+
+		_data = static_cast<const char*>(_mapping->region.get_address());
+		_length = _mapping->region.get_size();
+	}
+}
+
+LazyDocument::LazyDocument(const char* data, std::size_t length)
+	: _data(data)
+	, _length(length)
+{
+}
+
+LazyDocument::~LazyDocument()
+{
+}
+
+bool LazyDocument::has(const Path& path) const
+{
+	Range range;
+	return find(path, range);
+}
+
+Type LazyDocument::type(const Path& path) const
+{
+	Range range;
+
+	if(!find(path, range))
+	{
+		throw NotFound(path.to_string());
+	}
+
+	switch(_data[range.begin])
+	{
+		case '{': return Type::object;
+		case '[': return Type::array;
+		case '"': return Type::string;
+		case 't':
+		case 'f': return Type::boolean;
+		case 'n': return Type::null;
+		default:  return Type::number;
+	}
+}
+
+Value LazyDocument::get(const Path& path) const
+{
+	Range range;
+
+	if(!find(path, range))
+	{
+		throw NotFound(path.to_string());
+	}
+
+	return parse(range);
+}
+
+Value LazyDocument::get(const Path& path, const Value& defaultValue) const
+{
+	Range range;
+	return find(path, range) ? parse(range) : defaultValue;
+}
+
+Value LazyDocument::value() const
+{
+	return read_json(_data, _length);
+}
+
+const std::vector<LazyDocument::Member>& LazyDocument::members(std::size_t begin) const
+{
+	auto cached = _index.find(begin);
+
+	if(cached != _index.end())
+	{
+		return cached->second;
+	}
+
+	std::vector<Member> members;
+
+	bool object = (_data[begin] == '{');
+	char close = object ? '}' : ']';
+
+	auto position = skip_whitespace(begin + 1);
+
+	if(position < _length && _data[position] == close)
+	{
+		return _index[begin];
+	}
+
+	for(;;)
+	{
+		Member member = { { position, position }, { 0, 0 } };
+
+		if(object)
+		{
+			if(position == _length || _data[position] != '"')
+			{
+				throw ParseError("expected string as object key", position);
+			}
+
+			auto end = skip_string(position);
+			member.key = { position + 1, end - 1 };
+
+			position = skip_whitespace(end);
+
+			if(position == _length || _data[position] != ':')
+			{
+				throw ParseError("expected ':'", position);
+			}
+
+			position = skip_whitespace(position + 1);
+		}
+
+		member.value.begin = position;
+		member.value.end = skip_value(position);
+		members.push_back(member);
+
+		position = skip_whitespace(member.value.end);
+
+		if(position == _length)
+		{
+			throw ParseError("unexpected end of input", position);
+		}
+
+		if(_data[position] == close)
+		{
+			break;
+		}
+
+		if(_data[position] != ',')
+		{
+			throw ParseError(object ? "expected ',' or '}'" : "expected ',' or ']'", position);
+		}
+
+		position = skip_whitespace(position + 1);
+	}
+
+	auto& result = _index[begin];
+	result.swap(members);
+	return result;
+}
+
+bool LazyDocument::find(const Path& path, Range& range) const
+{
+	range.begin = skip_whitespace(0);
+	range.end = _length;
+
+	while(range.end > range.begin && is_whitespace(_data[range.end-1]))
+	{
+		--range.end;
+	}
+
+	if(range.begin == range.end)
+	{
+		throw ParseError("unexpected end of input", range.begin);
+	}
+
+	for(std::size_t i = 0; i < path.size(); ++i)
+	{
+		auto c = _data[range.begin];
+
+		if(c == '{')
+		{
+			auto& object = members(range.begin);
+			auto& key = path[i];
+			auto j = object.rbegin();
+
+			// from the back, the last of duplicate keys wins as in read_json
+			while(j != object.rend() && !key_equals(j->key, key))
+			{
+				++j;
+			}
+
+			if(j == object.rend())
+			{
+				return false;
+			}
+
+			range = j->value;
+		}
+		else
+		if(c == '[')
+		{
+			auto& array = members(range.begin);
+			auto j = path.index(i);
+
+			if(j == Path::no_index || j >= array.size())
+			{
+				return false;
+			}
+
+			range = array[j].value;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool LazyDocument::key_equals(const Range& key, const std::string& text) const
+{
+	auto length = key.end - key.begin;
+	auto raw = _data + key.begin;
+
+	if(std::memchr(raw, '\\', length) == nullptr)
+	{
+		return length == text.size() && std::memcmp(raw, text.data(), length) == 0;
+	}
+
+	// escaped keys are rare, they are decoded for the comparison
+	return parse({ key.begin - 1, key.end + 1 }).as_string() == text;
+}
+
+std::size_t LazyDocument::skip_whitespace(std::size_t position) const
+{
+	while(position < _length && is_whitespace(_data[position]))
+	{
+		++position;
+	}
+
+	return position;
+}
+
+std::size_t LazyDocument::skip_value(std::size_t position) const
+{
+	if(position == _length)
+	{
+		throw ParseError("unexpected end of input", position);
+	}
+
+	switch(_data[position])
+	{
+		case '{':
+		case '[':
+			return skip_container(position);
+
+		case '"':
+			return skip_string(position);
+
+		case ',': case '}': case ']': case ':':
+			throw ParseError("unexpected character", position);
+	}
+
+	// numbers and literals are checked once they are parsed
+	while(position < _length && !is_delimiter(_data[position]))
+	{
+		++position;
+	}
+
+	return position;
+}
+
+std::size_t LazyDocument::skip_string(std::size_t position) const
+{
+	auto start = position;
+
+	for(++position;;)
+	{
+		auto quote = static_cast<const char*>(std::memchr(_data + position, '"', _length - position));
+
+		if(quote == nullptr)
+		{
+			throw ParseError("unterminated string", start);
+		}
+
+		auto end = static_cast<std::size_t>(quote - _data);
+		position = end + 1;
+
+		// the quote is escaped if an odd number of backslashes precedes it
+		std::size_t backslashes = 0;
+
+		while(end - backslashes - 1 > start && _data[end - backslashes - 1] == '\\')
+		{
+			++backslashes;
+		}
+
+		if(backslashes % 2 == 0)
+		{
+			return position;
+		}
+	}
+}
+
+std::size_t LazyDocument::skip_container(std::size_t position) const
+{
+	// only nesting is tracked, whether brackets match is checked once the
+	// container is parsed
+	auto start = position;
+	std::size_t depth = 0;
+
+	while(position < _length)
+	{
+		switch(_data[position])
+		{
+			case '"':
+				position = skip_string(position);
+				continue;
+
+			case '{':
+			case '[':
+				++depth;
+				break;
+
+			case '}':
+			case ']':
+				if(--depth == 0)
+				{
+					return position + 1;
+				}
+				break;
+		}
+
+		++position;
+	}
+
+	throw ParseError("unterminated container", start);
+}
+
+Value LazyDocument::parse(const Range& range) const
+{
+	return read_json(_data + range.begin, range.end - range.begin);
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <boost/filesystem.hpp>
+
+namespace uon
+{
+	// Read-only access to a json document without building it as a whole.
+	// A file is memory mapped; the members of a container are indexed when
+	// a lookup first passes through it, and only the value looked up is
+	// parsed into a Value. Not safe for concurrent use.
+	class LazyDocument
+	{
+	public:
+		explicit LazyDocument(boost::filesystem::path input);
+
+		// the data is not copied and has to outlive the document
+		LazyDocument(const char* data, std::size_t length);
+
+		LazyDocument(const LazyDocument&) = delete;
+		LazyDocument& operator=(const LazyDocument&) = delete;
+
+		~LazyDocument();
+
+		bool has(const Path& path) const;
+		Type type(const Path& path) const;
+
+		Value get(const Path& path) const;
+		Value get(const Path& path, const Value& defaultValue) const;
+
+		// the whole document
+		Value value() const;
+
+	private:
+		struct Mapping;
+
+		struct Range
+		{
+			std::size_t begin;
+			std::size_t end;
+		};
+
+		struct Member
+		{
+			Range key;	// without quotes, empty for array elements
+			Range value;
+		};
+
+		const std::vector<Member>& members(std::size_t begin) const;
+		bool find(const Path& path, Range& range) const;
+		bool key_equals(const Range& key, const std::string& text) const;
+
+		std::size_t skip_whitespace(std::size_t position) const;
+		std::size_t skip_value(std::size_t position) const;
+		std::size_t skip_string(std::size_t position) const;
+		std::size_t skip_container(std::size_t position) const;
+
+		Value parse(const Range& range) const;
+
+		std::unique_ptr<Mapping> _mapping;
+		const char* _data;
+		std::size_t _length;
+
+		// members of the containers indexed so far, by their offset
+		mutable std::unordered_map<std::size_t, std::vector<Member>> _index;
+	};
+}
@@ -1,8 +1,12 @@
 #include "uon.hpp"
 
-#include <sstream>
-#include <iomanip>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <iterator>
 #include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 namespace uon
 {
@@ -34,128 +38,523 @@ bool Null::operator!=(const Null& other) const
 
 const Null null = Null();
 
-Type Value::type() const
+namespace
 {
-	if(_value.type() == typeid(Null))
-		return Type::null;
+	bool key_less(const Object::value_type& entry, const String& key)
+	{
+		return entry.first.str() < key;
+	}
 
-	if(_value.type() == typeid(String))
-		return Type::string;
+	bool entry_less(const Object::value_type& a, const Object::value_type& b)
+	{
+		return a.first < b.first;
+	}
 
-	if(_value.type() == typeid(Number))
-		return Type::number;
+	// drops all but the first or last of sorted entries with equal keys
+	void drop_duplicates(Object::container_type& values, bool keep_last)
+	{
+		auto out = values.begin();
 
-	if(_value.type() == typeid(Boolean))
-		return Type::boolean;
+		for(auto in = values.begin(); in != values.end(); ++in)
+		{
+			if(keep_last ? (in + 1 != values.end() && (in + 1)->first == in->first) : (out != values.begin() && (out - 1)->first == in->first))
+				continue;
 
-	if(_value.type() == typeid(Object))
-		return Type::object;
+			if(out != in)
+			{
+				*out = std::move(*in);
+			}
 
-	if(_value.type() == typeid(Array))
-		return Type::array;
+			++out;
+		}
 
-	throw std::runtime_error("invalid type");
+		values.erase(out, values.end());
+	}
+
+	// bounds of the integer kinds as exactly representable floating point values
+	const long double integer_end = 9223372036854775808.0L;
+	const long double unsigned_end = 18446744073709551616.0L;
+
+	bool is_integral(long double value)
+	{
+		return std::trunc(value) == value;
+	}
+
+	// integer kinds are compared exactly, everything else as Number
+	bool number_less(const Value& a, const Value& b)
+	{
+		auto a_kind = a.number_kind();
+		auto b_kind = b.number_kind();
+
+		if(a_kind == NumberKind::real || b_kind == NumberKind::real)
+		{
+			return a.as_number() < b.as_number();
+		}
+
+		if(a_kind == NumberKind::integer && b_kind == NumberKind::integer)
+		{
+			return a.as_integer() < b.as_integer();
+		}
+
+		if(a_kind == NumberKind::unsigned_integer && b_kind == NumberKind::unsigned_integer)
+		{
+			return a.as_unsigned() < b.as_unsigned();
+		}
+
+		if(a_kind == NumberKind::integer)
+		{
+			return a.as_integer() < 0 || static_cast<Unsigned>(a.as_integer()) < b.as_unsigned();
+		}
+
+		return b.as_integer() >= 0 && a.as_unsigned() < static_cast<Unsigned>(b.as_integer());
+	}
+
+	bool number_equal(const Value& a, const Value& b)
+	{
+		auto a_kind = a.number_kind();
+		auto b_kind = b.number_kind();
+
+		if(a_kind == NumberKind::real || b_kind == NumberKind::real)
+		{
+			return a.as_number() == b.as_number();
+		}
+
+		if(a_kind == b_kind)
+		{
+			return a_kind == NumberKind::integer
+				? a.as_integer() == b.as_integer()
+				: a.as_unsigned() == b.as_unsigned();
+		}
+
+		auto i = (a_kind == NumberKind::integer) ? a.as_integer() : b.as_integer();
+		auto u = (a_kind == NumberKind::integer) ? b.as_unsigned() : a.as_unsigned();
+
+		return i >= 0 && static_cast<Unsigned>(i) == u;
+	}
+
+	// equal numbers of different kinds have to hash the same
+	std::size_t number_hash(const Value& value)
+	{
+		auto number = value.as_number();
+
+		if(is_integral(number) && number >= -integer_end && number < integer_end)
+		{
+			return boost::hash_value(value.as_integer());
+		}
+
+		if(is_integral(number) && number >= 0 && number < unsigned_end)
+		{
+			return boost::hash_value(value.as_unsigned());
+		}
+
+		return boost::hash_value(value.as_real());
+	}
+}
+
+Object::Object()
+{
+}
+
+Object::Object(std::initializer_list<value_type> values)
+	: Object(container_type(values))
+{
+}
+
+Object::Object(container_type values)
+	: _values(std::move(values))
+{
+	// sort once and drop duplicates, the last occurrence of a key wins
+	std::stable_sort(_values.begin(), _values.end(), entry_less);
+	drop_duplicates(_values, true);
+}
+
+Object::iterator Object::begin()
+{
+	return _values.begin();
+}
+
+Object::iterator Object::end()
+{
+	return _values.end();
+}
+
+Object::const_iterator Object::begin() const
+{
+	return _values.begin();
+}
+
+Object::const_iterator Object::end() const
+{
+	return _values.end();
+}
+
+bool Object::empty() const
+{
+	return _values.empty();
+}
+
+Object::size_type Object::size() const
+{
+	return _values.size();
+}
+
+void Object::reserve(size_type capacity)
+{
+	_values.reserve(capacity);
+}
+
+void Object::clear()
+{
+	_values.clear();
+}
+
+Object::iterator Object::find(const String& key)
+{
+	auto i = std::lower_bound(_values.begin(), _values.end(), key, key_less);
+	return (i != _values.end() && i->first == key) ? i : _values.end();
+}
+
+Object::const_iterator Object::find(const String& key) const
+{
+	auto i = std::lower_bound(_values.begin(), _values.end(), key, key_less);
+	return (i != _values.end() && i->first == key) ? i : _values.end();
+}
+
+Object::size_type Object::count(const String& key) const
+{
+	return find(key) != end() ? 1 : 0;
+}
+
+Value& Object::operator[](const Key& key)
+{
+	if(_values.empty() || _values.back().first < key)
+	{
+		_values.push_back(value_type(key, Value()));
+		return _values.back().second;
+	}
+
+	auto i = std::lower_bound(_values.begin(), _values.end(), key.str(), key_less);
+
+	if(i == _values.end() || i->first != key)
+	{
+		i = _values.insert(i, value_type(key, Value()));
+	}
+
+	return i->second;
+}
+
+std::pair<Object::iterator, bool> Object::insert(const value_type& value)
+{
+	// appending in key order is the common case when building objects
+	if(_values.empty() || _values.back().first < value.first)
+	{
+		_values.push_back(value);
+		return std::make_pair(_values.end() - 1, true);
+	}
+
+	auto i = std::lower_bound(_values.begin(), _values.end(), value.first.str(), key_less);
+
+	if(i != _values.end() && i->first == value.first)
+	{
+		return std::make_pair(i, false);
+	}
+
+	return std::make_pair(_values.insert(i, value), true);
+}
+
+std::pair<Object::iterator, bool> Object::insert(value_type&& value)
+{
+	if(_values.empty() || _values.back().first < value.first)
+	{
+		_values.push_back(std::move(value));
+		return std::make_pair(_values.end() - 1, true);
+	}
+
+	auto i = std::lower_bound(_values.begin(), _values.end(), value.first.str(), key_less);
+
+	if(i != _values.end() && i->first == value.first)
+	{
+		return std::make_pair(i, false);
+	}
+
+	return std::make_pair(_values.insert(i, std::move(value)), true);
+}
+
+void Object::insert_all(container_type values)
+{
+	if(values.empty())
+		return;
+
+	// the merge is stable, so existing members come first among equal keys
+	std::stable_sort(values.begin(), values.end(), entry_less);
+
+	auto existing = _values.size();
+	_values.insert(_values.end(), std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+	std::inplace_merge(_values.begin(), _values.begin() + existing, _values.end(), entry_less);
+
+	drop_duplicates(_values, false);
+}
+
+Object::iterator Object::erase(const_iterator position)
+{
+	return _values.erase(_values.begin() + (position - _values.cbegin()));
+}
+
+Object::size_type Object::erase(const String& key)
+{
+	auto i = find(key);
+
+	if(i == _values.end())
+		return 0;
+
+	_values.erase(i);
+	return 1;
+}
+
+bool Object::operator<(const Object& other) const
+{
+	return _values < other._values;
+}
+
+bool Object::operator==(const Object& other) const
+{
+	return _values == other._values;
+}
+
+bool Object::operator!=(const Object& other) const
+{
+	return _values != other._values;
+}
+
+Type Value::type() const
+{
+	return _type;
 }
 
 bool Value::is_null() const
 {
-	return _value.type() == typeid(Null);
+	return _type == Type::null;
 }
 
 bool Value::is_string() const
 {
-	return _value.type() == typeid(String);
+	return _type == Type::string;
 }
 
 bool Value::is_number() const
 {
-	return _value.type() == typeid(Number);
+	return _type == Type::number;
 }
 
 bool Value::is_boolean() const
 {
-	return _value.type() == typeid(Boolean);
+	return _type == Type::boolean;
 }
 
 bool Value::is_object() const
 {
-	return _value.type() == typeid(Object);
+	return _type == Type::object;
 }
 
 bool Value::is_array() const
 {
-	return _value.type() == typeid(Array);
+	return _type == Type::array;
 }
 
-String Value::as_string() const
+const String& Value::as_string() const &
 {
-	return boost::get<String>(_value);
+	if(_type != Type::string)
+	{
+		throw std::runtime_error("value is not a string");
+	}
+
+	return _string;
+}
+
+String Value::as_string() &&
+{
+	if(_type != Type::string)
+	{
+		throw std::runtime_error("value is not a string");
+	}
+
+	return std::move(_string);
 }
 
 Number Value::as_number() const
 {
-	return boost::get<Number>(_value);
+	if(_type != Type::number)
+	{
+		throw std::runtime_error("value is not a number");
+	}
+
+	switch(_kind)
+	{
+		case NumberKind::integer:          return _integer;
+		case NumberKind::unsigned_integer: return _unsigned;
+		case NumberKind::real:             return _real;
+	}
+
+	throw std::runtime_error("invalid number kind");
+}
+
+NumberKind Value::number_kind() const
+{
+	if(_type != Type::number)
+	{
+		throw std::runtime_error("value is not a number");
+	}
+
+	return _kind;
+}
+
+Integer Value::as_integer() const
+{
+	switch(number_kind())
+	{
+		case NumberKind::integer:
+			return _integer;
+
+		case NumberKind::unsigned_integer:
+			if(_unsigned <= static_cast<Unsigned>(std::numeric_limits<Integer>::max()))
+			{
+				return static_cast<Integer>(_unsigned);
+			}
+			break;
+
+		case NumberKind::real:
+			if(is_integral(_real) && _real >= -integer_end && _real < integer_end)
+			{
+				return static_cast<Integer>(_real);
+			}
+			break;
+	}
+
+	throw std::range_error("number is not representable as integer");
+}
+
+Unsigned Value::as_unsigned() const
+{
+	switch(number_kind())
+	{
+		case NumberKind::integer:
+			if(_integer >= 0)
+			{
+				return static_cast<Unsigned>(_integer);
+			}
+			break;
+
+		case NumberKind::unsigned_integer:
+			return _unsigned;
+
+		case NumberKind::real:
+			if(is_integral(_real) && _real >= 0 && _real < unsigned_end)
+			{
+				return static_cast<Unsigned>(_real);
+			}
+			break;
+	}
+
+	throw std::range_error("number is not representable as unsigned integer");
+}
+
+Real Value::as_real() const
+{
+	switch(number_kind())
+	{
+		case NumberKind::integer:          return static_cast<Real>(_integer);
+		case NumberKind::unsigned_integer: return static_cast<Real>(_unsigned);
+		case NumberKind::real:             return _real;
+	}
+
+	throw std::runtime_error("invalid number kind");
 }
 
 Boolean Value::as_boolean() const
 {
-	return boost::get<Boolean>(_value);
+	if(_type != Type::boolean)
+	{
+		throw std::runtime_error("value is not a boolean");
+	}
+
+	return _boolean;
+}
+
+const Object& Value::as_object() const &
+{
+	if(_type != Type::object)
+	{
+		throw std::runtime_error("value is not an object");
+	}
+
+	return _object->data;
+}
+
+Object Value::as_object() &&
+{
+	if(_type != Type::object)
+	{
+		throw std::runtime_error("value is not an object");
+	}
+
+	return std::move(mutable_object());
 }
 
-Object Value::as_object() const
+const Array& Value::as_array() const &
 {
-	return boost::get<Object>(_value);
+	if(_type != Type::array)
+	{
+		throw std::runtime_error("value is not an array");
+	}
+
+	return _array->data;
 }
 
-Array Value::as_array() const
+Array Value::as_array() &&
 {
-	return boost::get<Array>(_value);
+	if(_type != Type::array)
+	{
+		throw std::runtime_error("value is not an array");
+	}
+
+	return std::move(mutable_array());
 }
 
 String Value::to_string() const
 {
-	if(_value.type() == typeid(Null))
+	if(_type == Type::null)
 	{
 		return "";
 	}
 
-	if(_value.type() == typeid(String))
+	if(_type == Type::string)
 	{
-		return boost::get<String>(_value);
+		return _string;
 	}
 
-	if(_value.type() == typeid(Number))
+	if(_type == Type::number)
 	{
-		auto number = boost::get<Number>(_value);
+		char buffer[max_number_chars];
 
-		std::ostringstream string;
-		string.setf ( std::ios::floatfield, std::ios::fixed );
-
-		long double tmp;
-		if(std::modf(number, &tmp) == 0.0)
-		{
-			string << std::setprecision(0);
-		}
-		else
+		switch(_kind)
 		{
-			string << std::setprecision(6);
+			case NumberKind::integer:          return std::string(buffer, to_chars(buffer, _integer));
+			case NumberKind::unsigned_integer: return std::string(buffer, to_chars(buffer, _unsigned));
+			case NumberKind::real:             return std::string(buffer, to_chars(buffer, _real));
 		}
-
-		string << number;
-		return string.str();
 	}
 
-	if(_value.type() == typeid(Boolean))
+	if(_type == Type::boolean)
 	{
-		return boost::get<Boolean>(_value) ? "true" : "false";
+		return _boolean ? "true" : "false";
 	}
 
-	if(_value.type() == typeid(Object))
+	if(_type == Type::object)
 	{
 		return write_json(*this, true);
 	}
 
-	if(_value.type() == typeid(Array))
+	if(_type == Type::array)
 	{
 		return write_json(*this, true);
 	}
@@ -165,37 +564,70 @@ String Value::to_string() const
 
 Number Value::to_number() const
 {
-	if(_value.type() == typeid(Null))
+	if(_type == Type::null)
 	{
 		return 0.0;
 	}
 
-	if(_value.type() == typeid(String))
+	if(_type == Type::string)
 	{
-		auto str = boost::get<String>(_value);
+		auto first = _string.data();
+		auto last = first + _string.size();
+
+		while(first != last && std::isspace(static_cast<unsigned char>(*first)))
+		{
+			++first;
+		}
 
-		if(str.length() == 0)
+		if(first == last)
 			return 0.0;
 
-		return std::stold(str);
+		if(*first == '+')
+		{
+			++first;
+		}
+
+		// integers stay exact
+		Integer integer;
+		Unsigned unsigned_integer;
+		Real real;
+
+		auto end = from_chars(first, last, real);
+
+		if(end == first)
+		{
+			throw std::invalid_argument("not a number: " + _string);
+		}
+
+		if(from_chars(first, last, integer) == end)
+		{
+			return integer;
+		}
+
+		if(from_chars(first, last, unsigned_integer) == end)
+		{
+			return unsigned_integer;
+		}
+
+		return real;
 	}
 
-	if(_value.type() == typeid(Number))
+	if(_type == Type::number)
 	{
-		return boost::get<Number>(_value);
+		return as_number();
 	}
 
-	if(_value.type() == typeid(Boolean))
+	if(_type == Type::boolean)
 	{
-		return boost::get<Boolean>(_value) ? 1.0 : 0.0;
+		return _boolean ? 1.0 : 0.0;
 	}
 
-	if(_value.type() == typeid(Object))
+	if(_type == Type::object)
 	{
 		return std::numeric_limits<double>::quiet_NaN();
 	}
 
-	if(_value.type() == typeid(Array))
+	if(_type == Type::array)
 	{
 		return std::numeric_limits<double>::quiet_NaN();
 	}
@@ -205,34 +637,34 @@ Number Value::to_number() const
 
 Boolean Value::to_boolean() const
 {
-	if(_value.type() == typeid(Null))
+	if(_type == Type::null)
 	{
 		return false;
 	}
 
-	if(_value.type() == typeid(String))
+	if(_type == Type::string)
 	{
-		auto str = boost::get<String>(_value);
+		auto str = _string;
 		boost::algorithm::to_lower(str);
 		return (str == "true" || str == "yes" || str == "on" || str == "enabled" || str == "1") ? true : false;
 	}
 
-	if(_value.type() == typeid(Number))
+	if(_type == Type::number)
 	{
-		return boost::get<Number>(_value) > 0 ? true : false;
+		return as_number() > 0 ? true : false;
 	}
 
-	if(_value.type() == typeid(Boolean))
+	if(_type == Type::boolean)
 	{
-		return boost::get<Boolean>(_value);
+		return _boolean;
 	}
 
-	if(_value.type() == typeid(Object))
+	if(_type == Type::object)
 	{
 		return true;
 	}
 
-	if(_value.type() == typeid(Array))
+	if(_type == Type::array)
 	{
 		return true;
 	}
@@ -240,77 +672,76 @@ Boolean Value::to_boolean() const
 	throw std::runtime_error("invalid type");
 }
 
-Object Value::to_object() const
+Object Value::to_object() const &
 {
-	if(_value.type() == typeid(Null))
+	if(_type == Type::null)
 	{
 		return Object();
 	}
 
-	if(_value.type() == typeid(String))
+	if(_type == Type::string)
 	{
 		return Object{std::pair<String, Value>{"", *this}};
 	}
 
-	if(_value.type() == typeid(Number))
+	if(_type == Type::number)
 	{
 		return Object{std::pair<String, Value>{"", *this}};
 	}
 
-	if(_value.type() == typeid(Boolean))
+	if(_type == Type::boolean)
 	{
 		return Object{std::pair<String, Value>{"", *this}};
 	}
 
-	if(_value.type() == typeid(Object))
+	if(_type == Type::object)
 	{
-		return boost::get<Object>(_value);
+		return _object->data;
 	}
 
-	if(_value.type() == typeid(Array))
+	if(_type == Type::array)
 	{
-		Object obj;
-		std::size_t i = 0;
+		Object::container_type entries;
+		entries.reserve(_array->data.size());
 
-		for(auto& e : boost::get<Array>(_value))
+		for(auto& e : _array->data)
 		{
-			obj[std::to_string(i)] = e;
-			i += 1;
+			entries.push_back(Object::value_type(std::to_string(entries.size()), e));
 		}
 
-		return obj;
+		return Object(std::move(entries));
 	}
 
 	throw std::runtime_error("invalid type");
 }
 
-Array Value::to_array() const
+Array Value::to_array() const &
 {
-	if(_value.type() == typeid(Null))
+	if(_type == Type::null)
 	{
 		return Array();
 	}
 
-	if(_value.type() == typeid(String))
+	if(_type == Type::string)
 	{
 		return Array{*this};
 	}
 
-	if(_value.type() == typeid(Number))
+	if(_type == Type::number)
 	{
 		return Array{*this};
 	}
 
-	if(_value.type() == typeid(Boolean))
+	if(_type == Type::boolean)
 	{
 		return Array{*this};
 	}
 
-	if(_value.type() == typeid(Object))
+	if(_type == Type::object)
 	{
 		Array arr;
 
-		for(auto& e : boost::get<Object>(_value))
+		for(auto& e : _object->data)
 		{
 			arr.push_back(e.second);
 		}
@@ -318,19 +749,39 @@ Array Value::to_array() const
 		return arr;
 	}
 
-	if(_value.type() == typeid(Array))
+	if(_type == Type::array)
 	{
-		return boost::get<Array>(_value);
+		return _array->data;
 	}
 
 	throw std::runtime_error("invalid type");
 }
 
+Object Value::to_object() &&
+{
+	if(_type == Type::object)
+	{
+		return std::move(mutable_object());
+	}
+
+	return static_cast<const Value&>(*this).to_object();
+}
+
+Array Value::to_array() &&
+{
+	if(_type == Type::array)
+	{
+		return std::move(mutable_array());
+	}
+
+	return static_cast<const Value&>(*this).to_array();
+}
+
 std::vector<std::string> Value::to_string_array() const
 {
 	std::vector<std::string> result;
 
-	for(auto i : to_array())
+	for(auto& i : array_view())
 	{
 		result.push_back(i.to_string());
 	}
@@ -338,134 +789,646 @@ std::vector<std::string> Value::to_string_array() const
 	return result;
 }
 
+ObjectView Value::object_view() const &
+{
+	return ObjectView(this);
+}
+
+ArrayView Value::array_view() const &
+{
+	return ArrayView(this);
+}
+
 Value& Value::operator=(const Value& other)
 {
-	_value = other._value;
+	Value tmp(other);
+	take(tmp);
+	return *this;
+}
+
+Value& Value::operator=(Value&& other) noexcept
+{
+	// other may live inside this value, so detach it before resetting
+	Value tmp(std::move(other));
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(const Null& value)
 {
-	_value = value;
+	reset();
 	return *this;
 }
 
 Value& Value::operator=(const String& value)
 {
-	_value = value;
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(const Number& value)
 {
-	_value = value;
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(const Boolean& value)
 {
-	_value = value;
+	reset();
+	_type = Type::boolean;
+	_boolean = value;
 	return *this;
 }
 
 Value& Value::operator=(const Object& value)
 {
-	_value = value;
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(const Array& value)
 {
-	_value = value;
+	Value tmp(value);
+	take(tmp);
+	return *this;
+}
+
+Value& Value::operator=(String&& value)
+{
+	Value tmp(std::move(value));
+	take(tmp);
+	return *this;
+}
+
+Value& Value::operator=(Object&& value)
+{
+	Value tmp(std::move(value));
+	take(tmp);
+	return *this;
+}
+
+Value& Value::operator=(Array&& value)
+{
+	Value tmp(std::move(value));
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(const char* value)
 {
-	_value = std::string(value);
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(std::uint64_t value)
 {
-	_value = (Number)value;
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value& Value::operator=(std::int64_t value)
 {
-	_value = (Number)value;
+	Value tmp(value);
+	take(tmp);
+	return *this;
+}
+
+Value& Value::operator=(double value)
+{
+	Value tmp(value);
+	take(tmp);
 	return *this;
 }
 
 Value::Value()
-	: _value(null)
+	: _type(Type::null)
 {
 }
 
 Value::Value(const Value& other)
-	: _value(other._value)
+	: _type(Type::null)
+{
+	switch(other._type)
+	{
+		case Type::null:
+			break;
+
+		case Type::string:
+			new (&_string) String(other._string);
+			break;
+
+		case Type::number:
+			_kind = other._kind;
+			switch(_kind)
+			{
+				case NumberKind::integer:          _integer = other._integer; break;
+				case NumberKind::unsigned_integer: _unsigned = other._unsigned; break;
+				case NumberKind::real:             _real = other._real; break;
+			}
+			break;
+
+		case Type::boolean:
+			_boolean = other._boolean;
+			break;
+
+		case Type::object:
+			_object = other._object;
+			_object->references += 1;
+			break;
+
+		case Type::array:
+			_array = other._array;
+			_array->references += 1;
+			break;
+	}
+
+	_type = other._type;
+}
+
+Value::Value(Value&& other) noexcept
+	: _type(Type::null)
 {
+	take(other);
 }
 
 Value::Value(const Null& value)
-	: _value(value)
+	: _type(Type::null)
 {
 }
 
 Value::Value(const String& value)
-	: _value(value)
+	: _type(Type::string)
 {
+	new (&_string) String(value);
 }
 
 Value::Value(const Number& value)
-	: _value(value)
+	: _type(Type::number)
 {
+	// keep integral values exact, everything else becomes a double
+	if(is_integral(value) && value >= -integer_end && value < integer_end)
+	{
+		_kind = NumberKind::integer;
+		_integer = static_cast<Integer>(value);
+	}
+	else
+	if(is_integral(value) && value >= 0 && value < unsigned_end)
+	{
+		_kind = NumberKind::unsigned_integer;
+		_unsigned = static_cast<Unsigned>(value);
+	}
+	else
+	{
+		_kind = NumberKind::real;
+		_real = static_cast<Real>(value);
+	}
 }
 
 Value::Value(const Boolean& value)
-	: _value(value)
+	: _type(Type::boolean)
 {
+	_boolean = value;
 }
 
 Value::Value(const Object& value)
-	: _value(value)
+	: _type(Type::object)
 {
+	_object = new Node<Object>(value);
 }
 
 Value::Value(const Array& value)
-	: _value(value)
+	: _type(Type::array)
+{
+	_array = new Node<Array>(value);
+}
+
+Value::Value(String&& value)
+	: _type(Type::string)
 {
+	new (&_string) String(std::move(value));
+}
+
+Value::Value(Object&& value)
+	: _type(Type::object)
+{
+	_object = new Node<Object>(std::move(value));
+}
+
+Value::Value(Array&& value)
+	: _type(Type::array)
+{
+	_array = new Node<Array>(std::move(value));
 }
 
 Value::Value(const char* value)
-	: _value(std::string(value))
+	: _type(Type::string)
 {
+	new (&_string) String(value);
 }
 
 Value::Value(std::uint64_t value)
-	: _value((Number)value)
+	: _type(Type::number)
+	, _kind(NumberKind::unsigned_integer)
 {
+	_unsigned = value;
 }
 
 Value::Value(std::int64_t value)
-	: _value((Number)value)
+	: _type(Type::number)
+	, _kind(NumberKind::integer)
+{
+	_integer = value;
+}
+
+Value::Value(double value)
+	: _type(Type::number)
+	, _kind(NumberKind::real)
+{
+	_real = value;
+}
+
+Value::~Value()
+{
+	reset();
+}
+
+void Value::take(Value& other)
+{
+	reset();
+
+	switch(other._type)
+	{
+		case Type::null:
+			break;
+
+		case Type::string:
+			new (&_string) String(std::move(other._string));
+			other._string.~String();
+			break;
+
+		case Type::number:
+			_kind = other._kind;
+			switch(_kind)
+			{
+				case NumberKind::integer:          _integer = other._integer; break;
+				case NumberKind::unsigned_integer: _unsigned = other._unsigned; break;
+				case NumberKind::real:             _real = other._real; break;
+			}
+			break;
+
+		case Type::boolean:
+			_boolean = other._boolean;
+			break;
+
+		case Type::object:
+			_object = other._object;
+			break;
+
+		case Type::array:
+			_array = other._array;
+			break;
+	}
+
+	_type = other._type;
+	other._type = Type::null;
+}
+
+void Value::reset()
 {
+	switch(_type)
+	{
+		case Type::string:
+			_string.~String();
+			break;
+
+		case Type::object:
+			if(--_object->references == 0)
+			{
+				delete _object;
+			}
+			break;
+
+		case Type::array:
+			if(--_array->references == 0)
+			{
+				delete _array;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	_type = Type::null;
 }
 
 bool Value::operator<(const Value& other) const
 {
-	return _value < other._value;
+	if(_type != other._type)
+	{
+		return _type < other._type;
+	}
+
+	switch(_type)
+	{
+		case Type::null:    return false;
+		case Type::string:  return _string < other._string;
+		case Type::number:  return number_less(*this, other);
+		case Type::boolean: return _boolean < other._boolean;
+		case Type::object:  return _object->data < other._object->data;
+		case Type::array:   return _array->data < other._array->data;
+	}
+
+	throw std::runtime_error("invalid type");
 }
 
 bool Value::operator==(const Value& other) const
 {
-	return _value == other._value;
+	if(_type != other._type)
+	{
+		return false;
+	}
+
+	switch(_type)
+	{
+		case Type::null:    return true;
+		case Type::string:  return _string == other._string;
+		case Type::number:  return number_equal(*this, other);
+		case Type::boolean: return _boolean == other._boolean;
+		case Type::object:  return _object == other._object || _object->data == other._object->data;
+		case Type::array:   return _array == other._array || _array->data == other._array->data;
+	}
+
+	throw std::runtime_error("invalid type");
+}
+
+std::size_t Value::hash() const
+{
+	std::size_t seed = static_cast<std::size_t>(_type);
+
+	switch(_type)
+	{
+		case Type::null:
+			break;
+
+		case Type::string:
+			boost::hash_combine(seed, _string);
+			break;
+
+		case Type::number:
+			boost::hash_combine(seed, number_hash(*this));
+			break;
+
+		case Type::boolean:
+			boost::hash_combine(seed, _boolean);
+			break;
+
+		case Type::object:
+		{
+			auto cached = _object->hash.load(std::memory_order_relaxed);
+
+			if(cached != 0)
+			{
+				return cached;
+			}
+
+			for(auto& i : _object->data)
+			{
+				boost::hash_combine(seed, i.first);
+				boost::hash_combine(seed, i.second.hash());
+			}
+
+			seed = (seed != 0) ? seed : 1;
+			_object->hash.store(seed, std::memory_order_relaxed);
+			break;
+		}
+
+		case Type::array:
+		{
+			auto cached = _array->hash.load(std::memory_order_relaxed);
+
+			if(cached != 0)
+			{
+				return cached;
+			}
+
+			for(auto& i : _array->data)
+			{
+				boost::hash_combine(seed, i.hash());
+			}
+
+			seed = (seed != 0) ? seed : 1;
+			_array->hash.store(seed, std::memory_order_relaxed);
+			break;
+		}
+	}
+
+	return seed;
+}
+
+Object& Value::mutable_object()
+{
+	if(_object->references > 1)
+	{
+		auto node = new Node<Object>(_object->data);
+
+		if(--_object->references == 0)
+		{
+			delete _object;
+		}
+
+		_object = node;
+	}
+
+	_object->hash.store(0, std::memory_order_relaxed);
+	return _object->data;
+}
+
+Array& Value::mutable_array()
+{
+	if(_array->references > 1)
+	{
+		auto node = new Node<Array>(_array->data);
+
+		if(--_array->references == 0)
+		{
+			delete _array;
+		}
+
+		_array = node;
+	}
+
+	_array->hash.store(0, std::memory_order_relaxed);
+	return _array->data;
+}
+
+Value Value::copy() const
+{
+	if(_type == Type::object)
+	{
+		Object::container_type entries;
+		entries.reserve(_object->data.size());
+
+		for(auto& e : _object->data)
+		{
+			entries.push_back(Object::value_type(e.first, e.second.copy()));
+		}
+
+		return Object(std::move(entries));
+	}
+
+	if(_type == Type::array)
+	{
+		Array array;
+		array.reserve(_array->data.size());
+
+		for(auto& e : _array->data)
+		{
+			array.push_back(e.copy());
+		}
+
+		return array;
+	}
+
+	return *this;
 }
 
 bool Value::operator!=(const Value& other) const
 {
-	return !(_value == other._value);
+	return !(*this == other);
+}
+
+ObjectView::ObjectView(const Value* value)
+{
+	static const Object empty;
+
+	if(!value || value->is_null())
+	{
+		_object = &empty;
+	}
+	else
+	if(value->is_object())
+	{
+		_object = &value->as_object();
+	}
+	else
+	{
+		_converted = std::make_shared<const Object>(value->to_object());
+		_object = _converted.get();
+	}
+}
+
+ObjectView::const_iterator ObjectView::begin() const
+{
+	return _object->begin();
+}
+
+ObjectView::const_iterator ObjectView::end() const
+{
+	return _object->end();
+}
+
+bool ObjectView::empty() const
+{
+	return _object->empty();
+}
+
+std::size_t ObjectView::size() const
+{
+	return _object->size();
+}
+
+ArrayView::ArrayView(const Value* value)
+{
+	static const Array empty;
+
+	if(!value || value->is_null())
+	{
+		_array = &empty;
+	}
+	else
+	if(value->is_array())
+	{
+		_array = &value->as_array();
+	}
+	else
+	{
+		_converted = std::make_shared<const Array>(value->to_array());
+		_array = _converted.get();
+	}
+}
+
+ArrayView::const_iterator ArrayView::begin() const
+{
+	return _array->begin();
+}
+
+ArrayView::const_iterator ArrayView::end() const
+{
+	return _array->end();
+}
+
+bool ArrayView::empty() const
+{
+	return _array->empty();
+}
+
+std::size_t ArrayView::size() const
+{
+	return _array->size();
+}
+
+const Value& ArrayView::operator[](std::size_t index) const
+{
+	return (*_array)[index];
+}
+
+bool VisitPath::empty() const
+{
+	return _segments.empty();
+}
+
+std::size_t VisitPath::size() const
+{
+	return _segments.size();
+}
+
+const VisitPath::Segment& VisitPath::operator[](std::size_t position) const
+{
+	return _segments[position];
+}
+
+VisitPath::const_iterator VisitPath::begin() const
+{
+	return _segments.begin();
+}
+
+VisitPath::const_iterator VisitPath::end() const
+{
+	return _segments.end();
+}
+
+std::string VisitPath::to_string() const
+{
+	return to_path().to_string();
+}
+
+Path VisitPath::to_path() const
+{
+	std::vector<std::string> segments;
+	segments.reserve(_segments.size());
+
+	for(auto& i : _segments)
+	{
+		segments.push_back(i.key ? *i.key : std::to_string(i.index));
+	}
+
+	return Path(segments);
 }
 
 }
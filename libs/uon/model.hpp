@@ -1,11 +1,19 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <map>
 #include <vector>
+#include <utility>
+#include <memory>
+#include <atomic>
 #include <functional>
-#include <boost/variant.hpp>
+#include <initializer_list>
+
+#include "key.hpp"
+#include "path.hpp"
 
 namespace uon
 {
@@ -31,11 +39,127 @@ namespace uon
 	using Number = long double;
 	using Boolean = bool;
 
+	// numbers are stored exactly as one of these kinds, Number is the common
+	// type all of them convert to
+	using Integer = std::int64_t;
+	using Unsigned = std::uint64_t;
+	using Real = double;
+
+	enum class NumberKind { integer, unsigned_integer, real };
+
 	class Value;
 
-	using Object = std::map<String, Value>;
+	// Object keeps its members in a flat vector sorted by key. Compared to a
+	// node based map this costs one allocation per object instead of one per
+	// member and keeps lookups and iteration cache friendly. Iteration order
+	// is the same as with std::map (ascending by key). Keys are interned, so
+	// each member only stores a pointer to its key's text. Inserting out of
+	// key order and erasing move the members behind, so objects built from
+	// many members are built in bulk, by the constructor or insert_all().
+	class Object
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using value_type = std::pair<Key, Value>;
+		using container_type = std::vector<value_type>;
+		using size_type = container_type::size_type;
+		using iterator = container_type::iterator;
+		using const_iterator = container_type::const_iterator;
+
+		Object();
+		Object(std::initializer_list<value_type> values);
+		explicit Object(container_type values);
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		bool empty() const;
+		size_type size() const;
+		void reserve(size_type capacity);
+		void clear();
+
+		iterator find(const String& key);
+		const_iterator find(const String& key) const;
+		size_type count(const String& key) const;
+
+		Value& operator[](const Key& key);
+
+		std::pair<iterator, bool> insert(const value_type& value);
+		std::pair<iterator, bool> insert(value_type&& value);
+		// sorts values once and merges them in; as with insert(), existing
+		// members are kept over new ones with the same key
+		void insert_all(container_type values);
+		iterator erase(const_iterator position);
+		size_type erase(const String& key);
+
+		bool operator<(const Object& other) const;
+		bool operator==(const Object& other) const;
+		bool operator!=(const Object& other) const;
+
+	private:
+		container_type _values;
+	};
+
 	using Array = std::vector<Value>;
 
+	class ObjectView;
+	class ArrayView;
+
+	// bit mask of value types, e.g. types(Type::string) | types(Type::number)
+	using Types = unsigned int;
+
+	inline Types types(Type type)
+	{
+		return 1u << static_cast<unsigned int>(type);
+	}
+
+	const Types all_types = ~0u;
+
+	// returned by Value::visit() visitors: continue, do not descend into the
+	// current value, or end the traversal
+	enum class Visit { next, skip, stop };
+
+	// path to the value currently visited by Value::visit(); keys point into
+	// the visited value and array elements are kept as index, so no strings
+	// are built unless asked for
+	class VisitPath
+	{
+	public:
+		struct Segment
+		{
+			const String* key; // nullptr for array elements
+			std::size_t index;
+		};
+
+		using const_iterator = std::vector<Segment>::const_iterator;
+
+		bool empty() const;
+		std::size_t size() const;
+
+		const Segment& operator[](std::size_t position) const;
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		std::string to_string() const;
+		Path to_path() const;
+
+	private:
+		friend class Value;
+		friend class Query;
+
+		std::vector<Segment> _segments;
+	};
+
+	// Value has value semantics, but objects and arrays are reference
+	// counted and shared between copies: copying a value is O(1) and a
+	// shared node is copied on the first modification only (copy on write),
+	// which also copies just the nodes on the path down to the modified
+	// value. References obtained through getref() or find() on a non-const
+	// value point into unshared nodes; they must not be used for
+	// modifications after the value has been copied or hashed again.
 	class Value
 	{
 	public:
@@ -48,20 +172,37 @@ namespace uon
 		bool is_object() const;
 		bool is_array() const;
 
-		String as_string() const;
+		// borrowing accessors, called on a temporary they return a copy
+		const String& as_string() const &;
+		String as_string() &&;
 		Number as_number() const;
+		NumberKind number_kind() const;
+		Integer as_integer() const;
+		Unsigned as_unsigned() const;
+		Real as_real() const;
 		Boolean as_boolean() const;
-		Object as_object() const;
-		Array as_array() const;
+		const Object& as_object() const &;
+		Object as_object() &&;
+		const Array& as_array() const &;
+		Array as_array() &&;
 
 		String to_string() const;
 		Number to_number() const;
 		Boolean to_boolean() const;
-		Object to_object() const;
-		Array to_array() const;
+		Object to_object() const &;
+		Object to_object() &&;
+		Array to_array() const &;
+		Array to_array() &&;
 		std::vector<std::string> to_string_array() const;
 
+		// like to_object()/to_array() but without copying objects and arrays
+		ObjectView object_view() const &;
+		ObjectView object_view() && = delete;
+		ArrayView array_view() const &;
+		ArrayView array_view() && = delete;
+
 		Value& operator=(const Value& other);
+		Value& operator=(Value&& other) noexcept;
 
 		Value& operator=(const Null& value);
 		Value& operator=(const String& value);
@@ -70,12 +211,19 @@ namespace uon
 		Value& operator=(const Object& value);
 		Value& operator=(const Array& value);
 
+		Value& operator=(String&& value);
+		Value& operator=(Object&& value);
+		Value& operator=(Array&& value);
+
 		Value& operator=(const char* value);
 		Value& operator=(std::uint64_t value);
 		Value& operator=(std::int64_t value);
+		Value& operator=(double value);
 
 		Value();
 		Value(const Value& other);
+		Value(Value&& other) noexcept;
+		~Value();
 
 		Value(const Null& value);
 		Value(const String& value);
@@ -84,53 +232,251 @@ namespace uon
 		Value(const Object& value);
 		Value(const Array& value);
 
+		Value(String&& value);
+		Value(Object&& value);
+		Value(Array&& value);
+
 		Value(const char* value);
 		Value(std::uint64_t value);
 		Value(std::int64_t value);
+		Value(double value);
 
+		// deep copy that shares no nodes with this value
 		Value copy() const;
 
 		bool operator<(const Value& other) const;
 		bool operator==(const Value& other) const;
 		bool operator!=(const Value& other) const;
 
-	public:
-		Value get(std::string path) const;
-		Value get(std::vector<std::string> path) const;
+		// structural hash, consistent with operator==; cached per object
+		// and array node
+		std::size_t hash() const;
 
-		Value get(std::string path, const Value& defaultValue) const;
-		Value get(std::vector<std::string> path, const Value& defaultValue) const;
+	public:
+		Value get(const Path& path) const;
+		Value get(const Path& path, const Value& defaultValue) const;
 
-		Value& getref(std::string path);
-		Value& getref(std::vector<std::string> path);
+		Value& getref(const Path& path);
+		const Value& getref(const Path& path) const;
 
-		const Value& getref(std::string path) const;
-		const Value& getref(std::vector<std::string> path) const;
+		// non-throwing lookup, returns nullptr if path does not exist
+		Value* find(const Path& path);
+		const Value* find(const Path& path) const;
 
-		void set(std::string path, const Value& subject);
-		void set(std::vector<std::string> path, const Value& subject);
+		void set(const Path& path, const Value& subject);
+		void set(const Path& path, Value&& subject);
 
 		void merge(const Value& overlay);
-		void merge(std::string path, const Value& overlay);
-		void merge(std::vector<std::string> path, const Value& overlay);
+		void merge(Value&& overlay);
+		void merge(const Path& path, const Value& overlay);
+		void merge(const Path& path, Value&& overlay);
+
+		// appends to an array, any other value is replaced by an empty array first
+		void push_back(const Value& item);
+		void push_back(Value&& item);
 
-		void traverse(std::function<void(Value&,std::vector<std::string>)> functor, std::vector<std::string> basepath = std::vector<std::string>{});
+		// calls visitor(value, path) for this value and all values below it
+		// (depth first, objects by key) whose type is in the types mask. The
+		// visitor returns a Visit and may modify the value it is called with,
+		// the traversal continues below the modified value. Returns false if
+		// the traversal was stopped.
+		template<typename Visitor>
+		bool visit(Visitor&& visitor, Types types = all_types);
+
+		template<typename Visitor>
+		bool visit(Visitor&& visitor, Types types = all_types) const;
 
 		void escape_mongo();
 		void unescape_mongo();
 
 	private:
-		boost::make_recursive_variant<
-			Null,
-			String,
-			Number,
-			Boolean,
-			boost::recursive_wrapper<Object>,
-			boost::recursive_wrapper<Array>
-		>::type _value;
+		template<typename T>
+		struct Node;
+
+		void take(Value& other);
+		void reset();
+
+		Object& mutable_object();
+		Array& mutable_array();
+
+		static Object& visit_object(Value& value);
+		static const Object& visit_object(const Value& value);
+		static Array& visit_array(Value& value);
+		static const Array& visit_array(const Value& value);
+
+		template<typename V, typename Visitor>
+		static Visit visit_node(V& value, Visitor& visitor, Types types, VisitPath& path);
+
+		// tagged node: scalars and strings are stored inline (short strings
+		// do not allocate thanks to std::string's small buffer), objects and
+		// arrays are shared through a single pointer each
+		Type _type;
+		NumberKind _kind;
+
+		union
+		{
+			Boolean _boolean;
+			Integer _integer;
+			Unsigned _unsigned;
+			Real _real;
+			String _string;
+			Node<Object>* _object;
+			Node<Array>* _array;
+		};
+	};
+
+	template<typename T>
+	struct Value::Node
+	{
+		explicit Node(T data)
+			: references(1)
+			, hash(0)
+			, data(std::move(data))
+		{ }
+
+		std::atomic<std::size_t> references;
+		std::atomic<std::size_t> hash; // 0 if not computed yet
+		T data;
+	};
+
+	inline Object& Value::visit_object(Value& value)
+	{
+		return value.mutable_object();
+	}
+
+	inline const Object& Value::visit_object(const Value& value)
+	{
+		return value._object->data;
+	}
+
+	inline Array& Value::visit_array(Value& value)
+	{
+		return value.mutable_array();
+	}
+
+	inline const Array& Value::visit_array(const Value& value)
+	{
+		return value._array->data;
+	}
+
+	template<typename V, typename Visitor>
+	Visit Value::visit_node(V& value, Visitor& visitor, Types types, VisitPath& path)
+	{
+		if(types & uon::types(value._type))
+		{
+			auto control = visitor(value, static_cast<const VisitPath&>(path));
+
+			if(control != Visit::next)
+			{
+				return control;
+			}
+		}
+
+		if(value._type == Type::object)
+		{
+			for(auto& i : visit_object(value))
+			{
+				path._segments.push_back(VisitPath::Segment{ &i.first.str(), 0 });
+				auto control = visit_node(i.second, visitor, types, path);
+				path._segments.pop_back();
+
+				if(control == Visit::stop)
+				{
+					return control;
+				}
+			}
+		}
+		else
+		if(value._type == Type::array)
+		{
+			std::size_t index = 0;
+
+			for(auto& i : visit_array(value))
+			{
+				path._segments.push_back(VisitPath::Segment{ nullptr, index++ });
+				auto control = visit_node(i, visitor, types, path);
+				path._segments.pop_back();
+
+				if(control == Visit::stop)
+				{
+					return control;
+				}
+			}
+		}
+
+		return Visit::next;
+	}
+
+	template<typename Visitor>
+	bool Value::visit(Visitor&& visitor, Types types)
+	{
+		VisitPath path;
+		return visit_node(*this, visitor, types, path) != Visit::stop;
+	}
+
+	template<typename Visitor>
+	bool Value::visit(Visitor&& visitor, Types types) const
+	{
+		VisitPath path;
+		return visit_node(*this, visitor, types, path) != Visit::stop;
+	}
+
+	// ObjectView and ArrayView iterate the members of a value with the
+	// semantics of to_object() and to_array(). Objects, arrays and null are
+	// borrowed, so the viewed value has to outlive the view. Any other value
+	// is converted once and kept alive by the view. A view constructed from
+	// nullptr is empty, which makes them convenient with Value::find().
+	class ObjectView
+	{
+	public:
+		using const_iterator = Object::const_iterator;
+
+		ObjectView(const Value* value);
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		bool empty() const;
+		std::size_t size() const;
+
+	private:
+		const Object* _object;
+		std::shared_ptr<const Object> _converted;
+	};
+
+	class ArrayView
+	{
+	public:
+		using const_iterator = Array::const_iterator;
+
+		ArrayView(const Value* value);
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		bool empty() const;
+		std::size_t size() const;
+
+		const Value& operator[](std::size_t index) const;
+
+	private:
+		const Array* _array;
+		std::shared_ptr<const Array> _converted;
 	};
 
 	extern void unique(Array& array);
 
 	extern std::string escape_mongo_key(std::string key);
 }
+
+namespace std
+{
+	template<>
+	struct hash<uon::Value>
+	{
+		std::size_t operator()(const uon::Value& value) const
+		{
+			return value.hash();
+		}
+	};
+}
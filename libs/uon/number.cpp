@@ -0,0 +1,421 @@
+#include "uon.hpp"
+
+#include <cfloat>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#if defined(__APPLE__)
+#include <xlocale.h>
+#elif !defined(_WIN32)
+#include <locale.h>
+#endif
+
+namespace uon {
+
+namespace
+{
+	const Real powers_of_ten[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// largest power of ten and integer a double holds exactly
+	const int max_exact_power = 22;
+	const Unsigned max_exact_integer = Unsigned(1) << 53;
+
+	bool is_digit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	// digits of value, without sign
+	const char* read_digits(const char* first, const char* last, Unsigned& value)
+	{
+		const Unsigned max = std::numeric_limits<Unsigned>::max();
+
+		Unsigned result = 0;
+		auto i = first;
+
+		for(; i != last && is_digit(*i); ++i)
+		{
+			Unsigned digit = *i - '0';
+
+			if(result > (max - digit) / 10)
+			{
+				return first;
+			}
+
+			result = result * 10 + digit;
+		}
+
+		if(i != first)
+		{
+			value = result;
+		}
+
+		return i;
+	}
+
+	Real strtod_c(const char* text)
+	{
+#if defined(_WIN32)
+		static const _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+		return _strtod_l(text, nullptr, c_locale);
+#else
+		static const locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+		return strtod_l(text, nullptr, c_locale);
+#endif
+	}
+
+	char* write_digits(char* first, Unsigned value)
+	{
+		char buffer[20];
+		char* begin = buffer + sizeof(buffer);
+
+		do
+		{
+			*--begin = static_cast<char>('0' + value % 10);
+			value /= 10;
+		}
+		while(value != 0);
+
+		auto length = buffer + sizeof(buffer) - begin;
+		std::memcpy(first, begin, length);
+		return first + length;
+	}
+
+	char* write_literal(char* first, const char* literal)
+	{
+		auto length = std::strlen(literal);
+		std::memcpy(first, literal, length);
+		return first + length;
+	}
+
+	// exact for reals that are an integer of up to 15 digits divided by a
+	// power of ten up to 1e8 and not written in exponent notation by %g;
+	// the output equals that of %.15g then
+	char* write_decimal(char* first, Real value)
+	{
+		auto magnitude = std::fabs(value);
+
+		if(magnitude < 1e-4 || magnitude >= 1e15)
+		{
+			return nullptr;
+		}
+
+		for(int decimals = 0; decimals <= 8; ++decimals)
+		{
+			auto scaled = magnitude * powers_of_ten[decimals];
+
+			if(scaled >= 1e15)
+			{
+				break;
+			}
+
+			if(scaled != std::floor(scaled) || scaled / powers_of_ten[decimals] != magnitude)
+			{
+				continue;
+			}
+
+			char digits[20];
+			auto length = write_digits(digits, static_cast<Unsigned>(scaled)) - digits;
+			auto integral = length - decimals;
+
+			// %g drops trailing zeros of the fraction
+			auto end = length;
+
+			while(end > integral && end > 0 && digits[end-1] == '0')
+			{
+				--end;
+			}
+
+			if(value < 0)
+			{
+				*first++ = '-';
+			}
+
+			if(integral <= 0)
+			{
+				*first++ = '0';
+			}
+			else
+			{
+				std::memcpy(first, digits, integral);
+				first += integral;
+			}
+
+			if(end > integral)
+			{
+				*first++ = '.';
+
+				for(auto i = integral; i < 0; ++i)
+				{
+					*first++ = '0';
+				}
+
+				auto start = (integral > 0) ? integral : 0;
+				std::memcpy(first, digits + start, end - start);
+				first += end - start;
+			}
+
+			return first;
+		}
+
+		return nullptr;
+	}
+}
+
+const char* from_chars(const char* first, const char* last, Unsigned& value)
+{
+	return read_digits(first, last, value);
+}
+
+const char* from_chars(const char* first, const char* last, Integer& value)
+{
+	bool negative = (first != last && *first == '-');
+
+	auto digits = negative ? first + 1 : first;
+
+	Unsigned magnitude;
+	auto end = read_digits(digits, last, magnitude);
+
+	if(end == digits)
+	{
+		return first;
+	}
+
+	const Unsigned limit = static_cast<Unsigned>(std::numeric_limits<Integer>::max());
+
+	if(negative && magnitude <= limit + 1)
+	{
+		value = (magnitude == limit + 1) ? std::numeric_limits<Integer>::min() : -static_cast<Integer>(magnitude);
+		return end;
+	}
+
+	if(!negative && magnitude <= limit)
+	{
+		value = static_cast<Integer>(magnitude);
+		return end;
+	}
+
+	return first;
+}
+
+const char* from_chars(const char* first, const char* last, Real& value)
+{
+	auto i = first;
+	bool negative = (i != last && *i == '-');
+
+	if(negative)
+	{
+		++i;
+	}
+
+	// up to 19 significant digits are kept, the rest only counts
+	Unsigned mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool exact = true;
+	bool any = false;
+
+	for(; i != last && is_digit(*i); ++i)
+	{
+		any = true;
+
+		if(digits < 19)
+		{
+			mantissa = mantissa * 10 + (*i - '0');
+			digits += (mantissa != 0);
+		}
+		else
+		{
+			++exponent;
+			exact = exact && *i == '0';
+		}
+	}
+
+	if(i != last && *i == '.')
+	{
+		++i;
+
+		for(; i != last && is_digit(*i); ++i)
+		{
+			any = true;
+
+			if(digits < 19)
+			{
+				mantissa = mantissa * 10 + (*i - '0');
+				digits += (mantissa != 0);
+				--exponent;
+			}
+			else
+			{
+				exact = exact && *i == '0';
+			}
+		}
+	}
+
+	if(!any)
+	{
+		return first;
+	}
+
+	if(i != last && (*i == 'e' || *i == 'E'))
+	{
+		auto j = i + 1;
+		bool negative_exponent = (j != last && *j == '-');
+
+		if(j != last && (*j == '-' || *j == '+'))
+		{
+			++j;
+		}
+
+		if(j != last && is_digit(*j))
+		{
+			int written = 0;
+
+			for(; j != last && is_digit(*j); ++j)
+			{
+				// far beyond the range of doubles either way
+				if(written < 100000)
+				{
+					written = written * 10 + (*j - '0');
+				}
+			}
+
+			exponent += negative_exponent ? -written : written;
+			i = j;
+		}
+	}
+
+	// both operands are exact, so is the rounding of one operation
+#if FLT_EVAL_METHOD == 0
+	if(exact && mantissa <= max_exact_integer)
+	{
+		Real result = static_cast<Real>(mantissa);
+
+		if(mantissa == 0)
+		{
+			value = negative ? -0.0 : 0.0;
+			return i;
+		}
+
+		if(exponent >= -max_exact_power && exponent <= max_exact_power)
+		{
+			result = (exponent < 0) ? result / powers_of_ten[-exponent] : result * powers_of_ten[exponent];
+			value = negative ? -result : result;
+			return i;
+		}
+
+		// 1.5e30: scale the mantissa exactly first
+		if(exponent > max_exact_power && exponent <= max_exact_power + 15)
+		{
+			result *= powers_of_ten[exponent - max_exact_power];
+
+			if(result <= static_cast<Real>(max_exact_integer))
+			{
+				result *= powers_of_ten[max_exact_power];
+				value = negative ? -result : result;
+				return i;
+			}
+		}
+	}
+#endif
+
+	// the exact decimal is needed to round correctly
+	char buffer[64];
+	std::size_t length = i - first;
+
+	if(length < sizeof(buffer))
+	{
+		std::memcpy(buffer, first, length);
+		buffer[length] = '\0';
+		value = strtod_c(buffer);
+	}
+	else
+	{
+		value = strtod_c(std::string(first, i).c_str());
+	}
+
+	return i;
+}
+
+char* to_chars(char* first, Unsigned value)
+{
+	return write_digits(first, value);
+}
+
+char* to_chars(char* first, Integer value)
+{
+	if(value < 0)
+	{
+		*first++ = '-';
+		return write_digits(first, 0 - static_cast<Unsigned>(value));
+	}
+
+	return write_digits(first, static_cast<Unsigned>(value));
+}
+
+char* to_chars(char* first, Real value)
+{
+	if(!std::isfinite(value))
+	{
+		return write_literal(first, std::isnan(value) ? "nan" : (value < 0 ? "-inf" : "inf"));
+	}
+
+	if(value == 0)
+	{
+		return write_literal(first, std::signbit(value) ? "-0" : "0");
+	}
+
+	if(auto end = write_decimal(first, value))
+	{
+		return end;
+	}
+
+	// the decimal point of the current locale is replaced afterwards
+	auto point = std::localeconv()->decimal_point;
+	auto point_length = std::strlen(point);
+
+	char buffer[max_number_chars];
+
+	for(int precision = 15; precision <= 17; ++precision)
+	{
+		std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+
+		auto end = first;
+
+		for(auto i = buffer; *i; ++i)
+		{
+			if(point_length > 0 && std::strncmp(i, point, point_length) == 0)
+			{
+				*end++ = '.';
+				i += point_length - 1;
+				continue;
+			}
+
+			*end++ = *i;
+		}
+
+		Real parsed;
+
+		if(precision == 17 || (from_chars(first, end, parsed) == end && parsed == value))
+		{
+			return end;
+		}
+	}
+
+	return first;
+}
+
+std::string format_real(Real value)
+{
+	char buffer[max_number_chars];
+	return std::string(buffer, to_chars(buffer, value));
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace uon
+{
+	// Conversions between numbers and text in the json number format,
+	// independent of the C and C++ locale and without allocations.
+	//
+	// from_chars reads a number from the start of [first, last) and returns
+	// the end of it, or first if there is none or it does not fit value.
+	// to_chars writes value to first, which needs max_number_chars bytes,
+	// and returns the end of the output. Reals are written as the shortest
+	// %.15g to %.17g representation that reads back to the same double.
+	const std::size_t max_number_chars = 32;
+
+	extern const char* from_chars(const char* first, const char* last, Integer& value);
+	extern const char* from_chars(const char* first, const char* last, Unsigned& value);
+	extern const char* from_chars(const char* first, const char* last, Real& value);
+
+	extern char* to_chars(char* first, Integer value);
+	extern char* to_chars(char* first, Unsigned value);
+	extern char* to_chars(char* first, Real value);
+
+	extern std::string format_real(Real value);
+}
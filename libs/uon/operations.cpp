@@ -1,336 +1,448 @@
 #include "uon.hpp"
 
-#include <set>
+#include <unordered_set>
+#include <iterator>
 #include <boost/algorithm/string.hpp>
 
 namespace uon {
 
-Value Value::get(std::string path) const
-{
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	return get(parts);
-}
-
-Value Value::get(std::vector<std::string> path) const
+Value Value::get(const Path& path) const
 {
 	return getref(path);
 }
 
-Value Value::get(std::string path, const Value& defaultValue) const
+Value Value::get(const Path& path, const Value& defaultValue) const
 {
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	return get(parts, defaultValue);
+	auto node = find(path);
+	return node ? *node : defaultValue;
 }
 
-Value Value::get(std::vector<std::string> path, const Value& defaultValue) const
+Value& Value::getref(const Path& path)
 {
-	try
-	{
-		return getref(path);
-	}
-	catch(const NotFound&)
+	auto node = find(path);
+
+	if(!node)
 	{
-		return defaultValue;
+		throw NotFound(path.to_string());
 	}
-}
 
-Value& Value::getref(std::string path)
-{
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	return getref(parts);
+	return *node;
 }
 
-Value& Value::getref(std::vector<std::string> path)
+const Value& Value::getref(const Path& path) const
 {
-	return const_cast<Value&>(static_cast<const Value*>(this)->getref(path));
-}
+	auto node = find(path);
 
-const Value& Value::getref(std::string path) const
-{
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	return getref(parts);
+	if(!node)
+	{
+		throw NotFound(path.to_string());
+	}
+
+	return *node;
 }
 
-const Value& Value::getref(std::vector<std::string> path) const
+Value* Value::find(const Path& path)
 {
-	if(path.size() == 0)
+	// look up first, so that a miss does not unshare anything
+	if(!static_cast<const Value*>(this)->find(path))
 	{
-		return *this;
+		return nullptr;
 	}
 
-	if(_value.type() == typeid(Object))
-	{
-		auto& object = boost::get<Object>(_value);
-		auto i = object.find(path[0]);
+	Value* node = this;
 
-		if(i != object.end())
-		{
-			try
-			{
-				return i->second.getref(std::vector<std::string>(path.begin()+1, path.end()));
-			}
-			catch(const NotFound&)
-			{
-				throw NotFound(boost::algorithm::join(path, "."));
-			}
-		}
-	}
-	else
-	if(_value.type() == typeid(Array))
+	for(std::size_t i = 0; i < path.size(); ++i)
 	{
-		auto& array = boost::get<Array>(_value);
-		std::size_t i = 0;
-
-		try
-		{
-			i = std::stoul(path[0]);
-		}
-		catch(const std::invalid_argument&)
+		if(node->_type == Type::object)
 		{
-			throw NotFound(boost::algorithm::join(path, "."));
+			node = &node->mutable_object().find(path[i])->second;
 		}
-		catch(const std::out_of_range&)
+		else
 		{
-			throw NotFound(boost::algorithm::join(path, "."));
+			node = &node->mutable_array()[path.index(i)];
 		}
+	}
+
+	return node;
+}
+
+const Value* Value::find(const Path& path) const
+{
+	const Value* node = this;
 
-		if(i < array.size())
+	for(std::size_t i = 0; i < path.size(); ++i)
+	{
+		if(node->_type == Type::object)
 		{
-			try
+			auto& object = node->_object->data;
+			auto j = object.find(path[i]);
+
+			if(j == object.end())
 			{
-				return array[i].getref(std::vector<std::string>(path.begin()+1, path.end()));
+				return nullptr;
 			}
-			catch(const NotFound&)
+
+			node = &j->second;
+		}
+		else
+		if(node->_type == Type::array)
+		{
+			auto& array = node->_array->data;
+			auto j = path.index(i);
+
+			if(j == Path::no_index || j >= array.size())
 			{
-				throw NotFound(boost::algorithm::join(path, "."));
+				return nullptr;
 			}
+
+			node = &array[j];
+		}
+		else
+		{
+			return nullptr;
 		}
 	}
 
-	throw NotFound(boost::algorithm::join(path, "."));
+	return node;
 }
 
-void Value::set(std::vector<std::string> path, const Value& value)
+namespace
 {
-	if(path.size() == 0)
+	// the member at key, added if missing; only new members intern their key
+	Value& member(Object& object, const std::string& key)
 	{
-		_value = value._value;
+		auto i = object.find(key);
+		return (i != object.end()) ? i->second : object[Key(key)];
 	}
-	else
+}
+
+void Value::set(const Path& path, const Value& value)
+{
+	set(path, Value(value));
+}
+
+void Value::set(const Path& path, Value&& value)
+{
+	// value may live inside this value, so detach it before walking the path
+	Value subject(std::move(value));
+	Value* node = this;
+
+	for(auto& segment : path)
 	{
-		if(_value.type() != typeid(Object))
+		if(node->_type != Type::object)
 		{
-			_value = Object();
+			*node = Object();
 		}
 
-		auto& object = boost::get<Object>(_value);
-		object[path.front()].set(std::vector<std::string>(path.begin()+1, path.end()), value);
+		node = &member(node->mutable_object(), segment);
 	}
-}
 
-void Value::set(std::string path, const Value& value)
-{
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	set(parts, value);
+	*node = std::move(subject);
 }
 
 void Value::merge(const Value& overlay)
 {
-	if(_value.type() == typeid(Object) && overlay._value.type() == typeid(Object))
+	if(_type == Type::object && overlay._type == Type::object)
 	{
-		auto& this_object = boost::get<Object>(_value);
-		auto& overlay_object = boost::get<Object>(overlay._value);
+		// as for arrays below, the overlay may be this value or share its node
+		Value source(overlay);
+
+		auto& this_object = mutable_object();
+		Object::container_type added;
 
-		for(auto i : overlay_object)
+		// new members are inserted at once, one by one would be quadratic
+		for(auto& i : source._object->data)
 		{
-			this_object[i.first].merge(i.second);
+			auto member = this_object.find(i.first.str());
+
+			if(member != this_object.end())
+			{
+				member->second.merge(i.second);
+			}
+			else
+			{
+				added.push_back(i);
+			}
 		}
+
+		this_object.insert_all(std::move(added));
 	}
 	else
-	if(_value.type() == typeid(Array) && overlay._value.type() == typeid(Array))
+	if(_type == Type::array && overlay._type == Type::array)
 	{
-		auto& this_array = boost::get<Array>(_value);
-		auto& overlay_array = boost::get<Array>(overlay._value);
+		// hold on to the overlay's node, mutable_array() unshares if both
+		// refer to the same array
+		Value source(overlay);
+
+		auto& this_array = mutable_array();
+		auto& overlay_array = source._array->data;
 
 		this_array.insert(this_array.end(), overlay_array.begin(), overlay_array.end());
 	}
 	else
 	{
-		_value = overlay._value;
+		*this = overlay;
 	}
 }
 
-void Value::merge(std::string path, const Value& overlay)
+void Value::merge(Value&& overlay)
 {
-	std::vector<std::string> parts;
-	boost::split(parts, path, boost::is_any_of("."));
-	merge(parts, overlay);
-}
+	Value source(std::move(overlay));
 
-void Value::merge(std::vector<std::string> path, const Value& overlay)
-{
-	if(path.size() == 0)
+	if(source._type == Type::object && source._object->references == 1 && _type == Type::object)
 	{
-		merge(overlay);
+		auto& this_object = mutable_object();
+		Object::container_type added;
+
+		for(auto& i : source._object->data)
+		{
+			auto member = this_object.find(i.first.str());
+
+			if(member != this_object.end())
+			{
+				member->second.merge(std::move(i.second));
+			}
+			else
+			{
+				added.push_back(std::move(i));
+			}
+		}
+
+		this_object.insert_all(std::move(added));
 	}
 	else
+	if(source._type == Type::array && source._array->references == 1 && _type == Type::array)
 	{
-		if(_value.type() != typeid(Object))
-		{
-			_value = Object();
-		}
+		auto& this_array = mutable_array();
+		auto& source_array = source._array->data;
 
-		auto& object = boost::get<Object>(_value);
-		object[path.front()].merge(std::vector<std::string>(path.begin()+1, path.end()), overlay);
+		this_array.insert(this_array.end(), std::make_move_iterator(source_array.begin()), std::make_move_iterator(source_array.end()));
+	}
+	else
+	if(_type == source._type && (_type == Type::object || _type == Type::array))
+	{
+		// shared overlay, its nodes must not be stolen
+		merge(static_cast<const Value&>(source));
+	}
+	else
+	{
+		take(source);
 	}
 }
 
-void Value::traverse(std::function<void(uon::Value&,std::vector<std::string>)> functor, std::vector<std::string> basepath)
+void Value::merge(const Path& path, const Value& overlay)
 {
-	functor(*this, basepath);
+	merge(path, Value(overlay));
+}
 
-	if(_value.type() == typeid(Object))
+void Value::merge(const Path& path, Value&& overlay)
+{
+	Value source(std::move(overlay));
+	Value* node = this;
+
+	for(auto& segment : path)
 	{
-		for(auto& i : boost::get<Object>(_value))
+		if(node->_type != Type::object)
 		{
-			std::vector<std::string> path = basepath;
-			path.push_back(i.first);
-
-			i.second.traverse(functor, path);
+			*node = Object();
 		}
+
+		node = &member(node->mutable_object(), segment);
 	}
-	else
-	if(_value.type() == typeid(Array))
-	{
-		std::size_t j = 0;
 
-		for(auto& i : boost::get<Array>(_value))
-		{
-			std::vector<std::string> path = basepath;
-			path.push_back(std::to_string(j++));
+	node->merge(std::move(source));
+}
 
-			i.traverse(functor, path);
-		}
-	}
+void Value::push_back(const Value& item)
+{
+	push_back(Value(item));
 }
 
-std::string escape_mongo_key(std::string key)
+void Value::push_back(Value&& item)
 {
-	boost::replace_all(key, "$", "＄");	// replace $ by U+FF04 (unicode full width equivalent)
-	boost::replace_all(key, ".", "．");	// replace . by U+FF0E (unicode full width equivalent)
+	Value subject(std::move(item));
 
-	return key;
+	if(_type != Type::array)
+	{
+		*this = Array();
+	}
+
+	mutable_array().push_back(std::move(subject));
 }
 
-void Value::escape_mongo()
+namespace
 {
-	if(_value.type() == typeid(Object))
+	// renames the keys of an object, renamed members replace existing
+	// members with the same key; the renamed members go behind the kept
+	// ones and the whole is sorted once, where the last of equal keys wins
+	template<typename Rename>
+	void rename_keys(Object& object, Rename rename)
 	{
-		auto& object = boost::get<Object>(_value);
-		Object tmp;
+		Object::container_type kept;
+		Object::container_type renamed;
+		kept.reserve(object.size());
 
-		for(auto j = object.begin(); j != object.end();)
+		for(auto& i : object)
 		{
-			std::string ek = j->first;
-			boost::replace_all(ek, "$", "＄");	// replace $ by U+FF04 (unicode full width equivalent)
-			boost::replace_all(ek, ".", "．");	// replace . by U+FF0E (unicode full width equivalent)
+			std::string key = rename(i.first);
 
-			if(ek != j->first)
+			if(key != i.first)
 			{
-				tmp[ek] = j->second;
-				j = object.erase(j);
+				renamed.push_back(Object::value_type(std::move(key), std::move(i.second)));
 			}
 			else
 			{
-				++j;
+				kept.push_back(std::move(i));
 			}
 		}
 
-		for(auto& j : tmp)
-		{
-			object[j.first] = j.second;
-		}
+		kept.insert(kept.end(), std::make_move_iterator(renamed.begin()), std::make_move_iterator(renamed.end()));
+		object = Object(std::move(kept));
+	}
 
-		for(auto& j : object)
+	template<typename Match>
+	bool has_key(const Object& object, Match match)
+	{
+		for(auto& i : object)
 		{
-			j.second.escape_mongo();
+			if(match(i.first.str()))
+			{
+				return true;
+			}
 		}
+
+		return false;
 	}
-	else
-	if(_value.type() == typeid(Array))
+
+	// whether an object at or below value has a matching key, checked on
+	// the shared nodes without unsharing them
+	template<typename Match>
+	bool has_key(const Value& value, Match match)
 	{
-		for(auto& j : boost::get<Array>(_value))
+		return !value.visit([&match](const Value& node, const VisitPath&) -> Visit
 		{
-			j.escape_mongo();
-		}
+			return has_key(node.as_object(), match) ? Visit::stop : Visit::next;
+		},
+		types(Type::object));
+	}
+
+	bool is_escapable(const std::string& key)
+	{
+		return key.find_first_of("$.") != std::string::npos;
+	}
+
+	bool is_escaped(const std::string& key)
+	{
+		return key.find("\xEF\xBC") != std::string::npos;	// common UTF-8 prefix of U+FF04 and U+FF0E
+	}
+
+	std::string unescape_mongo_key(std::string key)
+	{
+		boost::replace_all(key, "＄", "$");	// replace U+FF04 (unicode full width equivalent) by $
+		boost::replace_all(key, "．", ".");	// replace U+FF0E (unicode full width equivalent) by .
+
+		return key;
 	}
 }
 
-void Value::unescape_mongo()
+std::string escape_mongo_key(std::string key)
 {
-	if(_value.type() == typeid(Object))
-	{
-		auto& object = boost::get<Object>(_value);
-		Object tmp;
+	boost::replace_all(key, "$", "＄");	// replace $ by U+FF04 (unicode full width equivalent)
+	boost::replace_all(key, ".", "．");	// replace . by U+FF0E (unicode full width equivalent)
 
-		for(auto j = object.begin(); j != object.end();)
+	return key;
+}
+
+// subtrees without keys to rename are skipped, so their nodes stay shared
+void Value::escape_mongo()
+{
+	visit([](Value& value, const VisitPath&) -> Visit
+	{
+		if(!has_key(static_cast<const Value&>(value), is_escapable))
 		{
-			std::string ek = j->first;
-			boost::replace_all(ek, "＄", "$");	// replace U+FF04 (unicode full width equivalent) by $
-			boost::replace_all(ek, "．", ".");	// replace U+FF0E (unicode full width equivalent) by .
+			return Visit::skip;
+		}
 
-			if(ek != j->first)
-			{
-				tmp[ek] = j->second;
-				j = object.erase(j);
-			}
-			else
+		if(value.is_object() && has_key(value._object->data, is_escapable))
+		{
+			rename_keys(value.mutable_object(), [](const std::string& key)
 			{
-				++j;
-			}
+				return is_escapable(key) ? escape_mongo_key(key) : key;
+			});
+		}
+
+		return Visit::next;
+	},
+	types(Type::object) | types(Type::array));
+}
+
+void Value::unescape_mongo()
+{
+	visit([](Value& value, const VisitPath&) -> Visit
+	{
+		if(!has_key(static_cast<const Value&>(value), is_escaped))
+		{
+			return Visit::skip;
 		}
 
-		for(auto& j : tmp)
+		if(value.is_object() && has_key(value._object->data, is_escaped))
 		{
-			object[j.first] = j.second;
+			rename_keys(value.mutable_object(), [](const std::string& key)
+			{
+				return is_escaped(key) ? unescape_mongo_key(key) : key;
+			});
 		}
 
-		for(auto& j : object)
+		return Visit::next;
+	},
+	types(Type::object) | types(Type::array));
+}
+
+namespace
+{
+	struct pointee_hash
+	{
+		std::size_t operator()(const Value* value) const
 		{
-			j.second.unescape_mongo();
+			return value->hash();
 		}
-	}
-	else
-	if(_value.type() == typeid(Array))
+	};
+
+	struct pointee_equal
 	{
-		for(auto& j : boost::get<Array>(_value))
+		bool operator()(const Value* a, const Value* b) const
 		{
-			j.unescape_mongo();
+			return *a == *b;
 		}
-	}
+	};
 }
 
 void unique(Array& array)
 {
-	std::set<Value> exists;
+	// compacts in place, the set refers to the already kept elements in
+	// front of the write position which are never moved again
+	std::unordered_set<const Value*, pointee_hash, pointee_equal> exists;
+	exists.reserve(array.size());
 
-	for(auto i = array.begin(); i != array.end(); )
+	auto kept = array.begin();
+
+	for(auto i = array.begin(); i != array.end(); ++i)
 	{
-		if(exists.find(*i) != exists.end())
+		if(exists.find(&*i) != exists.end())
 		{
-			i = array.erase(i);
+			continue;
 		}
-		else
+
+		if(kept != i)
 		{
-			exists.insert(*i);
-			++i;
+			*kept = std::move(*i);
 		}
+
+		exists.insert(&*kept);
+		++kept;
 	}
+
+	array.erase(kept, array.end());
 }
 
 }
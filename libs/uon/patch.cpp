@@ -0,0 +1,326 @@
+#include "uon.hpp"
+
+namespace uon {
+
+namespace
+{
+	void append_segment(std::string& pointer, const std::string& segment)
+	{
+		pointer += '/';
+
+		for(auto c : segment)
+		{
+			if(c == '~')
+				pointer += "~0";
+			else
+			if(c == '/')
+				pointer += "~1";
+			else
+				pointer += c;
+		}
+	}
+
+	std::vector<std::string> parse_pointer(const std::string& pointer)
+	{
+		std::vector<std::string> segments;
+
+		if(pointer.empty())
+		{
+			return segments;
+		}
+
+		if(pointer[0] != '/')
+		{
+			throw std::runtime_error("invalid patch path: " + pointer);
+		}
+
+		segments.emplace_back();
+
+		for(std::size_t i = 1; i < pointer.size(); ++i)
+		{
+			if(pointer[i] == '/')
+			{
+				segments.emplace_back();
+				continue;
+			}
+
+			if(pointer[i] == '~')
+			{
+				if(i + 1 == pointer.size() || (pointer[i+1] != '0' && pointer[i+1] != '1'))
+				{
+					throw std::runtime_error("invalid patch path: " + pointer);
+				}
+
+				segments.back() += (pointer[++i] == '0') ? '~' : '/';
+				continue;
+			}
+
+			segments.back() += pointer[i];
+		}
+
+		return segments;
+	}
+
+	void add_operation(Array& patch, const char* op, const std::string& pointer, const Value* value)
+	{
+		Object operation;
+		operation["op"] = op;
+		operation["path"] = pointer;
+
+		if(value)
+		{
+			operation["value"] = *value;
+		}
+
+		patch.push_back(Value(std::move(operation)));
+	}
+
+	void diff(const Value& from, const Value& to, std::string& pointer, Array& patch)
+	{
+		auto length = pointer.size();
+
+		if(from.is_object() && to.is_object())
+		{
+			auto& from_object = from.as_object();
+			auto& to_object = to.as_object();
+
+			// shared node, nothing can differ
+			if(&from_object == &to_object)
+			{
+				return;
+			}
+
+			// both are sorted by key
+			auto i = from_object.begin();
+			auto j = to_object.begin();
+
+			while(i != from_object.end() || j != to_object.end())
+			{
+				if(j == to_object.end() || (i != from_object.end() && i->first < j->first))
+				{
+					append_segment(pointer, i->first);
+					add_operation(patch, "remove", pointer, nullptr);
+					++i;
+				}
+				else
+				if(i == from_object.end() || j->first < i->first)
+				{
+					append_segment(pointer, j->first);
+					add_operation(patch, "add", pointer, &j->second);
+					++j;
+				}
+				else
+				{
+					append_segment(pointer, i->first);
+					diff(i->second, j->second, pointer, patch);
+					++i;
+					++j;
+				}
+
+				pointer.resize(length);
+			}
+
+			return;
+		}
+
+		if(from.is_array() && to.is_array() && from.as_array().size() == to.as_array().size())
+		{
+			auto& from_array = from.as_array();
+			auto& to_array = to.as_array();
+
+			if(&from_array == &to_array)
+			{
+				return;
+			}
+
+			for(std::size_t i = 0; i < from_array.size(); ++i)
+			{
+				append_segment(pointer, std::to_string(i));
+				diff(from_array[i], to_array[i], pointer, patch);
+				pointer.resize(length);
+			}
+
+			return;
+		}
+
+		if(from != to)
+		{
+			add_operation(patch, "replace", pointer, &to);
+		}
+	}
+
+	// index into an array of the given size, the end of it if append is
+	// allowed ("-" or the size itself)
+	std::size_t array_index(const std::string& segment, std::size_t size, bool append, const std::string& pointer)
+	{
+		if(append && segment == "-")
+		{
+			return size;
+		}
+
+		auto index = Path(std::vector<std::string>{ segment }).index(0);
+
+		if(index == Path::no_index || (segment.size() > 1 && segment[0] == '0') || index > size || (index == size && !append))
+		{
+			throw NotFound(pointer);
+		}
+
+		return index;
+	}
+
+	void apply_operation(Value& target, const std::string& op, const std::string& pointer, const Value* value)
+	{
+		auto segments = parse_pointer(pointer);
+
+		if(segments.empty())
+		{
+			target = (op == "remove") ? Value() : *value;
+			return;
+		}
+
+		auto key = segments.back();
+		segments.pop_back();
+
+		auto parent = target.find(Path(segments));
+
+		if(!parent)
+		{
+			throw NotFound(pointer);
+		}
+
+		if(parent->is_object())
+		{
+			// checked before the object is taken out of the value
+			if(op != "add" && parent->as_object().count(key) == 0)
+			{
+				throw NotFound(pointer);
+			}
+
+			auto object = std::move(*parent).as_object();
+
+			if(op == "remove")
+			{
+				object.erase(key);
+			}
+			else
+			{
+				object[key] = *value;
+			}
+
+			*parent = std::move(object);
+		}
+		else
+		if(parent->is_array())
+		{
+			auto index = array_index(key, parent->as_array().size(), op == "add", pointer);
+			auto array = std::move(*parent).as_array();
+
+			if(op == "remove")
+			{
+				array.erase(array.begin() + index);
+			}
+			else
+			if(op == "add")
+			{
+				array.insert(array.begin() + index, *value);
+			}
+			else
+			{
+				array[index] = *value;
+			}
+
+			*parent = std::move(array);
+		}
+		else
+		{
+			throw NotFound(pointer);
+		}
+	}
+}
+
+Value diff(const Value& from, const Value& to)
+{
+	Array patch;
+	std::string pointer;
+
+	diff(from, to, pointer, patch);
+
+	return Value(std::move(patch));
+}
+
+void apply_patch(Value& target, const Value& patch)
+{
+	// the patch may be part of the target
+	Value operations(patch);
+
+	for(auto& operation : operations.as_array())
+	{
+		auto& op = operation.getref("op").as_string();
+		auto& pointer = operation.getref("path").as_string();
+
+		if(op == "add" || op == "replace")
+		{
+			apply_operation(target, op, pointer, &operation.getref("value"));
+		}
+		else
+		if(op == "remove")
+		{
+			apply_operation(target, op, pointer, nullptr);
+		}
+		else
+		{
+			throw std::runtime_error("unsupported patch operation: " + op);
+		}
+	}
+}
+
+Value to_mongo_update(const Value& patch, const std::string& prefix)
+{
+	Value update;
+
+	for(auto& operation : patch.as_array())
+	{
+		auto& op = operation.getref("op").as_string();
+		auto& pointer = operation.getref("path").as_string();
+
+		std::string field = prefix;
+
+		for(auto& segment : parse_pointer(pointer))
+		{
+			if(segment == "-")
+			{
+				throw std::runtime_error("array insertion cannot be expressed as mongo update: " + pointer);
+			}
+
+			if(!field.empty())
+			{
+				field += '.';
+			}
+
+			field += segment;
+		}
+
+		if(field.empty())
+		{
+			throw std::runtime_error("patch replaces the whole document");
+		}
+
+		if(op == "add" || op == "replace")
+		{
+			update.set(std::vector<std::string>{ "$set", field }, operation.getref("value"));
+		}
+		else
+		if(op == "remove")
+		{
+			update.set(std::vector<std::string>{ "$unset", field }, "");
+		}
+		else
+		{
+			throw std::runtime_error("unsupported patch operation: " + op);
+		}
+	}
+
+	return update;
+}
+
+}
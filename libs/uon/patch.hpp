@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace uon
+{
+	// Structural difference as a JSON Patch (RFC 6902) array of add, remove
+	// and replace operations, so apply_patch(from, diff(from, to)) yields
+	// to. Objects are compared member by member and arrays of equal length
+	// element by element; anything else that differs is replaced as a whole.
+	extern Value diff(const Value& from, const Value& to);
+
+	// Applies the add, remove and replace operations of a JSON Patch.
+	extern void apply_patch(Value& target, const Value& patch);
+
+	// The patch as a mongo update document ({"$set": ..., "$unset": ...})
+	// for the field at prefix (dot separated, empty for the document). Keys
+	// have to be escaped already (see escape_mongo). Operations are taken
+	// to address object members or replace array elements, as in patches
+	// from diff(); array insertions and removals cannot be expressed.
+	extern Value to_mongo_update(const Value& patch, const std::string& prefix = "");
+}
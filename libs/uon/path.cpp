@@ -0,0 +1,109 @@
+#include "uon.hpp"
+
+#include <limits>
+#include <boost/algorithm/string.hpp>
+
+namespace uon
+{
+
+const std::size_t Path::no_index = std::numeric_limits<std::size_t>::max();
+
+Path::Path()
+{
+}
+
+Path::Path(const char* path)
+	: Path(std::string(path))
+{
+}
+
+Path::Path(const std::string& path)
+{
+	boost::split(_segments, path, boost::is_any_of("."));
+	parse_indices();
+}
+
+Path::Path(const std::vector<std::string>& segments)
+	: _segments(segments.begin(), segments.end())
+{
+	parse_indices();
+}
+
+Path::Path(std::initializer_list<std::string> segments)
+	: _segments(segments.begin(), segments.end())
+{
+	parse_indices();
+}
+
+void Path::parse_indices()
+{
+	_indices.reserve(_segments.size());
+
+	for(auto& segment : _segments)
+	{
+		std::size_t index = 0;
+		bool valid = !segment.empty();
+
+		for(auto c : segment)
+		{
+			if(c < '0' || c > '9' || index > (no_index - 10) / 10)
+			{
+				valid = false;
+				break;
+			}
+
+			index = index * 10 + (c - '0');
+		}
+
+		_indices.push_back(valid ? index : no_index);
+	}
+}
+
+bool Path::empty() const
+{
+	return _segments.empty();
+}
+
+std::size_t Path::size() const
+{
+	return _segments.size();
+}
+
+const std::string& Path::operator[](std::size_t position) const
+{
+	return _segments[position];
+}
+
+std::size_t Path::index(std::size_t position) const
+{
+	return _indices[position];
+}
+
+Path::const_iterator Path::begin() const
+{
+	return _segments.begin();
+}
+
+Path::const_iterator Path::end() const
+{
+	return _segments.end();
+}
+
+std::string Path::to_string() const
+{
+	std::string result;
+
+	for(auto& segment : _segments)
+	{
+		if(&segment != &_segments.front())
+		{
+			result += '.';
+		}
+
+		result += segment;
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <initializer_list>
+
+#include "key.hpp"
+
+namespace uon
+{
+	// A Path is a parsed, dot separated address into a Value tree, e.g.
+	// "meta.arch.host.descriptor". Parsing happens once on construction,
+	// so frequently used paths can be kept around (e.g. as static const)
+	// and walked by index without splitting or allocating again. Segments
+	// are plain strings, objects are searched by text, so walking a path
+	// does not touch the key table; keys are interned only where set()
+	// or merge() add members.
+	class Path
+	{
+	public:
+		using const_iterator = std::vector<std::string>::const_iterator;
+
+		static const std::size_t no_index;
+
+		Path();
+		Path(const char* path);
+		Path(const std::string& path);
+		Path(const std::vector<std::string>& segments);
+		Path(std::initializer_list<std::string> segments);
+
+		bool empty() const;
+		std::size_t size() const;
+
+		const std::string& operator[](std::size_t position) const;
+
+		// numeric value of the segment at position (for array access) or
+		// no_index if the segment is not a valid array index
+		std::size_t index(std::size_t position) const;
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		std::string to_string() const;
+
+	private:
+		void parse_indices();
+
+		std::vector<std::string> _segments;
+		std::vector<std::size_t> _indices;
+	};
+}
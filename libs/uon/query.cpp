@@ -0,0 +1,272 @@
+#include "uon.hpp"
+
+namespace uon {
+
+namespace
+{
+	Value parse_literal(const std::string& text)
+	{
+		try
+		{
+			return read_json(text);
+		}
+		catch(const ParseError&)
+		{
+			return Value(text);
+		}
+	}
+}
+
+Query::Query(const char* query)
+	: _query(query)
+{
+	parse(_query);
+}
+
+Query::Query(const std::string& query)
+	: _query(query)
+{
+	parse(_query);
+}
+
+std::size_t Query::count(const Value& root) const
+{
+	std::size_t matches = 0;
+
+	for_each(root, [&matches](const Value&, const VisitPath&)
+	{
+		++matches;
+		return Visit::next;
+	});
+
+	return matches;
+}
+
+Value Query::select(const Value& root) const
+{
+	Array matches;
+
+	for_each(root, [this, &matches](const Value& match, const VisitPath&)
+	{
+		if(_projection.empty())
+		{
+			matches.push_back(match);
+			return Visit::next;
+		}
+
+		Object projected;
+
+		if(match.is_object())
+		{
+			auto& object = match.as_object();
+
+			for(auto& key : _projection)
+			{
+				auto i = object.find(key);
+
+				if(i != object.end())
+				{
+					projected[key] = i->second;
+				}
+			}
+		}
+
+		matches.push_back(Value(std::move(projected)));
+		return Visit::next;
+	});
+
+	return Value(std::move(matches));
+}
+
+std::string Query::to_string() const
+{
+	return _query;
+}
+
+void Query::parse(const std::string& query)
+{
+	auto error = [&query](const std::string& message)
+	{
+		return std::runtime_error("invalid query '" + query + "': " + message);
+	};
+
+	std::size_t i = 0;
+
+	while(i < query.size())
+	{
+		if(!_projection.empty())
+		{
+			throw error("projection has to be the last step");
+		}
+
+		if(query[i] == '{')
+		{
+			std::string key;
+
+			for(++i;; ++i)
+			{
+				if(i == query.size())
+				{
+					throw error("unterminated projection");
+				}
+
+				if(query[i] == ',' || query[i] == '}')
+				{
+					if(key.empty())
+					{
+						throw error("empty key in projection");
+					}
+
+					_projection.emplace_back(key);
+					key.clear();
+
+					if(query[i] == '}')
+					{
+						++i;
+						break;
+					}
+
+					continue;
+				}
+
+				key += query[i];
+			}
+		}
+		else
+		{
+			Step step;
+			std::string name;
+
+			while(i < query.size() && query[i] != '.' && query[i] != '[')
+			{
+				name += query[i++];
+			}
+
+			if(name.empty())
+			{
+				throw error("empty step");
+			}
+
+			step.any = (name == "*");
+			step.key = Key(name);
+			step.index = Path(std::vector<std::string>{ name }).index(0);
+
+			while(i < query.size() && query[i] == '[')
+			{
+				auto end = query.find(']', i);
+
+				if(end == std::string::npos)
+				{
+					throw error("unterminated filter");
+				}
+
+				auto condition = query.substr(i + 1, end - i - 1);
+				auto equals = condition.find('=');
+
+				Filter filter;
+				filter.exists = (equals == std::string::npos);
+				filter.negate = !filter.exists && equals > 0 && condition[equals-1] == '!';
+
+				auto field = filter.exists ? condition : condition.substr(0, filter.negate ? equals - 1 : equals);
+
+				if(field.empty())
+				{
+					throw error("empty filter path");
+				}
+
+				filter.field = Path(field);
+
+				if(!filter.exists)
+				{
+					filter.value = parse_literal(condition.substr(equals + 1));
+				}
+
+				step.filters.push_back(std::move(filter));
+				i = end + 1;
+			}
+
+			_steps.push_back(std::move(step));
+		}
+
+		if(i < query.size())
+		{
+			if(query[i] != '.' || i + 1 == query.size())
+			{
+				throw error("expected '.' between steps");
+			}
+
+			++i;
+		}
+	}
+}
+
+bool Query::accepts(const Step& step, const Value& value)
+{
+	for(auto& filter : step.filters)
+	{
+		auto field = value.find(filter.field);
+
+		if(filter.exists)
+		{
+			if(!field)
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		bool equal = field && *field == filter.value;
+
+		if(equal == filter.negate)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const Value* Query::child(const Value& value, const Step& step, VisitPath::Segment& segment)
+{
+	if(value.is_object())
+	{
+		auto& object = value.as_object();
+		auto i = object.find(step.key);
+
+		if(i == object.end())
+		{
+			return nullptr;
+		}
+
+		segment = VisitPath::Segment{ &i->first.str(), 0 };
+		return &i->second;
+	}
+
+	if(value.is_array())
+	{
+		auto& array = value.as_array();
+
+		if(step.index == Path::no_index || step.index >= array.size())
+		{
+			return nullptr;
+		}
+
+		segment = VisitPath::Segment{ nullptr, step.index };
+		return &array[step.index];
+	}
+
+	return nullptr;
+}
+
+void Query::push(VisitPath& path, const VisitPath::Segment& segment)
+{
+	path._segments.push_back(segment);
+}
+
+void Query::pop(VisitPath& path)
+{
+	path._segments.pop_back();
+}
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace uon
+{
+	// A Query selects values below a root by a dot separated list of steps,
+	// parsed once on construction, e.g.
+	//
+	//   tasks.*.details.results.*[type=error]
+	//   details.*.*[result!=Ok].{name,status}
+	//
+	// A step is a key (or array index) or * for every member or element,
+	// followed by any number of filters: [path=value], [path!=value] or
+	// [path] (exists). Filter values are read as json if possible and as
+	// plain strings otherwise. A last step {key,...} projects the matches
+	// onto the listed keys in select().
+	class Query
+	{
+	public:
+		Query(const char* query);
+		Query(const std::string& query);
+
+		// calls visitor(match, path) for every match in document order,
+		// without copying; path is relative to root. The visitor returns
+		// Visit::stop to end the walk early. Returns false if it was ended.
+		template<typename Visitor>
+		bool for_each(const Value& root, Visitor&& visitor) const;
+
+		std::size_t count(const Value& root) const;
+
+		// the matches as array, projected if the query ends in a projection
+		Value select(const Value& root) const;
+
+		std::string to_string() const;
+
+	private:
+		struct Filter
+		{
+			Path field;
+			bool negate;
+			bool exists;
+			Value value;
+		};
+
+		struct Step
+		{
+			bool any;
+			Key key;
+			std::size_t index;
+			std::vector<Filter> filters;
+		};
+
+		void parse(const std::string& query);
+
+		static bool accepts(const Step& step, const Value& value);
+		static const Value* child(const Value& value, const Step& step, VisitPath::Segment& segment);
+		static void push(VisitPath& path, const VisitPath::Segment& segment);
+		static void pop(VisitPath& path);
+
+		template<typename Visitor>
+		Visit match(const Value& value, std::size_t position, Visitor& visitor, VisitPath& path) const;
+
+		std::string _query;
+		std::vector<Step> _steps;
+		std::vector<Key> _projection;
+	};
+
+	template<typename Visitor>
+	bool Query::for_each(const Value& root, Visitor&& visitor) const
+	{
+		VisitPath path;
+		return match(root, 0, visitor, path) != Visit::stop;
+	}
+
+	template<typename Visitor>
+	Visit Query::match(const Value& value, std::size_t position, Visitor& visitor, VisitPath& path) const
+	{
+		if(position == _steps.size())
+		{
+			return (visitor(value, static_cast<const VisitPath&>(path)) == Visit::stop) ? Visit::stop : Visit::next;
+		}
+
+		auto& step = _steps[position];
+
+		if(!step.any)
+		{
+			VisitPath::Segment segment;
+			auto next = child(value, step, segment);
+
+			if(!next || !accepts(step, *next))
+			{
+				return Visit::next;
+			}
+
+			push(path, segment);
+			auto control = match(*next, position + 1, visitor, path);
+			pop(path);
+
+			return control;
+		}
+
+		if(value.is_object())
+		{
+			for(auto& i : value.as_object())
+			{
+				if(!accepts(step, i.second))
+				{
+					continue;
+				}
+
+				push(path, VisitPath::Segment{ &i.first.str(), 0 });
+				auto control = match(i.second, position + 1, visitor, path);
+				pop(path);
+
+				if(control == Visit::stop)
+				{
+					return control;
+				}
+			}
+		}
+		else
+		if(value.is_array())
+		{
+			auto& array = value.as_array();
+
+			for(std::size_t i = 0; i < array.size(); ++i)
+			{
+				if(!accepts(step, array[i]))
+				{
+					continue;
+				}
+
+				push(path, VisitPath::Segment{ nullptr, i });
+				auto control = match(array[i], position + 1, visitor, path);
+				pop(path);
+
+				if(control == Visit::stop)
+				{
+					return control;
+				}
+			}
+		}
+
+		return Visit::next;
+	}
+}
@@ -9,14 +9,46 @@
 
 namespace uon {
 
+	class ParseError : public std::runtime_error
+	{
+	public:
+		ParseError(const std::string& message, std::size_t offset);
+
+		// byte offset of the first character that could not be accepted,
+		// the input length if the input ended early
+		std::size_t offset() const;
+
+	private:
+		std::size_t _offset;
+	};
+
 	extern Value read_json(std::istream& input);
 	extern Value read_json(boost::filesystem::path input);
 	extern Value read_json(std::string input);
+	extern Value read_json(const char* data, std::size_t length);
 
-#if !defined(_WIN32)
+	// single pass parsing into a handler, nothing is built in between
+	extern void read_json(std::istream& input, Handler& handler);
+	extern void read_json(boost::filesystem::path input, Handler& handler);
+	extern void read_json(const char* data, std::size_t length, Handler& handler);
+
+	// a single bson document; types json has no equivalent of are read in
+	// mongo's extended json form, e.g. {"$oid": "..."} or {"$date": ms}
 	extern Value read_bson(std::istream& input);
 	extern Value read_bson(boost::filesystem::path input);
+	extern Value read_bson(const char* data, std::size_t length);
+	extern void read_bson(const char* data, std::size_t length, Handler& handler);
+
+	// messagepack; strings and binary data are read as strings, map keys
+	// have to be strings. The handler variants pass strings straight from
+	// the input (memory mapped for files).
+	extern Value read_msgpack(std::istream& input);
+	extern Value read_msgpack(boost::filesystem::path input);
+	extern Value read_msgpack(const char* data, std::size_t length);
+	extern void read_msgpack(boost::filesystem::path input, Handler& handler);
+	extern void read_msgpack(const char* data, std::size_t length, Handler& handler);
 
+#if !defined(_WIN32)
 	extern Value from_mongo_bson(const mongo::BSONObj& mval);
 #endif
 }
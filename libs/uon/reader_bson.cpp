@@ -1,29 +1,388 @@
 #include "uon.hpp"
 
 #include <fstream>
+#include <cstring>
 
 namespace uon {
 
-#if !defined(_WIN32)
+namespace
+{
+	const char hex_digits[] = "0123456789abcdef";
+	const char base64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	// decodes a single document; the extended json forms mongo's
+	// jsonString produces are passed on for types json has no equivalent of
+	class Decoder
+	{
+	public:
+		Decoder(const char* data, std::size_t length, Handler& handler)
+			: _begin(data)
+			, _current(data)
+			, _end(data + length)
+			, _handler(handler)
+		{ }
+
+		void decode()
+		{
+			// end of each open document, and whether it is an array
+			std::vector<std::pair<const char*, bool>> documents;
+
+			begin_document(documents, false);
+
+			while(!documents.empty())
+			{
+				auto type = static_cast<unsigned char>(read_byte());
+
+				if(type == 0)
+				{
+					if(_current != documents.back().first)
+					{
+						error("document size mismatch");
+					}
+
+					if(documents.back().second)
+					{
+						_handler.end_array();
+					}
+					else
+					{
+						_handler.end_object();
+					}
+
+					documents.pop_back();
+					continue;
+				}
+
+				auto name = read_cstring();
+
+				if(!documents.back().second)
+				{
+					_handler.key(name, std::strlen(name));
+				}
+
+				switch(type)
+				{
+					case 0x01:
+						_handler.real(read_double());
+						break;
+
+					case 0x02:
+					case 0x0E:	// symbol
+					{
+						auto length = read_string_length();
+						_handler.string(_current, length);
+						_current += length + 1;
+						break;
+					}
+
+					case 0x03:
+						begin_document(documents, false);
+						break;
+
+					case 0x04:
+						begin_document(documents, true);
+						break;
+
+					case 0x05:
+						read_binary();
+						break;
+
+					case 0x06:	// undefined
+					case 0x0A:
+						_handler.null();
+						break;
+
+					case 0x07:
+					{
+						auto id = read_bytes(12);
+
+						char text[24];
+
+						for(std::size_t i = 0; i < 12; ++i)
+						{
+							text[i*2] = hex_digits[static_cast<unsigned char>(id[i]) >> 4];
+							text[i*2+1] = hex_digits[static_cast<unsigned char>(id[i]) & 0x0F];
+						}
+
+						begin_wrapper("$oid");
+						_handler.string(text, sizeof(text));
+						_handler.end_object();
+						break;
+					}
+
+					case 0x08:
+						_handler.boolean(read_byte() != 0);
+						break;
+
+					case 0x09:
+						begin_wrapper("$date");
+						_handler.integer(static_cast<Integer>(read_uint64()));
+						_handler.end_object();
+						break;
+
+					case 0x0B:
+					{
+						auto pattern = read_cstring();
+						auto options = read_cstring();
+
+						begin_wrapper("$regex");
+						_handler.string(pattern, std::strlen(pattern));
+						_handler.key("$options", 8);
+						_handler.string(options, std::strlen(options));
+						_handler.end_object();
+						break;
+					}
+
+					case 0x10:
+						_handler.integer(static_cast<std::int32_t>(read_uint32()));
+						break;
+
+					case 0x11:
+					{
+						auto increment = read_uint32();
+						auto time = read_uint32();
+
+						begin_wrapper("$timestamp");
+						_handler.begin_object();
+						_handler.key("i", 1);
+						_handler.integer(increment);
+						_handler.key("t", 1);
+						_handler.integer(time);
+						_handler.end_object();
+						_handler.end_object();
+						break;
+					}
+
+					case 0x12:
+						_handler.integer(static_cast<Integer>(read_uint64()));
+						break;
+
+					case 0x7F:
+						begin_wrapper("$maxKey");
+						_handler.integer(1);
+						_handler.end_object();
+						break;
+
+					case 0xFF:
+						begin_wrapper("$minKey");
+						_handler.integer(1);
+						_handler.end_object();
+						break;
+
+					default:
+						error("unsupported bson type");
+				}
+			}
+
+			if(_current != _end)
+			{
+				error("unexpected trailing bytes");
+			}
+		}
+
+	private:
+		void begin_document(std::vector<std::pair<const char*, bool>>& documents, bool array)
+		{
+			auto start = _current;
+			auto size = read_uint32();
+
+			if(size < 5 || size > static_cast<std::size_t>(_end - start))
+			{
+				_current = start;
+				error("invalid document size");
+			}
+
+			if(start[size-1] != 0)
+			{
+				_current = start;
+				error("document not terminated");
+			}
+
+			documents.emplace_back(start + size, array);
+
+			if(array)
+			{
+				_handler.begin_array();
+			}
+			else
+			{
+				_handler.begin_object();
+			}
+		}
+
+		void begin_wrapper(const char* key)
+		{
+			_handler.begin_object();
+			_handler.key(key, std::strlen(key));
+		}
+
+		void read_binary()
+		{
+			auto length = read_uint32();
+			auto subtype = static_cast<unsigned char>(read_byte());
+			auto data = reinterpret_cast<const unsigned char*>(read_bytes(length));
+
+			std::string text;
+			text.reserve((length + 2) / 3 * 4);
+
+			for(std::size_t i = 0; i < length; i += 3)
+			{
+				unsigned long group = static_cast<unsigned long>(data[i]) << 16;
+
+				if(i + 1 < length) group |= static_cast<unsigned long>(data[i+1]) << 8;
+				if(i + 2 < length) group |= data[i+2];
+
+				text += base64_digits[(group >> 18) & 0x3F];
+				text += base64_digits[(group >> 12) & 0x3F];
+				text += (i + 1 < length) ? base64_digits[(group >> 6) & 0x3F] : '=';
+				text += (i + 2 < length) ? base64_digits[group & 0x3F] : '=';
+			}
+
+			char type[2] = { hex_digits[subtype >> 4], hex_digits[subtype & 0x0F] };
+
+			begin_wrapper("$binary");
+			_handler.string(text.data(), text.size());
+			_handler.key("$type", 5);
+			_handler.string(type, sizeof(type));
+			_handler.end_object();
+		}
+
+		std::size_t read_string_length()
+		{
+			auto start = _current;
+			auto length = read_uint32();
+
+			if(length < 1 || length > static_cast<std::size_t>(_end - _current) || _current[length-1] != 0)
+			{
+				_current = start;
+				error("invalid string");
+			}
+
+			return length - 1;
+		}
+
+		const char* read_cstring()
+		{
+			auto start = _current;
+			auto terminator = static_cast<const char*>(std::memchr(_current, 0, _end - _current));
+
+			if(terminator == nullptr)
+			{
+				error("unterminated string");
+			}
+
+			_current = terminator + 1;
+			return start;
+		}
+
+		const char* read_bytes(std::size_t length)
+		{
+			if(length > static_cast<std::size_t>(_end - _current))
+			{
+				error("unexpected end of input");
+			}
+
+			auto start = _current;
+			_current += length;
+			return start;
+		}
+
+		char read_byte()
+		{
+			return *read_bytes(1);
+		}
+
+		std::uint32_t read_uint32()
+		{
+			auto bytes = reinterpret_cast<const unsigned char*>(read_bytes(4));
+
+			return static_cast<std::uint32_t>(bytes[0])
+				| static_cast<std::uint32_t>(bytes[1]) << 8
+				| static_cast<std::uint32_t>(bytes[2]) << 16
+				| static_cast<std::uint32_t>(bytes[3]) << 24;
+		}
+
+		std::uint64_t read_uint64()
+		{
+			std::uint64_t low = read_uint32();
+			std::uint64_t high = read_uint32();
+
+			return low | high << 32;
+		}
+
+		Real read_double()
+		{
+			auto bits = read_uint64();
+
+			Real value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		[[noreturn]] void error(const char* message)
+		{
+			throw ParseError(message, _current - _begin);
+		}
+
+		const char* _begin;
+		const char* _current;
+		const char* _end;
+		Handler& _handler;
+	};
+}
+
+void read_bson(const char* data, std::size_t length, Handler& handler)
+{
+	Decoder(data, length, handler).decode();
+}
+
+Value read_bson(const char* data, std::size_t length)
+{
+	ValueBuilder builder;
+	read_bson(data, length, builder);
+	return builder.result();
+}
 
 Value read_bson(std::istream& input)
 {
 	input.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-	throw std::runtime_error("not implemented");
+
+	// a document starts with its total size
+	char prefix[4];
+	input.read(prefix, sizeof(prefix));
+
+	auto bytes = reinterpret_cast<const unsigned char*>(prefix);
+	std::size_t size = static_cast<std::size_t>(bytes[0])
+		| static_cast<std::size_t>(bytes[1]) << 8
+		| static_cast<std::size_t>(bytes[2]) << 16
+		| static_cast<std::size_t>(bytes[3]) << 24;
+
+	if(size < 5 || size > 0x7FFFFFFF)
+	{
+		throw ParseError("invalid document size", 0);
+	}
+
+	std::string buffer(size, '\0');
+	std::memcpy(&buffer[0], prefix, sizeof(prefix));
+	input.read(&buffer[sizeof(prefix)], size - sizeof(prefix));
+
+	return read_bson(buffer.data(), buffer.size());
 }
 
 Value read_bson(boost::filesystem::path input)
 {
 	std::ifstream stream;
 	stream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-	stream.open( input.string() );
+	stream.open( input.string(), std::ios::binary );
 
 	return read_bson(stream);
 }
 
+#if !defined(_WIN32)
+
 Value from_mongo_bson(const mongo::BSONObj& mval)
 {
-	return read_json(mval.jsonString());
+	return read_bson(mval.objdata(), mval.objsize());
 }
 
 #endif
@@ -1,90 +1,626 @@
 #include "uon.hpp"
 
 #include <fstream>
-#include <sstream>
-#include <json_spirit/json_spirit_reader.h>
 
 namespace uon {
 
-Value read_json(std::string input)
+ParseError::ParseError(const std::string& message, std::size_t offset)
+	: std::runtime_error(message + " at offset " + std::to_string(offset))
+	, _offset(offset)
 {
-	std::stringstream stream(input);
-	return read_json(stream);
 }
 
-Value read_json(std::istream& input)
+std::size_t ParseError::offset() const
 {
-	input.exceptions( std::ifstream::failbit | std::ifstream::badbit );
+	return _offset;
+}
+
+namespace
+{
+	// input already in memory, strings without escapes are passed to the
+	// handler without copying
+	struct BufferSource
+	{
+		BufferSource(const char* data, std::size_t length)
+			: begin(data)
+			, current(data)
+			, end(data + length)
+		{ }
+
+		bool fill()
+		{
+			return false;
+		}
+
+		std::size_t offset() const
+		{
+			return current - begin;
+		}
+
+		const char* begin;
+		const char* current;
+		const char* end;
+	};
+
+	// input read from a stream in chunks, so only one chunk is held in
+	// memory besides the value being built
+	struct StreamSource
+	{
+		explicit StreamSource(std::istream& input)
+			: input(input)
+			, buffer(64 * 1024)
+			, consumed(0)
+			, begin(buffer.data())
+			, current(begin)
+			, end(begin)
+		{ }
+
+		bool fill()
+		{
+			consumed += end - begin;
+
+			input.read(buffer.data(), buffer.size());
+
+			if(input.bad())
+			{
+				throw std::runtime_error("failed to read json input");
+			}
+
+			begin = buffer.data();
+			current = begin;
+			end = begin + input.gcount();
+
+			return current != end;
+		}
+
+		std::size_t offset() const
+		{
+			return consumed + (current - begin);
+		}
 
-	json_spirit::Value spval;
-	json_spirit::read(input, spval);
+		std::istream& input;
+		std::vector<char> buffer;
+		std::size_t consumed;
+		const char* begin;
+		const char* current;
+		const char* end;
+	};
 
-	std::function<Value(const json_spirit::Value& spval)> convert = [&convert](const json_spirit::Value& spval) -> Value
+	template<typename Source>
+	class Parser
 	{
-		switch(spval.type())
+	public:
+		Parser(Source& source, Handler& handler)
+			: _source(source)
+			, _handler(handler)
+		{ }
+
+		void parse()
+		{
+			// containers are tracked on an explicit stack, so deeply nested
+			// input cannot overflow the call stack
+			std::vector<bool> objects;
+
+			for(;;)
+			{
+				parse_value(objects);
+
+				// the value is complete, close containers until the next one
+				for(;;)
+				{
+					skip_whitespace();
+
+					if(objects.empty())
+					{
+						if(peek() != eof)
+						{
+							error("unexpected trailing characters");
+						}
+
+						return;
+					}
+
+					auto c = peek();
+
+					if(c == ',')
+					{
+						++_source.current;
+
+						if(objects.back())
+						{
+							parse_key();
+						}
+
+						break;
+					}
+
+					if(c == (objects.back() ? '}' : ']'))
+					{
+						++_source.current;
+
+						if(objects.back())
+						{
+							_handler.end_object();
+						}
+						else
+						{
+							_handler.end_array();
+						}
+
+						objects.pop_back();
+						continue;
+					}
+
+					error(objects.back() ? "expected ',' or '}'" : "expected ',' or ']'");
+				}
+			}
+		}
+
+	private:
+		static const int eof = -1;
+
+		void parse_value(std::vector<bool>& objects)
+		{
+			for(;;)
+			{
+				skip_whitespace();
+
+				switch(peek())
+				{
+					case '{':
+						++_source.current;
+						_handler.begin_object();
+						skip_whitespace();
+
+						if(peek() == '}')
+						{
+							++_source.current;
+							_handler.end_object();
+							return;
+						}
+
+						objects.push_back(true);
+						parse_key();
+						continue;
+
+					case '[':
+						++_source.current;
+						_handler.begin_array();
+						skip_whitespace();
+
+						if(peek() == ']')
+						{
+							++_source.current;
+							_handler.end_array();
+							return;
+						}
+
+						objects.push_back(false);
+						continue;
+
+					case '"':
+						++_source.current;
+						parse_string(false);
+						return;
+
+					case 't':
+						expect_literal("true");
+						_handler.boolean(true);
+						return;
+
+					case 'f':
+						expect_literal("false");
+						_handler.boolean(false);
+						return;
+
+					case 'n':
+						expect_literal("null");
+						_handler.null();
+						return;
+
+					case '-': case '0': case '1': case '2': case '3': case '4':
+					case '5': case '6': case '7': case '8': case '9':
+						parse_number();
+						return;
+
+					case eof:
+						error("unexpected end of input");
+
+					default:
+						error("unexpected character");
+				}
+			}
+		}
+
+		void parse_key()
+		{
+			skip_whitespace();
+
+			expect('"', "expected string as object key");
+			parse_string(true);
+			skip_whitespace();
+			expect(':', "expected ':'");
+		}
+
+		void parse_string(bool key)
+		{
+			_scratch.clear();
+
+			for(;;)
+			{
+				auto start = _source.current;
+				auto i = start;
+
+				while(i != _source.end && *i != '"' && *i != '\\')
+				{
+					++i;
+				}
+
+				if(i != _source.end && *i == '"' && _scratch.empty())
+				{
+					// no escapes and no chunk boundary, pass the input through
+					_source.current = i + 1;
+					emit_string(key, start, i - start);
+					return;
+				}
+
+				_scratch.append(start, i);
+				_source.current = i;
+
+				if(i == _source.end)
+				{
+					if(!_source.fill())
+					{
+						error("unterminated string");
+					}
+
+					continue;
+				}
+
+				++_source.current;
+
+				if(*i == '"')
+				{
+					emit_string(key, _scratch.data(), _scratch.size());
+					return;
+				}
+
+				parse_escape();
+			}
+		}
+
+		void emit_string(bool key, const char* data, std::size_t length)
+		{
+			if(key)
+			{
+				_handler.key(data, length);
+			}
+			else
+			{
+				_handler.string(data, length);
+			}
+		}
+
+		void parse_escape()
+		{
+			auto c = peek();
+
+			switch(c)
+			{
+				case '"':  _scratch += '"'; break;
+				case '\\': _scratch += '\\'; break;
+				case '/':  _scratch += '/'; break;
+				case 'b':  _scratch += '\b'; break;
+				case 'f':  _scratch += '\f'; break;
+				case 'n':  _scratch += '\n'; break;
+				case 'r':  _scratch += '\r'; break;
+				case 't':  _scratch += '\t'; break;
+
+				case 'u':
+				{
+					++_source.current;
+					unsigned long code = parse_hex4();
+
+					if(code >= 0xD800 && code <= 0xDBFF)
+					{
+						// surrogate pair
+						expect('\\', "expected low surrogate");
+						expect('u', "expected low surrogate");
+
+						auto offset = _source.offset();
+						unsigned long low = parse_hex4();
+
+						if(low < 0xDC00 || low > 0xDFFF)
+						{
+							throw ParseError("invalid low surrogate", offset);
+						}
+
+						code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+					}
+					else
+					if(code >= 0xDC00 && code <= 0xDFFF)
+					{
+						code = 0xFFFD;
+					}
+
+					append_utf8(code);
+					return;
+				}
+
+				default:
+					error("invalid escape sequence");
+			}
+
+			++_source.current;
+		}
+
+		unsigned long parse_hex4()
+		{
+			unsigned long code = 0;
+
+			for(int i = 0; i < 4; ++i)
+			{
+				auto c = peek();
+				code <<= 4;
+
+				if(c >= '0' && c <= '9')
+					code |= c - '0';
+				else
+				if(c >= 'a' && c <= 'f')
+					code |= c - 'a' + 10;
+				else
+				if(c >= 'A' && c <= 'F')
+					code |= c - 'A' + 10;
+				else
+					error("invalid unicode escape");
+
+				++_source.current;
+			}
+
+			return code;
+		}
+
+		void append_utf8(unsigned long code)
+		{
+			if(code < 0x80)
+			{
+				_scratch += static_cast<char>(code);
+			}
+			else
+			if(code < 0x800)
+			{
+				_scratch += static_cast<char>(0xC0 | (code >> 6));
+				_scratch += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else
+			if(code < 0x10000)
+			{
+				_scratch += static_cast<char>(0xE0 | (code >> 12));
+				_scratch += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				_scratch += static_cast<char>(0x80 | (code & 0x3F));
+			}
+			else
+			{
+				_scratch += static_cast<char>(0xF0 | (code >> 18));
+				_scratch += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+				_scratch += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				_scratch += static_cast<char>(0x80 | (code & 0x3F));
+			}
+		}
+
+		void parse_number()
 		{
-			case json_spirit::obj_type:
+			_scratch.clear();
+
+			bool negative = (peek() == '-');
+			bool real = false;
+
+			if(negative)
+			{
+				_scratch += static_cast<char>(next());
+			}
+
+			if(!append_digits())
 			{
-				Object obj;
-				for(auto& e : spval.get_obj())
+				error("expected digit");
+			}
+
+			if(peek() == '.')
+			{
+				real = true;
+				_scratch += static_cast<char>(next());
+
+				if(!append_digits())
 				{
-					obj[e.name_] = convert(e.value_);
+					error("expected digit");
 				}
-				return obj;
 			}
 
-			case json_spirit::array_type:
+			if(peek() == 'e' || peek() == 'E')
 			{
-				Array arr;
-				for(auto& e : spval.get_array())
+				real = true;
+				_scratch += static_cast<char>(next());
+
+				if(peek() == '+' || peek() == '-')
+				{
+					_scratch += static_cast<char>(next());
+				}
+
+				if(!append_digits())
+				{
+					error("expected digit");
+				}
+			}
+
+			auto first = _scratch.data();
+			auto last = first + _scratch.size();
+
+			if(!real)
+			{
+				// integers are kept exact as long as they fit 64 bits
+				Integer integer;
+				Unsigned unsigned_integer;
+
+				if(from_chars(first, last, integer) == last)
+				{
+					_handler.integer(integer);
+					return;
+				}
+
+				if(!negative && from_chars(first, last, unsigned_integer) == last)
 				{
-					arr.push_back(convert(e));
+					_handler.unsigned_integer(unsigned_integer);
+					return;
 				}
-				return arr;
 			}
 
-			case json_spirit::str_type:
+			Real value;
+			from_chars(first, last, value);
+			_handler.real(value);
+		}
+
+		bool append_digits()
+		{
+			bool any = false;
+
+			for(auto c = peek(); c >= '0' && c <= '9'; c = peek())
 			{
-				return spval.get_str();
+				_scratch += static_cast<char>(c);
+				++_source.current;
+				any = true;
 			}
 
-			case json_spirit::bool_type:
+			return any;
+		}
+
+		void expect_literal(const char* literal)
+		{
+			for(auto i = literal; *i; ++i)
 			{
-				return spval.get_bool();
+				expect(*i, "invalid literal");
 			}
+		}
 
-			case json_spirit::int_type:
+		// consumes c, errors point at what is found instead
+		void expect(char c, const char* message)
+		{
+			if(peek() != static_cast<unsigned char>(c))
 			{
-				if(spval.is_uint64()) {
-					return static_cast<long double>(spval.get_uint64());
+				error(message);
+			}
+
+			++_source.current;
+		}
+
+		void skip_whitespace()
+		{
+			for(;;)
+			{
+				while(_source.current != _source.end)
+				{
+					switch(*_source.current)
+					{
+						case ' ': case '\t': case '\n': case '\r':
+							++_source.current;
+							continue;
+					}
+
+					return;
+				}
+
+				if(!_source.fill())
+				{
+					return;
 				}
-				return static_cast<long double>(spval.get_int64());
 			}
+		}
 
-			case json_spirit::real_type:
+		int peek()
+		{
+			if(_source.current == _source.end && !_source.fill())
 			{
-				return static_cast<long double>(spval.get_real());
+				return eof;
 			}
 
-			case json_spirit::null_type:
+			return static_cast<unsigned char>(*_source.current);
+		}
+
+		int next()
+		{
+			auto c = peek();
+
+			if(c != eof)
 			{
-				return Null();
+				++_source.current;
 			}
+
+			return c;
 		}
 
-		throw std::runtime_error("invalid type");
+		[[noreturn]] void error(const char* message)
+		{
+			throw ParseError(message, _source.offset());
+		}
+
+		Source& _source;
+		Handler& _handler;
+		std::string _scratch;
 	};
+}
 
-	return convert(spval);
+void read_json(const char* data, std::size_t length, Handler& handler)
+{
+	BufferSource source(data, length);
+	Parser<BufferSource>(source, handler).parse();
 }
 
-Value read_json(boost::filesystem::path input)
+void read_json(std::istream& input, Handler& handler)
+{
+	// the last chunk ends with eof and failbit set, only fail on real errors
+	input.exceptions( std::ifstream::badbit );
+
+	StreamSource source(input);
+	Parser<StreamSource>(source, handler).parse();
+}
+
+void read_json(boost::filesystem::path input, Handler& handler)
 {
 	std::ifstream stream;
-	stream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-	stream.open( input.string() );
+	stream.exceptions( std::ifstream::badbit );
+	stream.open( input.string(), std::ios::binary );
+
+	if(!stream)
+	{
+		throw std::runtime_error("failed to open " + input.string());
+	}
+
+	read_json(stream, handler);
+}
 
-	return read_json(stream);
+Value read_json(const char* data, std::size_t length)
+{
+	ValueBuilder builder;
+	read_json(data, length, builder);
+	return builder.result();
+}
+
+Value read_json(std::string input)
+{
+	return read_json(input.data(), input.size());
+}
+
+Value read_json(std::istream& input)
+{
+	ValueBuilder builder;
+	read_json(input, builder);
+	return builder.result();
+}
+
+Value read_json(boost::filesystem::path input)
+{
+	ValueBuilder builder;
+	read_json(input, builder);
+	return builder.result();
 }
 
 }
@@ -0,0 +1,322 @@
+#include "uon.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <cstring>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace uon {
+
+namespace
+{
+	// strings are passed to the handler straight from the input
+	class Decoder
+	{
+	public:
+		Decoder(const char* data, std::size_t length, Handler& handler)
+			: _begin(data)
+			, _current(data)
+			, _end(data + length)
+			, _handler(handler)
+		{ }
+
+		void decode()
+		{
+			// items left in each open container, and whether it is a map
+			std::vector<std::pair<std::size_t, bool>> containers;
+
+			for(;;)
+			{
+				if(!containers.empty() && containers.back().second)
+				{
+					read_key();
+				}
+
+				if(read_item(containers))
+				{
+					// a container with items was opened, they come next
+					continue;
+				}
+
+				// an item is complete, count it off and close what is done
+				for(;;)
+				{
+					if(containers.empty())
+					{
+						if(_current != _end)
+						{
+							error("unexpected trailing bytes");
+						}
+
+						return;
+					}
+
+					if(--containers.back().first > 0)
+					{
+						break;
+					}
+
+					close(containers.back().second);
+					containers.pop_back();
+				}
+			}
+		}
+
+	private:
+		// true if a container with items was opened
+		bool read_item(std::vector<std::pair<std::size_t, bool>>& containers)
+		{
+			auto type = read_byte();
+
+			if(type <= 0x7F)
+			{
+				_handler.integer(type);
+				return false;
+			}
+
+			if(type >= 0xE0)
+			{
+				_handler.integer(static_cast<std::int8_t>(type));
+				return false;
+			}
+
+			if((type & 0xE0) == 0xA0)
+			{
+				read_string(type & 0x1F);
+				return false;
+			}
+
+			if((type & 0xF0) == 0x90)
+			{
+				return open(containers, type & 0x0F, false);
+			}
+
+			if((type & 0xF0) == 0x80)
+			{
+				return open(containers, type & 0x0F, true);
+			}
+
+			switch(type)
+			{
+				case 0xC0: _handler.null(); return false;
+				case 0xC2: _handler.boolean(false); return false;
+				case 0xC3: _handler.boolean(true); return false;
+
+				// binary data has no type of its own in uon
+				case 0xC4:
+				case 0xD9: read_string(read_uint(1)); return false;
+				case 0xC5:
+				case 0xDA: read_string(read_uint(2)); return false;
+				case 0xC6:
+				case 0xDB: read_string(read_uint(4)); return false;
+
+				case 0xCA:
+				{
+					auto bits = static_cast<std::uint32_t>(read_uint(4));
+					float value;
+					std::memcpy(&value, &bits, sizeof(value));
+					_handler.real(value);
+					return false;
+				}
+
+				case 0xCB:
+				{
+					auto bits = read_uint(8);
+					Real value;
+					std::memcpy(&value, &bits, sizeof(value));
+					_handler.real(value);
+					return false;
+				}
+
+				case 0xCC: _handler.integer(static_cast<Integer>(read_uint(1))); return false;
+				case 0xCD: _handler.integer(static_cast<Integer>(read_uint(2))); return false;
+				case 0xCE: _handler.integer(static_cast<Integer>(read_uint(4))); return false;
+
+				case 0xCF:
+				{
+					auto value = read_uint(8);
+
+					if(value <= static_cast<Unsigned>(std::numeric_limits<Integer>::max()))
+					{
+						_handler.integer(static_cast<Integer>(value));
+					}
+					else
+					{
+						_handler.unsigned_integer(value);
+					}
+					return false;
+				}
+
+				case 0xD0: _handler.integer(static_cast<std::int8_t>(read_uint(1))); return false;
+				case 0xD1: _handler.integer(static_cast<std::int16_t>(read_uint(2))); return false;
+				case 0xD2: _handler.integer(static_cast<std::int32_t>(read_uint(4))); return false;
+				case 0xD3: _handler.integer(static_cast<Integer>(read_uint(8))); return false;
+
+				case 0xDC: return open(containers, read_uint(2), false);
+				case 0xDD: return open(containers, read_uint(4), false);
+				case 0xDE: return open(containers, read_uint(2), true);
+				case 0xDF: return open(containers, read_uint(4), true);
+			}
+
+			--_current;
+			error("unsupported messagepack type");
+		}
+
+		bool open(std::vector<std::pair<std::size_t, bool>>& containers, std::size_t size, bool map)
+		{
+			if(map)
+			{
+				_handler.begin_object();
+			}
+			else
+			{
+				_handler.begin_array();
+			}
+
+			if(size == 0)
+			{
+				close(map);
+				return false;
+			}
+
+			containers.emplace_back(size, map);
+			return true;
+		}
+
+		void close(bool map)
+		{
+			if(map)
+			{
+				_handler.end_object();
+			}
+			else
+			{
+				_handler.end_array();
+			}
+		}
+
+		void read_key()
+		{
+			auto type = read_byte();
+			std::size_t length;
+
+			if((type & 0xE0) == 0xA0)
+				length = type & 0x1F;
+			else
+			if(type == 0xD9)
+				length = read_uint(1);
+			else
+			if(type == 0xDA)
+				length = read_uint(2);
+			else
+			if(type == 0xDB)
+				length = read_uint(4);
+			else
+			{
+				--_current;
+				error("expected string as map key");
+			}
+
+			auto data = read_bytes(length);
+			_handler.key(data, length);
+		}
+
+		void read_string(std::size_t length)
+		{
+			auto data = read_bytes(length);
+			_handler.string(data, length);
+		}
+
+		const char* read_bytes(std::size_t length)
+		{
+			if(length > static_cast<std::size_t>(_end - _current))
+			{
+				error("unexpected end of input");
+			}
+
+			auto start = _current;
+			_current += length;
+			return start;
+		}
+
+		unsigned char read_byte()
+		{
+			return static_cast<unsigned char>(*read_bytes(1));
+		}
+
+		// big endian
+		std::uint64_t read_uint(std::size_t size)
+		{
+			auto bytes = reinterpret_cast<const unsigned char*>(read_bytes(size));
+			std::uint64_t value = 0;
+
+			for(std::size_t i = 0; i < size; ++i)
+			{
+				value = value << 8 | bytes[i];
+			}
+
+			return value;
+		}
+
+		[[noreturn]] void error(const char* message)
+		{
+			throw ParseError(message, _current - _begin);
+		}
+
+		const char* _begin;
+		const char* _current;
+		const char* _end;
+		Handler& _handler;
+	};
+}
+
+void read_msgpack(const char* data, std::size_t length, Handler& handler)
+{
+	Decoder(data, length, handler).decode();
+}
+
+void read_msgpack(boost::filesystem::path input, Handler& handler)
+{
+	if(!boost::filesystem::is_regular_file(input))
+	{
+		throw std::runtime_error("failed to open " + input.string());
+	}
+
+	if(boost::filesystem::file_size(input) == 0)
+	{
+		read_msgpack(nullptr, 0, handler);
+		return;
+	}
+
+	// strings reach the handler straight from the mapped file
+	boost::interprocess::file_mapping file(input.string().c_str(), boost::interprocess::read_only);
+	boost::interprocess::mapped_region region(file, boost::interprocess::read_only);
+
+	read_msgpack(static_cast<const char*>(region.get_address()), region.get_size(), handler);
+}
+
+Value read_msgpack(const char* data, std::size_t length)
+{
+	ValueBuilder builder;
+	read_msgpack(data, length, builder);
+	return builder.result();
+}
+
+Value read_msgpack(std::istream& input)
+{
+	input.exceptions( std::ifstream::badbit );
+
+	std::string buffer( (std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>() );
+	return read_msgpack(buffer.data(), buffer.size());
+}
+
+Value read_msgpack(boost::filesystem::path input)
+{
+	ValueBuilder builder;
+	read_msgpack(input, builder);
+	return builder.result();
+}
+
+}
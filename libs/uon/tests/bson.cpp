@@ -0,0 +1,234 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <cstring>
+
+namespace {
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	uon::Value read(const std::string& bson)
+	{
+		return uon::read_bson(bson.data(), bson.size());
+	}
+
+	// little endian encodings to handcraft documents with
+	std::string int32(std::uint32_t value)
+	{
+		std::string bytes;
+
+		for(int i = 0; i < 4; ++i)
+		{
+			bytes += static_cast<char>((value >> (i * 8)) & 0xFF);
+		}
+
+		return bytes;
+	}
+
+	std::string int64(std::uint64_t value)
+	{
+		return int32(static_cast<std::uint32_t>(value)) + int32(static_cast<std::uint32_t>(value >> 32));
+	}
+
+	std::string real(double value)
+	{
+		std::uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return int64(bits);
+	}
+
+	std::string cstring(const std::string& text)
+	{
+		return text + std::string(1, '\0');
+	}
+
+	std::string string(const std::string& text)
+	{
+		return int32(static_cast<std::uint32_t>(text.size() + 1)) + cstring(text);
+	}
+
+	std::string element(unsigned char type, const std::string& name, const std::string& payload = "")
+	{
+		return std::string(1, static_cast<char>(type)) + cstring(name) + payload;
+	}
+
+	std::string document(const std::string& elements)
+	{
+		return int32(static_cast<std::uint32_t>(elements.size() + 5)) + elements + std::string(1, '\0');
+	}
+
+	// the bytes read as json, and json written as the bytes
+	void round_trip(const std::string& bson, const std::string& json)
+	{
+		auto value = parse(json);
+
+		UON_CHECK_EQUAL(uon::write_json(read(bson), true), uon::write_json(value, true));
+		UON_CHECK(uon::write_bson(value) == bson);
+	}
+
+	// json that looks like an extended type but is not valid as one is
+	// written as a plain document and read back unchanged
+	void plain(const std::string& json)
+	{
+		auto value = parse("{\"v\":" + json + "}");
+		auto bson = uon::write_bson(value);
+
+		UON_CHECK_EQUAL(static_cast<int>(bson[4]), 0x03);
+		UON_CHECK(read(bson) == value);
+	}
+
+	std::size_t error_offset(const std::string& bson)
+	{
+		try
+		{
+			read(bson);
+		}
+		catch(const uon::ParseError& e)
+		{
+			return e.offset();
+		}
+
+		return std::string::npos;
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(bson)
+{
+	// json types; members are written in key order
+	round_trip(document(
+		element(0x01, "a", real(1.5)) +
+		element(0x02, "b", string("text \xC3\xA9")) +
+		element(0x03, "c", document(element(0x08, "d", std::string(1, '\1')))) +
+		element(0x04, "e", document(element(0x10, "0", int32(7)) + element(0x0A, "1"))) +
+		element(0x08, "f", std::string(1, '\0')) +
+		element(0x0A, "g") +
+		element(0x10, "h", int32(static_cast<std::uint32_t>(-2147483647 - 1))) +
+		element(0x12, "i", int64(1ULL << 40)) +
+		element(0x12, "j", int64(static_cast<std::uint64_t>(-(1LL << 40))))),
+		"{\"a\":1.5,\"b\":\"text \xC3\xA9\",\"c\":{\"d\":true},\"e\":[7,null],\"f\":false,\"g\":null,"
+		"\"h\":-2147483648,\"i\":1099511627776,\"j\":-1099511627776}");
+
+	round_trip(document(""), "{}");
+	round_trip(document(element(0x04, "a", document(""))), "{\"a\":[]}");
+
+	// extended types
+	round_trip(document(element(0x07, "id", std::string("\x01\x23\x45\x67\x89\xAB\xCD\xEF\x00\xFF\x10\x20", 12))),
+		"{\"id\":{\"$oid\":\"0123456789abcdef00ff1020\"}}");
+
+	round_trip(document(element(0x09, "at", int64(1700000000123ULL))),
+		"{\"at\":{\"$date\":1700000000123}}");
+	round_trip(document(element(0x09, "at", int64(static_cast<std::uint64_t>(-86400000LL)))),
+		"{\"at\":{\"$date\":-86400000}}");
+
+	round_trip(document(element(0x11, "ts", int32(7) + int32(4000000000U))),
+		"{\"ts\":{\"$timestamp\":{\"i\":7,\"t\":4000000000}}}");
+
+	round_trip(document(element(0x0B, "re", cstring("^a.*\\d$") + cstring("im"))),
+		"{\"re\":{\"$options\":\"im\",\"$regex\":\"^a.*\\\\d$\"}}");
+
+	round_trip(document(element(0x7F, "hi") + element(0xFF, "lo")),
+		"{\"hi\":{\"$maxKey\":1},\"lo\":{\"$minKey\":1}}");
+
+	// binary data of every length modulo 3, so with either padding
+	struct Binary
+	{
+		std::string data;
+		std::string base64;
+	};
+
+	const Binary binaries[] = {
+		{ "", "" },
+		{ "A", "QQ==" },
+		{ "AB", "QUI=" },
+		{ "ABC", "QUJD" },
+		{ "ABCD", "QUJDRA==" },
+		{ std::string("\0\xFF\xFE", 3), "AP/+" },
+		{ std::string("\xFB\xEF", 2), "++8=" },
+	};
+
+	for(auto& binary : binaries)
+	{
+		round_trip(document(element(0x05, "bin", int32(static_cast<std::uint32_t>(binary.data.size())) + "\x80" + binary.data)),
+			"{\"bin\":{\"$binary\":\"" + binary.base64 + "\",\"$type\":\"80\"}}");
+	}
+
+	// $numberLong is written as int64 and read as a plain integer
+	UON_CHECK(uon::write_bson(parse("{\"n\":{\"$numberLong\":\"5\"}}")) == document(element(0x12, "n", int64(5))));
+	UON_CHECK(uon::write_bson(parse("{\"n\":{\"$numberLong\":\"-9223372036854775808\"}}")) == document(element(0x12, "n", int64(1ULL << 63))));
+	UON_CHECK(read(document(element(0x12, "n", int64(5)))) == parse("{\"n\":5}"));
+
+	// integers beyond int64 become doubles, symbols strings and undefined null
+	UON_CHECK(uon::write_bson(parse("{\"u\":18446744073709551615}")) == document(element(0x01, "u", real(18446744073709551615.0))));
+	UON_CHECK(read(document(element(0x0E, "s", string("sym")) + element(0x06, "u"))) == parse("{\"s\":\"sym\",\"u\":null}"));
+
+	// invalid extended json stays a document
+	plain("{\"$oid\":\"0123456789abcdef0123456g\"}");
+	plain("{\"$oid\":\"0123456789abcdef\"}");
+	plain("{\"$oid\":12}");
+	plain("{\"$date\":1.5}");
+	plain("{\"$date\":\"2020-01-01\"}");
+	plain("{\"$numberLong\":\"12x\"}");
+	plain("{\"$numberLong\":\"\"}");
+	plain("{\"$numberLong\":\"99999999999999999999\"}");
+	plain("{\"$timestamp\":{\"t\":1}}");
+	plain("{\"$regex\":\"a\"}");
+	plain("{\"$regex\":\"a\",\"$flags\":\"i\"}");
+	plain("{\"$binary\":\"QQ=A\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"Q===\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"QQ\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"Q!==\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"=QQQ\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"QQ==QQ==\",\"$type\":\"00\"}");
+	plain("{\"$binary\":\"QQ==\",\"$type\":\"0g\"}");
+	plain("{\"$binary\":\"QQ==\",\"$type\":\"0\"}");
+	plain("{\"$oid\":\"0123456789abcdef01234567\",\"x\":1}");
+
+	// keys must not contain null characters
+	uon::Value nul;
+	nul.set(uon::Path{ std::string("a\0b", 3) }, uon::Value(true));
+	UON_CHECK_THROWS(uon::write_bson(nul), std::runtime_error);
+
+	// truncated and malformed documents are rejected with the offset of
+	// the problem
+	auto full = document(
+		element(0x02, "s", string("abc")) +
+		element(0x03, "d", document(element(0x07, "id", std::string(12, '\x11')))) +
+		element(0x05, "b", int32(3) + std::string(1, '\0') + "xyz") +
+		element(0x0B, "r", cstring("p") + cstring("")) +
+		element(0x12, "n", int64(1)));
+
+	UON_CHECK(read(full).is_object());
+
+	for(std::size_t length = 0; length < full.size(); ++length)
+	{
+		UON_CHECK_THROWS(uon::read_bson(full.data(), length), uon::ParseError);
+
+		// the same cut, but with the size and terminator of the outer
+		// document adjusted; it may end between two elements
+		if(length >= 5)
+		{
+			auto cut = int32(static_cast<std::uint32_t>(length)) + full.substr(4, length - 5) + std::string(1, '\0');
+
+			try
+			{
+				read(cut);
+			}
+			catch(const uon::ParseError&)
+			{ }
+		}
+	}
+
+	UON_CHECK_EQUAL(error_offset(""), 0u);
+	UON_CHECK_EQUAL(error_offset(int32(4) + std::string(1, '\0')), 0u);
+	UON_CHECK_EQUAL(error_offset(int32(6) + "\x0A" + "a"), 0u);
+	UON_CHECK_EQUAL(error_offset(document(element(0x13, "dec", std::string(16, '\0')))), 9u);
+	UON_CHECK_EQUAL(error_offset(document(element(0x02, "s", int32(100) + "abc"))), 7u);
+	UON_CHECK_EQUAL(error_offset(document(element(0x02, "s", int32(4) + "abcd"))), 7u);
+	UON_CHECK_EQUAL(error_offset(document(element(0x03, "d", int32(5) + "\x0A" + "x" + std::string(1, '\0') + std::string(1, '\0')))), 7u);
+	UON_CHECK_EQUAL(error_offset(document(element(0x0A, "a")) + "x"), 8u);
+}
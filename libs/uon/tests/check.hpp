@@ -0,0 +1,67 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace uon {
+
+namespace tests {
+
+	// A suite is a function of checks, registered under its name by
+	// UON_TEST_SUITE. A failed check is reported and the suite goes on.
+	struct Suite
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	std::vector<Suite>& suites();
+
+	struct Registration
+	{
+		Registration(const char* name, void (*run)());
+	};
+
+	void fail(const char* file, int line, const std::string& message);
+
+	// the number of failed checks so far
+	std::size_t failures();
+
+} // namespace: tests
+
+} // namespace: uon
+
+#define UON_TEST_SUITE(name) \
+	static void name##_suite(); \
+	static ::uon::tests::Registration name##_registration(#name, &name##_suite); \
+	static void name##_suite()
+
+#define UON_CHECK(expression) \
+	do { \
+		if(!(expression)) \
+			::uon::tests::fail(__FILE__, __LINE__, #expression); \
+	} while(false)
+
+#define UON_CHECK_EQUAL(actual, expected) \
+	do { \
+		const auto& actual_ = (actual); \
+		const auto& expected_ = (expected); \
+		if(!(actual_ == expected_)) \
+		{ \
+			std::ostringstream message_; \
+			message_ << #actual " == " #expected ": " << actual_ << " != " << expected_; \
+			::uon::tests::fail(__FILE__, __LINE__, message_.str()); \
+		} \
+	} while(false)
+
+#define UON_CHECK_THROWS(expression, Exception) \
+	do { \
+		try \
+		{ \
+			expression; \
+			::uon::tests::fail(__FILE__, __LINE__, #expression " did not throw " #Exception); \
+		} \
+		catch(const Exception&) \
+		{ } \
+	} while(false)
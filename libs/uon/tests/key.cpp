@@ -0,0 +1,87 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <thread>
+
+namespace {
+
+	// a document with count keys of its own, as from file or test names
+	std::string document(const std::string& prefix, int count)
+	{
+		std::string json = "{";
+
+		for(int i = 0; i < count; ++i)
+		{
+			json += (i ? ",\"" : "\"") + prefix + std::to_string(i) + "\":{\"" + prefix + "nested\":" + std::to_string(i) + "}";
+		}
+
+		return json + "}";
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(key)
+{
+	uon::Key a("alpha");
+	uon::Key b(std::string("alpha"));
+	uon::Key empty;
+
+	UON_CHECK(a == b);
+	UON_CHECK(a != uon::Key("beta"));
+	UON_CHECK(a < uon::Key("beta"));
+	UON_CHECK(empty == uon::Key(""));
+	UON_CHECK(empty.empty() && empty.str().empty() && empty.size() == 0);
+	UON_CHECK(!(empty < empty) && empty < a);
+	UON_CHECK_EQUAL(a.str(), "alpha");
+
+	// keys leave the table with the last value holding them
+	auto before = uon::Key::interned();
+
+	{
+		auto value = uon::read_json(document("unique_key_", 10000));
+		UON_CHECK_EQUAL(uon::Key::interned(), before + 10001);
+
+		auto copy = value;
+		copy.set("unique_key_0.added", true);
+		auto deep = value.copy();
+		UON_CHECK_EQUAL(uon::Key::interned(), before + 10002);
+	}
+
+	UON_CHECK_EQUAL(uon::Key::interned(), before);
+
+	// lookups go by text and intern nothing
+	auto value = uon::read_json(std::string("{\"meta\":{\"id\":1}}"));
+	before = uon::Key::interned();
+
+	UON_CHECK(value.find("meta.missing_key.below") == nullptr);
+	UON_CHECK(value.get("missing_key_too", uon::null) == uon::null);
+	UON_CHECK(value.get("meta.id") == uon::Value(std::int64_t(1)));
+	UON_CHECK_EQUAL(uon::Key::interned(), before);
+
+	// keys are copied and released from several threads at once
+	auto shared = uon::read_json(document("threaded_key_", 2000));
+	before = uon::Key::interned();
+
+	std::vector<std::thread> threads;
+
+	for(int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back([&shared, t]()
+			{
+				for(int i = 0; i < 20; ++i)
+				{
+					auto copy = shared.copy();
+					copy.set("threaded_key_" + std::to_string(i) + ".thread_" + std::to_string(t), true);
+					auto parsed = uon::read_json(document("thread_" + std::to_string(t) + "_", 200));
+				}
+			});
+	}
+
+	for(auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	UON_CHECK_EQUAL(uon::Key::interned(), before);
+}
@@ -0,0 +1,101 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <fstream>
+
+namespace {
+
+	const char* const documents[] = {
+		"{\"a\":1,\"b\":{\"c\":[true,null,\"x\"],\"d\":-2.5e3},\"e\":[]}",
+		"[ {\"id\": 1}, {\"id\": 2, \"tags\": [\"a\", \"b\"]}, [[[]]] ]",
+		// escaped keys, and keys that only differ once decoded
+		"{\"a\\\"b\":1,\"a\\\\b\":2,\"\\u00e9t\\u00e9\":3,\"\xC3\xA9t\\u00e9\":4,\"tab\\tkey\":{\"x\":5},\"a.b\":6,\"\":7}",
+		// duplicates, the last one wins, also when it is of another type
+		"{\"a\":1,\"b\":2,\"a\":3,\"o\":{\"x\":1},\"o\":{\"y\":2},\"\\u0061\":4}",
+		"{\"d\":{\"k\":[1]},\"d\":[{\"k\":1},{\"k\":2,\"k\":3}],\"e\\\"\":1,\"e\\u0022\":2}",
+		"  \n{ \"spaced\" : [ 1 , { \"in\" : \"side\" } ] }\n ",
+		"\"scalar\"",
+	};
+
+	// the lookups of every value in the document, compared with read_json
+	void check_document(const uon::LazyDocument& document, const uon::Value& expected)
+	{
+		UON_CHECK(document.value() == expected);
+
+		expected.visit([&](const uon::Value& value, const uon::VisitPath& visited) -> uon::Visit
+		{
+			auto path = visited.to_path();
+
+			UON_CHECK(document.has(path));
+			UON_CHECK(document.type(path) == value.type());
+			UON_CHECK(document.get(path) == expected.get(path));
+			UON_CHECK(document.get(path, uon::Value("default")) == value);
+
+			// and a member or element below it that does not exist
+			std::vector<std::string> missing(path.begin(), path.end());
+			missing.push_back("missing");
+			UON_CHECK(!document.has(missing));
+			UON_CHECK(document.get(missing, uon::Value("default")) == uon::Value("default"));
+			UON_CHECK_THROWS(document.get(missing), uon::NotFound);
+
+			missing.back() = "99";
+			UON_CHECK(document.has(missing) == (expected.find(missing) != nullptr));
+
+			return uon::Visit::next;
+		});
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(lazy)
+{
+	for(auto text : documents)
+	{
+		std::string json(text);
+		auto expected = uon::read_json(json.data(), json.size());
+
+		// lookups in any order, before and after the containers are indexed
+		uon::LazyDocument document(json.data(), json.size());
+		check_document(document, expected);
+		check_document(document, expected);
+	}
+
+	// duplicates as named cases
+	std::string duplicates(documents[3]);
+	uon::LazyDocument document(duplicates.data(), duplicates.size());
+	UON_CHECK(document.get("a") == uon::Value(std::int64_t(4)));
+	UON_CHECK(!document.has("o.x"));
+	UON_CHECK(document.get("o.y") == uon::Value(std::int64_t(2)));
+
+	std::string nested(documents[4]);
+	uon::LazyDocument nestedDocument(nested.data(), nested.size());
+	UON_CHECK(nestedDocument.get("d.1.k") == uon::Value(std::int64_t(3)));
+	UON_CHECK(nestedDocument.get(std::vector<std::string>{ "e\"" }) == uon::Value(std::int64_t(2)));
+
+	// from a mapped file, and an empty one
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("uon-lazy-%%%%-%%%%.json");
+
+	{
+		std::ofstream file(path.string(), std::ios::binary);
+		file << documents[2];
+	}
+
+	uon::LazyDocument mapped(path);
+	check_document(mapped, uon::read_json(std::string(documents[2])));
+
+	{
+		std::ofstream file(path.string(), std::ios::binary | std::ios::trunc);
+	}
+
+	uon::LazyDocument empty(path);
+	UON_CHECK_THROWS(empty.has("a"), uon::ParseError);
+
+	boost::filesystem::remove(path);
+	UON_CHECK_THROWS(uon::LazyDocument missing(path), std::runtime_error);
+
+	// malformed containers are reported when a lookup passes through them
+	std::string broken("{\"a\":[1,2,}");
+	uon::LazyDocument brokenDocument(broken.data(), broken.size());
+	UON_CHECK_THROWS(brokenDocument.get("a.0"), uon::ParseError);
+}
@@ -0,0 +1,95 @@
+#include "check.hpp"
+
+#include <cstring>
+#include <iostream>
+
+// Runs the named suites, or all of them without arguments, and fails if
+// any check failed.
+//
+//   uon_tests [suite]...
+
+namespace uon {
+
+namespace tests {
+
+	namespace {
+
+		std::size_t failed = 0;
+
+	} // namespace: <anonymous>
+
+	std::vector<Suite>& suites()
+	{
+		static std::vector<Suite> registered;
+		return registered;
+	}
+
+	Registration::Registration(const char* name, void (*run)())
+	{
+		suites().push_back(Suite{ name, run });
+	}
+
+	void fail(const char* file, int line, const std::string& message)
+	{
+		std::cerr << file << ":" << line << ": check failed: " << message << std::endl;
+		++failed;
+	}
+
+	std::size_t failures()
+	{
+		return failed;
+	}
+
+} // namespace: tests
+
+} // namespace: uon
+
+int main( int argc, const char* const* argv )
+{
+	using namespace uon::tests;
+
+	std::vector<Suite> selected;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		bool found = false;
+
+		for(auto& suite : suites())
+		{
+			if(std::strcmp(suite.name, argv[i]) == 0)
+			{
+				selected.push_back(suite);
+				found = true;
+			}
+		}
+
+		if(!found)
+		{
+			std::cerr << "unknown suite " << argv[i] << std::endl;
+			return 2;
+		}
+	}
+
+	if(argc == 1)
+	{
+		selected = suites();
+	}
+
+	for(auto& suite : selected)
+	{
+		auto before = failures();
+
+		try
+		{
+			suite.run();
+		}
+		catch(const std::exception& e)
+		{
+			fail(suite.name, 0, std::string("unexpected exception: ") + e.what());
+		}
+
+		std::cout << suite.name << ": " << (failures() == before ? "ok" : "FAILED") << std::endl;
+	}
+
+	return failures() == 0 ? 0 : 1;
+}
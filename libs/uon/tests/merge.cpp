@@ -0,0 +1,61 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+namespace {
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	std::string merged(uon::Value target, const uon::Value& overlay)
+	{
+		target.merge(overlay);
+		return uon::write_json(target, true);
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(merge)
+{
+	// objects are merged member by member, arrays appended, anything else replaced
+	UON_CHECK_EQUAL(merged(parse("{\"a\":1,\"b\":{\"c\":[1],\"d\":\"x\"}}"), parse("{\"b\":{\"c\":[2],\"d\":null,\"e\":true},\"f\":[]}")),
+		"{\"a\":1,\"b\":{\"c\":[1,2],\"d\":null,\"e\":true},\"f\":[]}");
+	UON_CHECK_EQUAL(merged(parse("[1]"), parse("{\"a\":1}")), "{\"a\":1}");
+	UON_CHECK_EQUAL(merged(parse("{\"a\":1}"), parse("2")), "2");
+
+	// the result does not depend on whether nodes are shared
+	auto a = parse("{\"tasks\":{\"x\":[1]},\"meta\":{\"id\":\"y\"}}");
+	const auto twice = "{\"meta\":{\"id\":\"y\"},\"tasks\":{\"x\":[1,1]}}";
+
+	auto shallow = a;
+	shallow.merge(a);
+	UON_CHECK_EQUAL(uon::write_json(shallow, true), twice);
+
+	auto deep = a.copy();
+	deep.merge(a);
+	UON_CHECK_EQUAL(uon::write_json(deep, true), twice);
+
+	uon::Value assembled;
+	assembled.set("tasks", a.get("tasks"));
+	assembled.set("meta", a.get("meta"));
+	UON_CHECK_EQUAL(merged(a, assembled), twice);
+
+	auto itself = a;
+	itself.merge(itself);
+	UON_CHECK_EQUAL(uon::write_json(itself, true), twice);
+
+	auto moved = a;
+	moved.merge(uon::Value(a));
+	UON_CHECK_EQUAL(uon::write_json(moved, true), twice);
+
+	// and the merged values are left as they were
+	UON_CHECK_EQUAL(uon::write_json(a, true), "{\"meta\":{\"id\":\"y\"},\"tasks\":{\"x\":[1]}}");
+	UON_CHECK_EQUAL(uon::write_json(assembled, true), "{\"meta\":{\"id\":\"y\"},\"tasks\":{\"x\":[1]}}");
+
+	// merging below a path
+	auto nested = a;
+	nested.merge("tasks", a.getref("tasks"));
+	UON_CHECK_EQUAL(uon::write_json(nested, true), twice);
+}
@@ -0,0 +1,213 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+	uon::Value decode(const std::string& data)
+	{
+		return uon::read_msgpack(data.data(), data.size());
+	}
+
+	unsigned int first(const std::string& data)
+	{
+		return static_cast<unsigned char>(data[0]);
+	}
+
+	// the value is encoded with the type byte and size given, and decoded
+	// to the same value and number kind
+	void check_number(const uon::Value& value, unsigned int type, std::size_t size)
+	{
+		auto data = uon::write_msgpack(value);
+		auto decoded = decode(data);
+
+		UON_CHECK_EQUAL(first(data), type);
+		UON_CHECK_EQUAL(data.size(), size);
+		UON_CHECK(decoded == value);
+
+		// unsigned values come back as integers while they fit one
+		auto kind = value.number_kind();
+
+		if(kind == uon::NumberKind::unsigned_integer && value.as_unsigned() <= static_cast<uon::Unsigned>(std::numeric_limits<uon::Integer>::max()))
+		{
+			kind = uon::NumberKind::integer;
+		}
+
+		UON_CHECK(decoded.number_kind() == kind);
+	}
+
+	void check_integer(std::int64_t value, unsigned int type, std::size_t size)
+	{
+		check_number(uon::Value(value), type, size);
+	}
+
+	// strings and keys of the given length use the header type and size
+	void check_string(std::size_t length, unsigned int type, std::size_t header)
+	{
+		std::string text(length, 'x');
+
+		if(length > 0)
+		{
+			text[length - 1] = 'y';
+		}
+
+		auto data = uon::write_msgpack(uon::Value(text));
+		UON_CHECK_EQUAL(first(data), type);
+		UON_CHECK_EQUAL(data.size(), header + length);
+		UON_CHECK(decode(data) == uon::Value(text));
+
+		uon::Object object;
+		object[text] = true;
+		auto key = uon::write_msgpack(uon::Value(object));
+		UON_CHECK_EQUAL(static_cast<unsigned char>(key[1]), type);
+		UON_CHECK(decode(key) == uon::Value(object));
+	}
+
+	// containers of the given size use the header type and size
+	void check_containers(std::size_t size, unsigned int map_type, unsigned int array_type, std::size_t header)
+	{
+		uon::Object::container_type members;
+		uon::Array elements;
+
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			members.push_back(uon::Object::value_type(std::to_string(i), uon::Value(static_cast<std::int64_t>(i % 100))));
+			elements.push_back(uon::Value(static_cast<std::int64_t>(i % 100)));
+		}
+
+		uon::Value map = uon::Object(std::move(members));
+		uon::Value array = std::move(elements);
+
+		auto data = uon::write_msgpack(map);
+		UON_CHECK_EQUAL(first(data), map_type);
+		UON_CHECK(decode(data) == map);
+
+		data = uon::write_msgpack(array);
+		UON_CHECK_EQUAL(first(data), array_type);
+		UON_CHECK_EQUAL(data.size(), header + size);
+		UON_CHECK(decode(data) == array);
+	}
+
+	// decoding the bytes throws a ParseError at offset
+	void check_error(const std::string& data, std::size_t offset)
+	{
+		try
+		{
+			decode(data);
+			uon::tests::fail(__FILE__, __LINE__, "no error at " + std::to_string(offset));
+		}
+		catch(const uon::ParseError& e)
+		{
+			UON_CHECK_EQUAL(e.offset(), offset);
+		}
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(msgpack)
+{
+	// integers at the bounds of each encoding
+	check_integer(0, 0x00, 1);
+	check_integer(127, 0x7F, 1);
+	check_integer(128, 0xCC, 2);
+	check_integer(255, 0xCC, 2);
+	check_integer(256, 0xCD, 3);
+	check_integer(65535, 0xCD, 3);
+	check_integer(65536, 0xCE, 5);
+	check_integer(4294967295, 0xCE, 5);
+	check_integer(4294967296, 0xCF, 9);
+	check_integer(std::numeric_limits<std::int64_t>::max(), 0xCF, 9);
+	check_integer(-1, 0xFF, 1);
+	check_integer(-32, 0xE0, 1);
+	check_integer(-33, 0xD0, 2);
+	check_integer(-128, 0xD0, 2);
+	check_integer(-129, 0xD1, 3);
+	check_integer(-32768, 0xD1, 3);
+	check_integer(-32769, 0xD2, 5);
+	check_integer(std::numeric_limits<std::int32_t>::min(), 0xD2, 5);
+	check_integer(std::numeric_limits<std::int32_t>::min() - 1LL, 0xD3, 9);
+	check_integer(std::numeric_limits<std::int64_t>::min(), 0xD3, 9);
+
+	check_number(uon::Value(std::uint64_t(200)), 0xCC, 2);
+	check_number(uon::Value(std::uint64_t(9223372036854775808ULL)), 0xCF, 9);
+	check_number(uon::Value(std::numeric_limits<std::uint64_t>::max()), 0xCF, 9);
+
+	// reals keep all their bits, also where json has no text for them
+	for(double real : { 0.0, -0.0, 1.5, -2.5e-300, 1e308, 5e-324, 0.1, std::numeric_limits<double>::infinity() })
+	{
+		check_number(uon::Value(real), 0xCB, 9);
+		auto decoded = decode(uon::write_msgpack(uon::Value(real))).as_real();
+		UON_CHECK(std::memcmp(&decoded, &real, sizeof(real)) == 0);
+	}
+
+	UON_CHECK(std::isnan(decode(uon::write_msgpack(uon::Value(std::nan("")))).as_real()));
+
+	// strings at the bounds of fixstr, str8, str16 and str32
+	check_string(0, 0xA0, 1);
+	check_string(31, 0xBF, 1);
+	check_string(32, 0xD9, 2);
+	check_string(255, 0xD9, 2);
+	check_string(256, 0xDA, 3);
+	check_string(65535, 0xDA, 3);
+	check_string(65536, 0xDB, 5);
+
+	// maps and arrays at the bounds of fixmap/fixarray, 16 and 32 bits
+	check_containers(0, 0x80, 0x90, 1);
+	check_containers(15, 0x8F, 0x9F, 1);
+	check_containers(16, 0xDE, 0xDC, 3);
+	check_containers(65535, 0xDE, 0xDC, 3);
+	check_containers(65536, 0xDF, 0xDD, 5);
+
+	// a document with everything, through all overloads
+	auto document = uon::read_json(std::string(
+		"{\"meta\":{\"id\":\"0f8f\",\"duration\":1.25,\"count\":-7,\"ok\":true,\"none\":null},"
+		"\"tasks\":[{\"name\":\"build\",\"lines\":[[1,\"text \\u00e9\"],[2,\"\"]]},[],{}],\"\":\"empty key\"}"));
+
+	auto data = uon::write_msgpack(document);
+	UON_CHECK(decode(data) == document);
+	UON_CHECK(uon::write_msgpack(decode(data)) == data);
+
+	std::istringstream stream(data);
+	UON_CHECK(uon::read_msgpack(stream) == document);
+
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("uon-msgpack-%%%%-%%%%.bin");
+	uon::write_msgpack(document, path);
+	UON_CHECK(uon::read_msgpack(path) == document);
+	boost::filesystem::remove(path);
+
+	// forms the writer does not produce
+	UON_CHECK(decode(std::string("\xD0\x05", 2)) == uon::Value(std::int64_t(5)));
+	UON_CHECK(decode(std::string("\xCD\x00\x01", 3)) == uon::Value(std::int64_t(1)));
+	UON_CHECK(decode(std::string("\xCA\x3F\xC0\x00\x00", 5)) == uon::Value(1.5));
+	UON_CHECK(decode(std::string("\xC4\x02" "ab", 4)) == uon::Value("ab"));
+	UON_CHECK(decode(std::string("\xDD\x00\x00\x00\x01\xC3", 6)) == uon::read_json(std::string("[true]")));
+	UON_CHECK(decode(std::string("\x82\xA1" "a\x01\xA1" "a\x02", 7)) == uon::read_json(std::string("{\"a\":2}")));
+
+	// truncated input fails where the missing bytes were to be read
+	for(std::size_t length = 0; length < data.size(); ++length)
+	{
+		try
+		{
+			decode(data.substr(0, length));
+			uon::tests::fail(__FILE__, __LINE__, "no error for " + std::to_string(length) + " bytes");
+		}
+		catch(const uon::ParseError& e)
+		{
+			UON_CHECK(e.offset() <= length);
+		}
+	}
+
+	check_error("", 0);
+	check_error(std::string("\xDA\x00", 2), 1);
+	check_error(std::string("\xA5" "abc", 4), 1);
+	check_error(std::string("\x92\x01", 2), 2);
+	check_error(std::string("\x81\x01\x02", 3), 1);
+	check_error(std::string("\x91\xC1", 2), 1);
+	check_error(std::string("\x01\x02", 2), 1);
+}
@@ -0,0 +1,176 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+
+namespace {
+
+	std::string text(uon::Real value)
+	{
+		char buffer[uon::max_number_chars];
+		return std::string(buffer, uon::to_chars(buffer, value));
+	}
+
+	template<typename T>
+	bool reads(const std::string& input, T expected, std::size_t length)
+	{
+		T value;
+		auto end = uon::from_chars(input.data(), input.data() + input.size(), value);
+
+		return static_cast<std::size_t>(end - input.data()) == length && (length == 0 || value == expected);
+	}
+
+	bool same(uon::Real a, uon::Real b)
+	{
+		return std::memcmp(&a, &b, sizeof(a)) == 0;
+	}
+
+	// a locale with a decimal comma, taken from UON_TEST_LOCALE if set
+	const char* comma_locale()
+	{
+		const char* candidates[] = {
+			std::getenv("UON_TEST_LOCALE"),
+			"de_DE.UTF-8", "de_DE.utf8", "de_DE", "fr_FR.UTF-8", "fr_FR.utf8", "ru_RU.UTF-8", "German_Germany.1252",
+		};
+
+		for(auto name : candidates)
+		{
+			if(name && std::setlocale(LC_ALL, name) && std::strcmp(std::localeconv()->decimal_point, ",") == 0)
+			{
+				return name;
+			}
+		}
+
+		std::setlocale(LC_ALL, "C");
+		return nullptr;
+	}
+
+	void check_conversions()
+	{
+		// integers, with the limits of their kinds
+		UON_CHECK(reads<uon::Integer>("-9223372036854775808", std::numeric_limits<uon::Integer>::min(), 20));
+		UON_CHECK(reads<uon::Integer>("9223372036854775807", std::numeric_limits<uon::Integer>::max(), 19));
+		UON_CHECK(reads<uon::Integer>("9223372036854775808", 0, 0));
+		UON_CHECK(reads<uon::Integer>("-", 0, 0));
+		UON_CHECK(reads<uon::Integer>("12,5", 12, 2));
+		UON_CHECK(reads<uon::Unsigned>("18446744073709551615", std::numeric_limits<uon::Unsigned>::max(), 20));
+		UON_CHECK(reads<uon::Unsigned>("18446744073709551616", 0, 0));
+		UON_CHECK(reads<uon::Unsigned>("-1", 0, 0));
+
+		char buffer[uon::max_number_chars];
+		UON_CHECK_EQUAL(std::string(buffer, uon::to_chars(buffer, std::numeric_limits<uon::Integer>::min())), "-9223372036854775808");
+		UON_CHECK_EQUAL(std::string(buffer, uon::to_chars(buffer, std::numeric_limits<uon::Unsigned>::max())), "18446744073709551615");
+
+		// reals are read with a decimal point only, in the json format
+		UON_CHECK(reads<uon::Real>("1.5", 1.5, 3));
+		UON_CHECK(reads<uon::Real>("1,5", 1.0, 1));
+		UON_CHECK(reads<uon::Real>("-0.000123e+4", -1.23, 12));
+		UON_CHECK(reads<uon::Real>("2.5E-3x", 0.0025, 6));
+		UON_CHECK(reads<uon::Real>("1e", 1.0, 1));
+		UON_CHECK(reads<uon::Real>("0.1000000000000000055511151231257827", 0.1, 36));
+		UON_CHECK(reads<uon::Real>("1.5e30", 1.5e30, 6));
+		UON_CHECK(reads<uon::Real>(std::string("17976931348623157") + std::string(292, '0') + ".0", 1.7976931348623157e308, 311));
+		UON_CHECK(reads<uon::Real>("4.9406564584124654e-324", 5e-324, 23));
+		UON_CHECK(reads<uon::Real>("-x", 0, 0));
+		UON_CHECK(reads<uon::Real>("x", 0, 0));
+
+		// and written with one, as the shortest text that reads back
+		UON_CHECK_EQUAL(text(1.5), "1.5");
+		UON_CHECK_EQUAL(text(-0.0), "-0");
+		UON_CHECK_EQUAL(text(0.1), "0.1");
+		UON_CHECK_EQUAL(text(1.0 / 3.0), "0.3333333333333333");
+		UON_CHECK_EQUAL(text(0.30000000000000004), "0.30000000000000004");
+		UON_CHECK_EQUAL(text(1e300), "1e+300");
+		UON_CHECK_EQUAL(text(-2.5e-10), "-2.5e-10");
+		UON_CHECK_EQUAL(text(std::numeric_limits<double>::infinity()), "inf");
+		UON_CHECK_EQUAL(uon::format_real(123456.75), "123456.75");
+
+		// json output and input
+		UON_CHECK_EQUAL(uon::write_json(uon::read_json(std::string("[1.5,-2.25e-3,1e300]")), true), "[1.5,-0.00225,1e+300]");
+	}
+
+	// random bit patterns, so all exponents are covered
+	std::vector<uon::Real> samples()
+	{
+		std::vector<uon::Real> values;
+		std::mt19937_64 random(20);
+
+		while(values.size() < 200000)
+		{
+			auto bits = random();
+			uon::Real value;
+			std::memcpy(&value, &bits, sizeof(value));
+
+			if(std::isfinite(value))
+			{
+				values.push_back(value);
+			}
+		}
+
+		// and short decimals, which take the fast paths
+		for(int i = -100000; i < 100000; i += 7)
+		{
+			values.push_back(i / 1000.0);
+			values.push_back(i * 1e20);
+		}
+
+		return values;
+	}
+
+	void check_round_trip(const std::vector<uon::Real>& values, const std::vector<std::string>& expected)
+	{
+		for(std::size_t i = 0; i < values.size(); ++i)
+		{
+			auto written = text(values[i]);
+			uon::Real read;
+
+			UON_CHECK_EQUAL(written, expected[i]);
+			UON_CHECK(uon::from_chars(written.data(), written.data() + written.size(), read) == written.data() + written.size());
+			UON_CHECK(same(read, values[i]));
+		}
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(number)
+{
+	std::setlocale(LC_ALL, "C");
+
+	auto values = samples();
+	std::vector<std::string> expected;
+
+	for(auto value : values)
+	{
+		expected.push_back(text(value));
+	}
+
+	check_conversions();
+	check_round_trip(values, expected);
+
+	// the same text under a locale with a decimal comma, which printf and
+	// strtod would use
+	auto locale = comma_locale();
+
+	if(!locale)
+	{
+		std::cout << "number: no locale with a decimal comma installed, checked in the C locale only" << std::endl;
+		return;
+	}
+
+	char buffer[16];
+	std::snprintf(buffer, sizeof(buffer), "%.1f", 1.5);
+	UON_CHECK_EQUAL(std::string(buffer), "1,5");
+
+	check_conversions();
+	check_round_trip(values, expected);
+
+	std::setlocale(LC_ALL, "C");
+}
@@ -0,0 +1,84 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <chrono>
+
+namespace {
+
+	std::string keys(const uon::Object& object)
+	{
+		std::string result;
+
+		for(auto& i : object)
+		{
+			result += i.first.str() + "=" + i.second.to_string() + " ";
+		}
+
+		return result;
+	}
+
+	uon::Object::value_type member(const char* key, std::int64_t value)
+	{
+		return uon::Object::value_type(key, uon::Value(value));
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(object)
+{
+	// built in bulk, the last of equal keys wins
+	uon::Object object({ member("c", 1), member("a", 2), member("c", 3), member("b", 4) });
+	UON_CHECK_EQUAL(keys(object), "a=2 b=4 c=3 ");
+
+	// inserted in bulk, existing members and the first of new ones are kept
+	object.insert_all({ member("d", 5), member("b", 6), member("0", 7), member("d", 8) });
+	UON_CHECK_EQUAL(keys(object), "0=7 a=2 b=4 c=3 d=5 ");
+
+	object.insert_all({});
+	UON_CHECK_EQUAL(keys(object), "0=7 a=2 b=4 c=3 d=5 ");
+
+	object["bb"] = std::int64_t(9);
+	object.erase("a");
+	UON_CHECK_EQUAL(keys(object), "0=7 b=4 bb=9 c=3 d=5 ");
+
+	// merges insert members between existing ones
+	auto merged = uon::read_json(std::string("{\"b\":{\"x\":1},\"d\":[1]}"));
+	merged.merge(uon::read_json(std::string("{\"a\":1,\"b\":{\"w\":2,\"y\":3},\"c\":null,\"d\":[2],\"e\":{}}")));
+	UON_CHECK_EQUAL(uon::write_json(merged, true), "{\"a\":1,\"b\":{\"w\":2,\"x\":1,\"y\":3},\"c\":null,\"d\":[1,2],\"e\":{}}");
+
+	merged.merge(uon::read_json(std::string("{\"0\":0,\"bb\":{\"z\":true}}")));
+	UON_CHECK_EQUAL(uon::write_json(merged, true), "{\"0\":0,\"a\":1,\"b\":{\"w\":2,\"x\":1,\"y\":3},\"bb\":{\"z\":true},\"c\":null,\"d\":[1,2],\"e\":{}}");
+
+	// renamed members replace existing ones with the same key
+	auto escaped = uon::read_json(std::string("{\"a.b\":1,\"a\xEF\xBC\x8E" "b\":2,\"$c\":{\"d.e\":3},\"f\":4}"));
+	escaped.escape_mongo();
+	UON_CHECK_EQUAL(uon::write_json(escaped, true), "{\"a\xEF\xBC\x8E" "b\":1,\"f\":4,\"\xEF\xBC\x84" "c\":{\"d\xEF\xBC\x8E" "e\":3}}");
+	escaped.unescape_mongo();
+	UON_CHECK_EQUAL(uon::write_json(escaped, true), "{\"$c\":{\"d.e\":3},\"a.b\":1,\"f\":4}");
+
+	// wide objects are renamed and merged in one pass, not quadratically
+	uon::Object::container_type members;
+	uon::Object::container_type overlay;
+
+	for(int i = 0; i < 200000; ++i)
+	{
+		auto key = "key" + std::to_string(i);
+		members.push_back(uon::Object::value_type(i % 2 ? key : "$" + key, uon::Value(static_cast<std::int64_t>(i))));
+		overlay.push_back(uon::Object::value_type(key + "_", uon::Value(static_cast<std::int64_t>(i))));
+	}
+
+	uon::Value wide = uon::Object(members);
+	auto original = wide;
+	auto start = std::chrono::steady_clock::now();
+
+	wide.escape_mongo();
+	UON_CHECK_EQUAL(wide.as_object().size(), 200000u);
+	UON_CHECK(wide.find(std::vector<std::string>{ "\xEF\xBC\x84key0" }) != nullptr);
+	wide.unescape_mongo();
+	UON_CHECK(wide == original);
+
+	wide.merge(uon::Value(uon::Object(overlay)));
+	UON_CHECK_EQUAL(wide.as_object().size(), 400000u);
+	UON_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+}
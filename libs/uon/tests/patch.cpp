@@ -0,0 +1,212 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <random>
+
+namespace {
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	// the empty key last, mongo has no field for it
+	const char* const keys[] = { "a", "b", "c", "d/e", "f~g", "" };
+
+	// small values over few keys and scalars, so that random pairs share
+	// much of their structure
+	uon::Value random_value(std::mt19937& random, int depth, std::size_t key_count)
+	{
+		static const char* const scalars[] = { "null", "true", "false", "0", "1", "-1", "2.5", "\"x\"", "\"y\"" };
+
+		auto kind = random() % (depth > 0 ? 4 : 2);
+
+		if(kind < 2)
+		{
+			return parse(scalars[random() % (sizeof(scalars) / sizeof(scalars[0]))]);
+		}
+
+		uon::Value value(kind == 2 ? uon::Value(uon::Object()) : uon::Value(uon::Array()));
+		auto size = random() % 4;
+
+		for(std::size_t i = 0; i < size; ++i)
+		{
+			if(kind == 2)
+				value.set(uon::Path{ keys[random() % key_count] }, random_value(random, depth - 1, key_count));
+			else
+				value.push_back(random_value(random, depth - 1, key_count));
+		}
+
+		return value;
+	}
+
+	// a random edit of some of the values in value
+	uon::Value mutate(std::mt19937& random, const uon::Value& value, int depth, std::size_t key_count)
+	{
+		if(random() % 4 == 0)
+		{
+			return random_value(random, depth, key_count);
+		}
+
+		uon::Value result = value;
+
+		if(value.is_object())
+		{
+			for(auto& member : value.as_object())
+			{
+				result.set(uon::Path{ member.first.str() }, mutate(random, member.second, depth - 1, key_count));
+			}
+		}
+		else
+		if(value.is_array())
+		{
+			uon::Array array;
+
+			for(auto& element : value.as_array())
+			{
+				array.push_back(mutate(random, element, depth - 1, key_count));
+			}
+
+			result = uon::Value(std::move(array));
+		}
+
+		return result;
+	}
+
+	// what mongo does with the update, for fields as to_mongo_update
+	// writes them
+	void apply_mongo_update(uon::Value& document, const uon::Value& update)
+	{
+		// an empty patch gives no update at all
+		if(update.is_null())
+		{
+			return;
+		}
+
+		for(auto& group : update.as_object())
+		{
+			for(auto& field : group.second.as_object())
+			{
+				std::vector<std::string> segments(1);
+
+				for(auto c : field.first.str())
+				{
+					if(c == '.')
+						segments.emplace_back();
+					else
+						segments.back() += c;
+				}
+
+				auto key = segments.back();
+				segments.pop_back();
+
+				auto parent = document.find(uon::Path(segments));
+				UON_CHECK(parent != nullptr);
+
+				if(parent == nullptr)
+				{
+					continue;
+				}
+
+				if(parent->is_array())
+				{
+					auto array = parent->as_array();
+					array[std::stoul(key)] = field.second;
+					*parent = std::move(array);
+				}
+				else
+				{
+					auto object = parent->as_object();
+
+					if(group.first.str() == "$set")
+						object[key] = field.second;
+					else
+						object.erase(key);
+
+					*parent = std::move(object);
+				}
+			}
+		}
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(patch)
+{
+	auto from = parse("{\"a\":1,\"b\":[1,2],\"c\":{\"d\":true},\"k/~\":0,\"l\":[1]}");
+	auto to = parse("{\"a\":2,\"b\":[1,3],\"c\":{},\"e\":null,\"k/~\":0,\"l\":[1,2]}");
+
+	// members in key order, arrays of equal length element by element,
+	// keys escaped as in json pointers
+	UON_CHECK_EQUAL(uon::write_json(uon::diff(from, to), true),
+		"[{\"op\":\"replace\",\"path\":\"/a\",\"value\":2},"
+		"{\"op\":\"replace\",\"path\":\"/b/1\",\"value\":3},"
+		"{\"op\":\"remove\",\"path\":\"/c/d\"},"
+		"{\"op\":\"add\",\"path\":\"/e\",\"value\":null},"
+		"{\"op\":\"replace\",\"path\":\"/l\",\"value\":[1,2]}]");
+
+	UON_CHECK_EQUAL(uon::write_json(uon::diff(parse("{\"k/~\":0}"), parse("{\"k/~\":1}")), true),
+		"[{\"op\":\"replace\",\"path\":\"/k~1~0\",\"value\":1}]");
+
+	UON_CHECK(uon::diff(from, from).as_array().empty());
+	UON_CHECK(uon::diff(from, from.copy()).as_array().empty());
+	UON_CHECK_EQUAL(uon::write_json(uon::diff(from, uon::Value(1.0)), true), "[{\"op\":\"replace\",\"path\":\"\",\"value\":1.0}]");
+
+	auto patched = from;
+	uon::apply_patch(patched, uon::diff(from, to));
+	UON_CHECK(patched == to);
+	UON_CHECK(from == parse("{\"a\":1,\"b\":[1,2],\"c\":{\"d\":true},\"k/~\":0,\"l\":[1]}"));
+
+	UON_CHECK_EQUAL(uon::write_json(uon::to_mongo_update(uon::diff(from, to), "doc"), true),
+		"{\"$set\":{\"doc.a\":2,\"doc.b.1\":3,\"doc.e\":null,\"doc.l\":[1,2]},\"$unset\":{\"doc.c.d\":\"\"}}");
+
+	// operations diff does not produce
+	auto target = parse("{\"a\":[1,2],\"b\":{}}");
+	uon::apply_patch(target, parse(
+		"[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":3},"
+		"{\"op\":\"add\",\"path\":\"/a/0\",\"value\":0},"
+		"{\"op\":\"remove\",\"path\":\"/a/1\"},"
+		"{\"op\":\"add\",\"path\":\"/b/c~1d\",\"value\":{}}]"));
+	UON_CHECK(target == parse("{\"a\":[0,2,3],\"b\":{\"c/d\":{}}}"));
+
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"remove\",\"path\":\"/x\"}]")), uon::NotFound);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"replace\",\"path\":\"/x/y\",\"value\":1}]")), uon::NotFound);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"replace\",\"path\":\"/a/3\",\"value\":1}]")), uon::NotFound);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"replace\",\"path\":\"/a/01\",\"value\":1}]")), uon::NotFound);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"add\",\"path\":\"/a/0/b\",\"value\":1}]")), uon::NotFound);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"add\",\"path\":\"a\",\"value\":1}]")), std::runtime_error);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"add\",\"path\":\"/~2\",\"value\":1}]")), std::runtime_error);
+	UON_CHECK_THROWS(uon::apply_patch(target, parse("[{\"op\":\"move\",\"from\":\"/a\",\"path\":\"/c\"}]")), std::runtime_error);
+	UON_CHECK(target == parse("{\"a\":[0,2,3],\"b\":{\"c/d\":{}}}"));
+
+	UON_CHECK_THROWS(uon::to_mongo_update(parse("[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":3}]")), std::runtime_error);
+	UON_CHECK_THROWS(uon::to_mongo_update(uon::diff(uon::Value(1.0), uon::Value(2.0))), std::runtime_error);
+
+	// random pairs: the patch turns one into the other, directly and as a
+	// mongo update; keys with dots or dollars would need escaping first
+	std::mt19937 random(17);
+
+	for(int i = 0; i < 20000; ++i)
+	{
+		bool mongo = (i % 4 < 2);
+		auto key_count = sizeof(keys) / sizeof(keys[0]) - (mongo ? 1 : 0);
+
+		auto a = random_value(random, 4, key_count);
+		auto b = (i % 2 == 0) ? mutate(random, a, 4, key_count) : random_value(random, 4, key_count);
+		auto patch = uon::diff(a, b);
+
+		auto result = a;
+		uon::apply_patch(result, patch);
+		UON_CHECK(result == b);
+
+		if(!mongo || !a.is_object() || !b.is_object())
+		{
+			continue;
+		}
+
+		auto document = a;
+		apply_mongo_update(document, uon::to_mongo_update(patch));
+		UON_CHECK(document == b);
+	}
+}
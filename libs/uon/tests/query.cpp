@@ -0,0 +1,230 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <random>
+#include <tuple>
+
+namespace {
+
+	// a host report of cmake and googletest tasks as birch consolidates it,
+	// with results of every type and tests with every result
+	uon::Value sample_report(unsigned int seed)
+	{
+		std::mt19937 random(seed);
+		auto pick = [&random](std::size_t n) { return static_cast<std::size_t>(random() % n); };
+
+		const char* const types[] = { "warning", "error", "note", "Error", "" };
+		const char* const results[] = { "Ok", "Error", "error", "Skipped" };
+
+		uon::Object tasks;
+
+		for(std::size_t t = 0; t < 6; ++t)
+		{
+			uon::Object task;
+
+			if(t % 2 == 0)
+			{
+				task["type"] = "build:cmake";
+				uon::Array details;
+
+				for(std::size_t i = pick(40); i > 0; --i)
+				{
+					uon::Object result{ { "message", "result " + std::to_string(i) }, { "line", static_cast<std::uint64_t>(i) } };
+
+					// some results have no type or a type that is not a string
+					switch(pick(7))
+					{
+						case 5: break;
+						case 6: result["type"] = static_cast<std::uint64_t>(i); break;
+						default: result["type"] = types[pick(5)];
+					}
+
+					details.push_back(uon::Value(std::move(result)));
+				}
+
+				task["details"] = std::move(details);
+			}
+			else
+			{
+				task["type"] = "test:googletest";
+				uon::Object testsuites;
+
+				for(std::size_t s = pick(5); s > 0; --s)
+				{
+					uon::Object testsuite;
+
+					for(std::size_t i = pick(12); i > 0; --i)
+					{
+						uon::Object test{
+							{ "name", "test" + std::to_string(i) },
+							{ "status", pick(2) ? "run" : "notrun" },
+							{ "message", pick(3) ? "" : "failure " + std::to_string(i) }
+						};
+
+						if(pick(6))
+						{
+							test["result"] = results[pick(4)];
+						}
+
+						testsuite["test" + std::to_string(i)] = std::move(test);
+					}
+
+					testsuites["suite" + std::to_string(s)] = std::move(testsuite);
+				}
+
+				task["details"] = uon::Object{ { "tests", std::move(testsuites) } };
+			}
+
+			tasks["task" + std::to_string(t)] = std::move(task);
+		}
+
+		return uon::Object{ { "tasks", std::move(tasks) } };
+	}
+
+	// the traversals consolidation and the formatter used before queries
+
+	std::size_t count_type(const uon::Value& task, const std::string& type)
+	{
+		std::size_t count = 0;
+
+		for(auto& i : uon::ArrayView(task.find("details")))
+		{
+			if(i.get("type", uon::null).to_string() == type)
+			{
+				count += 1;
+			}
+		}
+
+		return count;
+	}
+
+	using Test = std::tuple<std::string, std::string, uon::Value>;
+
+	std::vector<Test> tests(const uon::Value& task)
+	{
+		std::vector<Test> tests;
+
+		for(auto& testsuite : uon::ObjectView(task.find("details.tests")))
+		{
+			for(auto& test : testsuite.second.object_view())
+			{
+				tests.emplace_back(testsuite.first.str(), test.first.str(), test.second);
+			}
+		}
+
+		return tests;
+	}
+
+	std::size_t count_failed(const uon::Value& task)
+	{
+		std::size_t errors = 0;
+
+		for(auto& testsuite : uon::ObjectView(task.find("details")))
+		{
+			for(auto& test : testsuite.second.object_view())
+			{
+				if(test.second.get("result", uon::null) == "Error")
+				{
+					errors += 1;
+				}
+			}
+		}
+
+		return errors;
+	}
+
+	std::vector<Test> query_tests(const uon::Query& query, const uon::Value& task)
+	{
+		std::vector<Test> tests;
+
+		query.for_each(task, [&tests](const uon::Value& test, const uon::VisitPath& path)
+		{
+			tests.emplace_back(*path[2].key, *path[3].key, test);
+			return uon::Visit::next;
+		});
+
+		return tests;
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(query)
+{
+	// the queries of birch's consolidation, against the old traversals
+	const uon::Query warnings("details.*[type=warning]");
+	const uon::Query errors("details.*[type=error]");
+	const uon::Query googletests("details.tests.*.*");
+	const uon::Query failed_tests("details.*.*[result=Error]");
+
+	for(unsigned int seed = 0; seed < 50; ++seed)
+	{
+		auto report = sample_report(seed);
+
+		for(auto& task : report.as_object().find(uon::Key("tasks"))->second.as_object())
+		{
+			UON_CHECK_EQUAL(warnings.count(task.second), count_type(task.second, "warning"));
+			UON_CHECK_EQUAL(errors.count(task.second), count_type(task.second, "error"));
+
+			auto expected = tests(task.second);
+			UON_CHECK(query_tests(googletests, task.second) == expected);
+
+			// consolidated googletest details are details.<testsuite>.<test>
+			uon::Value consolidated = uon::Object{ { "details", task.second.get("details.tests", uon::Object()) } };
+			UON_CHECK_EQUAL(failed_tests.count(consolidated), count_failed(consolidated));
+
+			// select() returns the same matches in the same order
+			auto selected = googletests.select(task.second);
+			UON_CHECK_EQUAL(selected.as_array().size(), expected.size());
+
+			for(std::size_t i = 0; i < expected.size() && i < selected.as_array().size(); ++i)
+			{
+				UON_CHECK(selected.as_array()[i] == std::get<2>(expected[i]));
+			}
+		}
+	}
+
+	auto report = uon::read_json(std::string(
+		"{\"hosts\":[{\"name\":\"a\",\"ok\":true,\"tasks\":[{\"id\":1,\"result\":\"Ok\"},{\"id\":2,\"result\":\"Error\",\"details\":{\"line\":3}}]},"
+		"{\"name\":\"b\",\"ok\":false,\"tasks\":[{\"id\":3},{\"id\":4,\"result\":\"Ok\"}]},"
+		"{\"name\":\"c\",\"tasks\":{}}]}"));
+
+	// indices, negation, existence and json literals
+	UON_CHECK(uon::Query("hosts.1.name").select(report) == uon::read_json(std::string("[\"b\"]")));
+	UON_CHECK_EQUAL(uon::Query("hosts.3.name").count(report), 0u);
+	UON_CHECK_EQUAL(uon::Query("hosts.x").count(report), 0u);
+	UON_CHECK(uon::Query("hosts.*.tasks.*[result!=Ok].id").select(report) == uon::read_json(std::string("[2,3]")));
+	UON_CHECK(uon::Query("hosts.*.tasks.*[details.line=3].id").select(report) == uon::read_json(std::string("[2]")));
+	UON_CHECK(uon::Query("hosts.*.tasks.*[details].id").select(report) == uon::read_json(std::string("[2]")));
+	UON_CHECK(uon::Query("hosts.*[ok=false].name").select(report) == uon::read_json(std::string("[\"b\"]")));
+	UON_CHECK_EQUAL(uon::Query("hosts.*[ok].name").count(report), 2u);
+	UON_CHECK(uon::Query("hosts.*.tasks.*[id=4][result=Ok].id").select(report) == uon::read_json(std::string("[4]")));
+	UON_CHECK_EQUAL(uon::Query("hosts.*[name=a b].name").count(report), 0u);
+	UON_CHECK_EQUAL(uon::Query("hosts.*.name.*").count(report), 0u);
+
+	// projection keeps only the listed keys that exist
+	UON_CHECK(uon::Query("hosts.*.tasks.*.{id,result}").select(report) ==
+		uon::read_json(std::string("[{\"id\":1,\"result\":\"Ok\"},{\"id\":2,\"result\":\"Error\"},{\"id\":3},{\"id\":4,\"result\":\"Ok\"}]")));
+
+	// the visitor ends the walk early and gets the path of each match
+	std::vector<std::string> paths;
+
+	UON_CHECK(!uon::Query("hosts.*.tasks.*").for_each(report, [&paths](const uon::Value&, const uon::VisitPath& path)
+	{
+		paths.push_back(path.to_string());
+		return paths.size() == 3 ? uon::Visit::stop : uon::Visit::next;
+	}));
+
+	UON_CHECK_EQUAL(paths.size(), 3u);
+	UON_CHECK(uon::Query("hosts.*.tasks.*").select(report).as_array()[2] == report.get(paths[2]));
+
+	UON_CHECK_EQUAL(uon::Query("a.*[b!=1].{c,d}").to_string(), "a.*[b!=1].{c,d}");
+
+	UON_CHECK_THROWS(uon::Query("a..b"), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a."), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a[b=1"), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a[=1]"), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a.{b,}"), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a.{b"), std::runtime_error);
+	UON_CHECK_THROWS(uon::Query("a.{b}.c"), std::runtime_error);
+}
@@ -0,0 +1,168 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+	// the chunk size of the stream reader
+	const std::size_t chunk = 64 * 1024;
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	uon::Value read_stream(const std::string& json)
+	{
+		std::istringstream input(json);
+		return uon::read_json(input);
+	}
+
+	std::size_t error_offset(const std::string& json, bool stream)
+	{
+		try
+		{
+			if(stream)
+				read_stream(json);
+			else
+				parse(json);
+		}
+		catch(const uon::ParseError& e)
+		{
+			return e.offset();
+		}
+
+		return std::string::npos;
+	}
+
+	// records the deepest nesting of the events
+	struct Depth : uon::Handler
+	{
+		std::size_t current = 0;
+		std::size_t deepest = 0;
+
+		void null() override { }
+		void boolean(uon::Boolean) override { }
+		void integer(uon::Integer) override { }
+		void unsigned_integer(uon::Unsigned) override { }
+		void real(uon::Real) override { }
+		void string(const char*, std::size_t) override { }
+
+		void begin_object() override { begin(); }
+		void key(const char*, std::size_t) override { }
+		void end_object() override { --current; }
+
+		void begin_array() override { begin(); }
+		void end_array() override { --current; }
+
+		void begin()
+		{
+			deepest = std::max(deepest, ++current);
+		}
+	};
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(reader_json)
+{
+	// numbers keep their kind while they fit it
+	UON_CHECK(parse("-9223372036854775808").number_kind() == uon::NumberKind::integer);
+	UON_CHECK_EQUAL(parse("-9223372036854775808").as_integer(), INT64_MIN);
+	UON_CHECK(parse("9223372036854775807").number_kind() == uon::NumberKind::integer);
+	UON_CHECK(parse("9223372036854775808").number_kind() == uon::NumberKind::unsigned_integer);
+	UON_CHECK_EQUAL(parse("18446744073709551615").as_unsigned(), UINT64_MAX);
+	UON_CHECK(parse("1.0").number_kind() == uon::NumberKind::real);
+	UON_CHECK(parse("1e2").number_kind() == uon::NumberKind::real);
+
+	// and fall back to real beyond 64 bits
+	UON_CHECK(parse("18446744073709551616").number_kind() == uon::NumberKind::real);
+	UON_CHECK_EQUAL(parse("18446744073709551616").as_real(), 18446744073709551616.0);
+	UON_CHECK(parse("-9223372036854775809").number_kind() == uon::NumberKind::real);
+	UON_CHECK_EQUAL(parse("-9223372036854775809").as_real(), -9223372036854775808.0);
+	UON_CHECK(parse("123456789012345678901234567890").number_kind() == uon::NumberKind::real);
+
+	// escapes, surrogate pairs and lone low surrogates
+	UON_CHECK_EQUAL(parse("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"").as_string(), "\"\\/\b\f\n\r\t");
+	UON_CHECK_EQUAL(parse("\"\\u0041\\u00e9\\u20AC\"").as_string(), "A\xC3\xA9\xE2\x82\xAC");
+	UON_CHECK_EQUAL(parse("\"\\uD83D\\uDE00\"").as_string(), "\xF0\x9F\x98\x80");
+	UON_CHECK_EQUAL(parse("\"\\uDBFF\\uDFFF\"").as_string(), "\xF4\x8F\xBF\xBF");
+	UON_CHECK_EQUAL(parse("\"a\\uDC00b\"").as_string(), "a\xEF\xBF\xBD" "b");
+	UON_CHECK_EQUAL(parse("\"\\uDFFF\"").as_string(), "\xEF\xBF\xBD");
+	UON_CHECK_THROWS(parse("\"\\uD800\""), uon::ParseError);
+	UON_CHECK_THROWS(parse("\"\\uD800x\""), uon::ParseError);
+	UON_CHECK_THROWS(parse("\"\\uD800\\u0041\""), uon::ParseError);
+	UON_CHECK_THROWS(parse("\"\\u12G4\""), uon::ParseError);
+	UON_CHECK_THROWS(parse("\"\\x\""), uon::ParseError);
+
+	// strings, escapes and numbers split at every position across a chunk
+	// boundary of the stream reader read the same as from memory
+	const std::string tokens[] = {
+		"\"plain text\"",
+		"\"a\\uD83D\\uDE00\\n\\\"b\"",
+		"\"\\u00e9\\\\\"",
+		"-12345.678e-9",
+		"18446744073709551616",
+	};
+
+	for(auto& token : tokens)
+	{
+		auto expected = parse("[" + token + "]");
+
+		for(std::size_t shift = 0; shift <= token.size() + 1; ++shift)
+		{
+			auto json = "[" + std::string(chunk - shift, ' ') + token + "]";
+
+			UON_CHECK(read_stream(json) == expected);
+			UON_CHECK(parse(json) == expected);
+		}
+	}
+
+	// a string longer than a chunk
+	auto long_string = std::string(3 * chunk, 'x') + "\\u00e9" + std::string(chunk, 'y');
+	UON_CHECK_EQUAL(read_stream("\"" + long_string + "\"").as_string().size(), 4 * chunk + 2);
+
+	// errors point at the first byte that is not accepted, from memory as
+	// from a stream
+	struct Error
+	{
+		std::string json;
+		std::size_t offset;
+	};
+
+	const Error errors[] = {
+		{ "", 0 },
+		{ "[1,]", 3 },
+		{ "[1 2]", 3 },
+		{ "{\"a\" 1}", 5 },
+		{ "{\"a\":1,}", 7 },
+		{ "{1:2}", 1 },
+		{ "tru", 3 },
+		{ "nul1", 3 },
+		{ "[1] x", 4 },
+		{ "\"abc", 4 },
+		{ "\"\\x\"", 2 },
+		{ "\"\\u12G4\"", 5 },
+		{ "\"\\uD800\\u0041\"", 9 },
+		{ "\"\\uD800x\"", 7 },
+		{ "-", 1 },
+		{ "1.", 2 },
+		{ "1e+", 3 },
+		{ std::string(chunk + 10, ' ') + "x", chunk + 10 },
+		{ "[\"" + std::string(chunk, 'x') + "\\q\"]", chunk + 3 },
+	};
+
+	for(auto& error : errors)
+	{
+		UON_CHECK_EQUAL(error_offset(error.json, false), error.offset);
+		UON_CHECK_EQUAL(error_offset(error.json, true), error.offset);
+	}
+
+	// nesting is not limited by the call stack of the parser
+	Depth depth;
+	std::string nested = std::string(100000, '[') + std::string(100000, ']');
+	uon::read_json(nested.data(), nested.size(), depth);
+	UON_CHECK_EQUAL(depth.deepest, 100000u);
+}
@@ -0,0 +1,183 @@
+#include "check.hpp"
+
+#include <uon/utf8.hpp>
+
+#include <random>
+
+namespace {
+
+	// The byte at a time rules the vectorized kernel replaced: the length
+	// of the character at i that is kept, 0 if it is dropped.
+	std::size_t reference_kept_length(const std::string& value, std::size_t i)
+	{
+		auto c = static_cast<unsigned char>(value[i]);
+		auto remaining = value.size() - i - 1;
+		auto continuation = [&](std::size_t k) { return (static_cast<unsigned char>(value[i + k]) & 0xC0) == 0x80; };
+
+		if(c < 0x80)
+			return ((c >= 0x20 && c != 0x7F) || c == '\b' || c == '\f' || c == '\n' || c == '\r' || c == '\t') ? 1 : 0;
+
+		if((c & 0xE0) == 0xC0 && remaining >= 1 && continuation(1))
+			return 2;
+
+		if((c & 0xF0) == 0xE0 && remaining >= 2 && continuation(1) && continuation(2))
+			return 3;
+
+		if((c & 0xF8) == 0xF0 && remaining >= 3 && continuation(1) && continuation(2) && continuation(3))
+			return 4;
+
+		return 0;
+	}
+
+	std::size_t reference_valid_prefix(const std::string& value)
+	{
+		std::size_t i = 0;
+
+		while(i < value.size())
+		{
+			auto kept = reference_kept_length(value, i);
+
+			if(kept == 0)
+			{
+				break;
+			}
+
+			i += kept;
+		}
+
+		return i;
+	}
+
+	// a dropped ASCII byte is skipped alone, anything else with all
+	// directly following non-ASCII bytes
+	std::string reference_remove_illegal_chars(const std::string& value)
+	{
+		std::string result;
+
+		for(std::size_t i = 0; i < value.size();)
+		{
+			auto kept = reference_kept_length(value, i);
+
+			if(kept > 0)
+			{
+				result.append(value, i, kept);
+				i += kept;
+			}
+			else
+			if((static_cast<unsigned char>(value[i]) & 0x80) == 0)
+			{
+				i += 1;
+			}
+			else
+			{
+				while(i < value.size() && (static_cast<unsigned char>(value[i]) & 0x80) != 0)
+				{
+					i += 1;
+				}
+			}
+		}
+
+		return result;
+	}
+
+	std::size_t compared = 0;
+
+	void compare(const std::string& value)
+	{
+		UON_CHECK_EQUAL(uon::utf8_valid_prefix(value.data(), value.size()), reference_valid_prefix(value));
+		UON_CHECK(uon::utf8_remove_illegal_chars(value) == reference_remove_illegal_chars(value));
+		++compared;
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(utf8)
+{
+	// the structure of sequences is checked, not their values: overlong
+	// forms, surrogates and code points above U+10FFFF are kept
+	const std::string sequences[] = {
+		"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80",
+		"\x80", "\xBF", "\x80\x80\x80",
+		"\xC0\xAF", "\xC1\xBF", "\xE0\x80\xAF", "\xF0\x80\x80\xAF",
+		"\xED\xA0\x80", "\xED\xBF\xBF", "\xF4\x90\x80\x80", "\xF7\xBF\xBF\xBF",
+		"\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xC3" "A", "\xE2\x82" "A", "\xF0\x9F\x98" "A",
+		"\xF8\x88\x80\x80\x80", "\xFE", "\xFF",
+		std::string(1, '\0'), "\x01", "\x1F", "\x7F", "\b", "\f", "\n", "\r", "\t",
+	};
+
+	for(auto& sequence : sequences)
+	{
+		compare(sequence);
+	}
+
+	UON_CHECK_EQUAL(uon::utf8_remove_illegal_chars("a\xC3\xA9\x01" "b\x80\x80" "c\xC3"), "a\xC3\xA9" "bc");
+
+	// every sequence at every offset across two vector widths, within
+	// printable text and within valid multibyte text, so they straddle 16
+	// and 32 byte boundaries
+	const std::string fillers[] = { "a", "\xC3\xA9" };
+
+	for(auto& filler : fillers)
+	{
+		for(auto& sequence : sequences)
+		{
+			for(std::size_t offset = 0; offset <= 66; ++offset)
+			{
+				std::string text;
+
+				while(text.size() < offset)
+				{
+					text += filler;
+				}
+
+				auto prefix = text.size();
+				text += sequence;
+
+				for(std::size_t tail = 0; tail < 40; tail += 13)
+				{
+					compare(text + std::string(tail, 'z'));
+				}
+
+				compare(text.substr(0, prefix) + sequence + text.substr(0, prefix));
+			}
+		}
+	}
+
+	// lengths around the vector widths
+	for(std::size_t length = 0; length <= 100; ++length)
+	{
+		compare(std::string(length, 'x'));
+		compare(std::string(length, 'x') + "\x80");
+		compare("\x80" + std::string(length, 'x'));
+	}
+
+	// random text, mostly printable ASCII with all other bytes mixed in
+	std::mt19937 random(20261017);
+	std::uniform_int_distribution<int> byte(0, 255);
+	std::uniform_int_distribution<int> printable(0x20, 0x7E);
+	std::uniform_int_distribution<int> kind(0, 99);
+	std::uniform_int_distribution<std::size_t> length(0, 200);
+
+	for(int i = 0; i < 200000; ++i)
+	{
+		std::string text;
+		auto size = length(random);
+
+		while(text.size() < size)
+		{
+			auto k = kind(random);
+
+			if(k < 80)
+				text += static_cast<char>(printable(random));
+			else
+			if(k < 90)
+				text += sequences[random() % (sizeof(sequences) / sizeof(sequences[0]))];
+			else
+				text += static_cast<char>(byte(random));
+		}
+
+		compare(text);
+	}
+
+	UON_CHECK(compared > 200000);
+}
@@ -0,0 +1,115 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	std::string compact(const uon::Value& value)
+	{
+		return uon::write_json(value, true);
+	}
+
+	std::string pretty(const uon::Value& value)
+	{
+		return uon::write_json(value);
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(writer_json)
+{
+	auto document = parse(
+		"{\"b\":[1,-2,18446744073709551615,1.5,2.0,true,false,null,[],{}],"
+		"\"a\":{\"x\":\"q\\\"\\\\\\n/\\u00e9\"},"
+		"\"e\":[[1],{\"k\":[1,\"two\"]}]}");
+
+	// compact output has no whitespace, members are ordered by key
+	UON_CHECK_EQUAL(compact(document),
+		"{\"a\":{\"x\":\"q\\\"\\\\\\n/\xC3\xA9\"},"
+		"\"b\":[1,-2,18446744073709551615,1.5,2.0,true,false,null,[],{}],"
+		"\"e\":[[1],{\"k\":[1,\"two\"]}]}");
+
+	// pretty output indents by four spaces, arrays without objects and
+	// arrays are kept on one line
+	UON_CHECK_EQUAL(pretty(document),
+		"{\n"
+		"    \"a\" : {\n"
+		"        \"x\" : \"q\\\"\\\\\\n/\xC3\xA9\"\n"
+		"    },\n"
+		"    \"b\" : [\n"
+		"        1,\n"
+		"        -2,\n"
+		"        18446744073709551615,\n"
+		"        1.5,\n"
+		"        2.0,\n"
+		"        true,\n"
+		"        false,\n"
+		"        null,\n"
+		"        [ ],\n"
+		"        {\n"
+		"        }\n"
+		"    ],\n"
+		"    \"e\" : [\n"
+		"        [ 1 ],\n"
+		"        {\n"
+		"            \"k\" : [ 1, \"two\" ]\n"
+		"        }\n"
+		"    ]\n"
+		"}");
+
+	UON_CHECK_EQUAL(pretty(uon::Value()), "null");
+	UON_CHECK_EQUAL(pretty(uon::Value(uon::Array())), "[ ]");
+	UON_CHECK_EQUAL(pretty(uon::Value(uon::Object())), "{\n}");
+	UON_CHECK_EQUAL(compact(uon::Value(uon::Array())), "[]");
+	UON_CHECK_EQUAL(compact(uon::Value(uon::Object())), "{}");
+
+	// the stream overload writes the same
+	std::ostringstream stream;
+	uon::write_json(document, stream);
+	UON_CHECK_EQUAL(stream.str(), pretty(document));
+
+	// integers of all kinds are exact, reals keep a fraction or exponent
+	// so they are read back as reals, non-finite reals become null
+	UON_CHECK_EQUAL(compact(uon::Value(std::numeric_limits<std::int64_t>::min())), "-9223372036854775808");
+	UON_CHECK_EQUAL(compact(uon::Value(std::numeric_limits<std::uint64_t>::max())), "18446744073709551615");
+	UON_CHECK_EQUAL(compact(uon::Value(3.0)), "3.0");
+	UON_CHECK_EQUAL(compact(uon::Value(-0.0)), "-0.0");
+	UON_CHECK_EQUAL(compact(uon::Value(0.1)), "0.1");
+	UON_CHECK_EQUAL(compact(uon::Value(1e300)), "1e+300");
+	UON_CHECK_EQUAL(compact(uon::Value(std::numeric_limits<double>::infinity())), "null");
+	UON_CHECK_EQUAL(compact(uon::Value(std::nan(""))), "null");
+
+	const double reals[] = { 0.30000000000000004, 5e-324, 1.7976931348623157e308, -2.5e-10, 123456789.125 };
+
+	for(auto real : reals)
+	{
+		auto written = parse(compact(uon::Value(real)));
+		UON_CHECK(written.number_kind() == uon::NumberKind::real);
+		UON_CHECK_EQUAL(written.as_real(), real);
+	}
+
+	// quotes, backslashes and the allowed control characters are escaped,
+	// other control characters and broken UTF-8 are dropped
+	UON_CHECK_EQUAL(compact(uon::Value("\"\\\b\f\n\r\t/")), "\"\\\"\\\\\\b\\f\\n\\r\\t/\"");
+	UON_CHECK_EQUAL(compact(uon::Value("a\x01" "b\x7F" "c")), "\"abc\"");
+	UON_CHECK_EQUAL(compact(uon::Value("a\xFF" "b\xC3")), "\"ab\"");
+	UON_CHECK_EQUAL(compact(uon::Value("\xE2\x82\xAC \xF0\x9F\x98\x80")), "\"\xE2\x82\xAC \xF0\x9F\x98\x80\"");
+
+	// keys are written like strings
+	uon::Value keys;
+	keys.set(uon::Path{ "a\"b\n" }, uon::Value(true));
+	UON_CHECK_EQUAL(compact(keys), "{\"a\\\"b\\n\":true}");
+
+	// what is written reads back to the same value
+	UON_CHECK(parse(compact(document)) == document);
+	UON_CHECK(parse(pretty(document)) == document);
+}
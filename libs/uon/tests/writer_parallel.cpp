@@ -0,0 +1,141 @@
+#include "check.hpp"
+
+#include <uon/uon.hpp>
+
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+	// a value of about size output bytes with large arrays and objects
+	// of every kind the writer may split
+	uon::Value large_value(std::mt19937& random, std::size_t size, int depth)
+	{
+		auto kind = depth > 0 ? random() % 5 : 4;
+
+		if(kind == 4 || size < 16)
+		{
+			switch(random() % 6)
+			{
+				case 0: return uon::Value(static_cast<std::int64_t>(random()) - 0x7FFFFFFF);
+				case 1: return uon::Value(static_cast<double>(random()) / 7.0);
+				case 2: return uon::Value(random() % 2 == 0);
+				case 3: return uon::Value();
+				case 4: return uon::Value(std::string(random() % 40, 'a' + random() % 26));
+				default: return uon::Value("broken \x01 \xC3 and \xE2\x82\xAC and \"quoted\"");
+			}
+		}
+
+		auto count = 1 + random() % 200;
+		auto part = size / count;
+
+		if(kind < 2)
+		{
+			uon::Array array;
+
+			for(std::size_t i = 0; i < count; ++i)
+			{
+				array.push_back(large_value(random, part, depth - 1));
+			}
+
+			return uon::Value(std::move(array));
+		}
+
+		uon::Value object(uon::Object{});
+
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			object.set(uon::Path{ "key" + std::to_string(random() % 1000) }, large_value(random, part, depth - 1));
+		}
+
+		return object;
+	}
+
+	void compare(const uon::Value& value)
+	{
+		const unsigned int threads[] = { 0, 1, 2, 3, 4, 7, 16 };
+
+		for(auto compact : { false, true })
+		{
+			auto serial = uon::write_json(value, compact);
+
+			for(auto count : threads)
+			{
+				UON_CHECK(uon::write_json_parallel(value, compact, count) == serial);
+			}
+
+			std::ostringstream stream;
+			uon::write_json_parallel(value, stream, compact, 4);
+			UON_CHECK(stream.str() == serial);
+		}
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(writer_parallel)
+{
+	// small values are written by the serial writer
+	compare(uon::read_json(std::string("{\"a\":[1,2,{\"b\":null}],\"c\":\"d\"}")));
+	compare(uon::Value());
+
+	// a large array of scalars, written on one line in pretty output
+	uon::Array numbers;
+
+	for(std::int64_t i = 0; i < 30000; ++i)
+	{
+		numbers.push_back(uon::Value(i * 7919));
+	}
+
+	compare(uon::Value(numbers));
+
+	// a large object, and large containers nested in large containers
+	uon::Value object(uon::Object{});
+	uon::Array rows;
+
+	for(int i = 0; i < 5000; ++i)
+	{
+		object.set(uon::Path{ "member " + std::to_string(i) }, uon::Value("value " + std::to_string(i)));
+	}
+
+	for(int i = 0; i < 8; ++i)
+	{
+		uon::Value row;
+		row.set("numbers", uon::Value(numbers));
+		row.set("object", object);
+		row.set("empty", uon::Value(uon::Array()));
+		rows.push_back(std::move(row));
+	}
+
+	compare(object);
+
+	// the rows share their nodes, so the same containers appear at many
+	// places in the document
+	uon::Value report;
+	report.set("rows", uon::Value(std::move(rows)));
+	report.set("summary", "\xE2\x9C\x93 done");
+	compare(report);
+
+	// random shapes around and far above the split threshold
+	std::mt19937 random(19);
+
+	for(std::size_t size : { 5000, 20000, 60000 })
+	{
+		for(int i = 0; i < 4; ++i)
+		{
+			compare(large_value(random, size, 4));
+		}
+	}
+
+	// the file overload
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("uon-%%%%-%%%%.json");
+	uon::write_json_parallel(report, path, false, 4);
+
+	std::ifstream file(path.string(), std::ios::binary);
+	std::stringstream content;
+	content << file.rdbuf();
+	file.close();
+	boost::filesystem::remove(path);
+
+	UON_CHECK(content.str() == uon::write_json(report));
+}
@@ -1,5 +1,10 @@
 #pragma once
 
 #include "model.hpp"
+#include "number.hpp"
+#include "handler.hpp"
+#include "lazy.hpp"
+#include "patch.hpp"
+#include "query.hpp"
 #include "reader.hpp"
 #include "writer.hpp"
@@ -0,0 +1,203 @@
+#include "utf8.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UON_UTF8_SSE2
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace uon
+{
+
+namespace
+{
+	inline unsigned int first_bit(unsigned int mask)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	inline bool is_plain(unsigned char c)
+	{
+		return c >= 0x20 && c <= 0x7E;
+	}
+
+	inline bool is_continuation(unsigned char c)
+	{
+		return (c & 0xC0) == 0x80;
+	}
+
+	// number of leading printable ASCII bytes
+	std::size_t plain_run(const unsigned char* data, std::size_t length)
+	{
+		std::size_t i = 0;
+
+#if defined(__AVX2__)
+		{
+			// signed compare, so bytes >= 0x80 count as below 0x20 as well
+			const __m256i space = _mm256_set1_epi8(0x20);
+			const __m256i del = _mm256_set1_epi8(0x7F);
+
+			for(; i + 32 <= length; i += 32)
+			{
+				__m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+				__m256i special = _mm256_or_si256(_mm256_cmpgt_epi8(space, chunk), _mm256_cmpeq_epi8(chunk, del));
+				unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+
+				if(mask != 0)
+				{
+					return i + first_bit(mask);
+				}
+			}
+		}
+#endif
+
+#if defined(UON_UTF8_SSE2)
+		{
+			const __m128i space = _mm_set1_epi8(0x20);
+			const __m128i del = _mm_set1_epi8(0x7F);
+
+			for(; i + 16 <= length; i += 16)
+			{
+				__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+				__m128i special = _mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, del));
+				unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+
+				if(mask != 0)
+				{
+					return i + first_bit(mask);
+				}
+			}
+		}
+#endif
+
+		while(i < length && is_plain(data[i]))
+		{
+			++i;
+		}
+
+		return i;
+	}
+
+	// length of the character at data that is kept, 0 if it is dropped
+	std::size_t kept_length(const unsigned char* data, std::size_t length)
+	{
+		unsigned char c = data[0];
+		std::size_t remaining = length - 1;
+
+		if(c < 0x80)
+		{
+			switch(c)
+			{
+				case '\b':
+				case '\f':
+				case '\n':
+				case '\r':
+				case '\t':
+					return 1;
+			}
+
+			return is_plain(c) ? 1 : 0;
+		}
+
+		if( (c & 0xE0) == 0xC0 && remaining >= 1 && is_continuation(data[1]) )
+		{
+			return 2;
+		}
+
+		if( (c & 0xF0) == 0xE0 && remaining >= 2 && is_continuation(data[1]) && is_continuation(data[2]) )
+		{
+			return 3;
+		}
+
+		if( (c & 0xF8) == 0xF0 && remaining >= 3 && is_continuation(data[1]) && is_continuation(data[2]) && is_continuation(data[3]) )
+		{
+			return 4;
+		}
+
+		return 0;
+	}
+}
+
+std::size_t utf8_valid_prefix(const char* data, std::size_t length)
+{
+	auto bytes = reinterpret_cast<const unsigned char*>(data);
+	std::size_t i = 0;
+
+	for(;;)
+	{
+		i += plain_run(bytes + i, length - i);
+
+		if(i == length)
+		{
+			return i;
+		}
+
+		auto kept = kept_length(bytes + i, length - i);
+
+		if(kept == 0)
+		{
+			return i;
+		}
+
+		i += kept;
+	}
+}
+
+std::string utf8_remove_illegal_chars(const std::string& value)
+{
+	auto data = value.data();
+	auto length = value.length();
+	auto valid = utf8_valid_prefix(data, length);
+
+	if(valid == length)
+	{
+		return value;
+	}
+
+	std::string result;
+	result.reserve(length);
+
+	for(std::size_t i = 0;;)
+	{
+		result.append(data + i, valid);
+		i += valid;
+
+		if(i == length)
+		{
+			break;
+		}
+
+		// a dropped control character is skipped alone, anything else with
+		// all directly following non-ASCII bytes
+		if((static_cast<unsigned char>(data[i]) & 0x80) == 0)
+		{
+			i += 1;
+		}
+		else
+		{
+			while(i < length && (static_cast<unsigned char>(data[i]) & 0x80) != 0)
+			{
+				i += 1;
+			}
+		}
+
+		valid = utf8_valid_prefix(data + i, length - i);
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace uon
+{
+	// Length of the leading part of data that utf8_remove_illegal_chars
+	// keeps unchanged; equals length if the text needs no repair. Runs of
+	// printable ASCII are scanned 16 (SSE2) or 32 (AVX2) bytes at a time.
+	std::size_t utf8_valid_prefix(const char* data, std::size_t length);
+
+	// Drops control characters other than \b, \f, \n, \r and \t as well as
+	// bytes that do not form a complete UTF-8 sequence.
+	std::string utf8_remove_illegal_chars(const std::string& value);
+}
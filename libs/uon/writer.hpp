@@ -13,10 +13,23 @@ namespace uon {
 	extern void write_json(const Value& value, boost::filesystem::path output, bool compact = false);
 	extern std::string write_json(const Value& value, bool compact = false);
 
-#if !defined(_WIN32)
+	// same output as write_json, large arrays and objects are written by
+	// several threads (0 for one per core)
+	extern void write_json_parallel(const Value& value, std::ostream& output, bool compact = false, unsigned int threads = 0);
+	extern void write_json_parallel(const Value& value, boost::filesystem::path output, bool compact = false, unsigned int threads = 0);
+	extern std::string write_json_parallel(const Value& value, bool compact = false, unsigned int threads = 0);
+
+	// value has to be an object; objects in extended json form are written
+	// as the bson type they stand for
 	extern void write_bson(const Value& value, std::ostream& output);
 	extern void write_bson(const Value& value, boost::filesystem::path output);
+	extern std::string write_bson(const Value& value);
 
+	extern void write_msgpack(const Value& value, std::ostream& output);
+	extern void write_msgpack(const Value& value, boost::filesystem::path output);
+	extern std::string write_msgpack(const Value& value);
+
+#if !defined(_WIN32)
 	extern mongo::BSONObj to_mongo_bson(const Value& value);
 #endif
 }
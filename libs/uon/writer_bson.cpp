@@ -1,6 +1,8 @@
 #include "uon.hpp"
 
 #include <fstream>
+#include <limits>
+#include <cstring>
 
 #if !defined(_WIN32)
 #include <mongo/client/dbclient.h>
@@ -8,26 +10,459 @@
 
 namespace uon {
 
-#if !defined(_WIN32)
+namespace
+{
+	int hex_value(char c)
+	{
+		if(c >= '0' && c <= '9') return c - '0';
+		if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	int base64_value(char c)
+	{
+		if(c >= 'A' && c <= 'Z') return c - 'A';
+		if(c >= 'a' && c <= 'z') return c - 'a' + 26;
+		if(c >= '0' && c <= '9') return c - '0' + 52;
+		if(c == '+') return 62;
+		if(c == '/') return 63;
+		return -1;
+	}
+
+	bool is_hex(const String& text)
+	{
+		for(auto c : text)
+		{
+			if(hex_value(c) < 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// the member of a single member object, or nullptr
+	const Value* wrapped(const Object& object, const char* key)
+	{
+		if(object.size() != 1 || object.begin()->first != key)
+		{
+			return nullptr;
+		}
+
+		return &object.begin()->second;
+	}
+
+	const Value* member(const Object& object, const char* key, Type type)
+	{
+		auto i = object.find(key);
+
+		if(i == object.end() || i->second.type() != type)
+		{
+			return nullptr;
+		}
+
+		return &i->second;
+	}
+
+	// encodes into a buffer, document sizes are filled in once a document is
+	// complete; objects in mongo's extended json form (as produced by
+	// read_bson) are written as the bson type they stand for
+	class Encoder
+	{
+	public:
+		explicit Encoder(std::string& output)
+			: _output(output)
+		{ }
+
+		void write_document(const Object& object)
+		{
+			auto start = begin_document();
+
+			for(auto& i : object)
+			{
+				write_element(i.first.str(), i.second);
+			}
+
+			end_document(start);
+		}
+
+	private:
+		void write_array(const Array& array)
+		{
+			auto start = begin_document();
+
+			for(std::size_t i = 0; i < array.size(); ++i)
+			{
+				write_element(std::to_string(i), array[i]);
+			}
+
+			end_document(start);
+		}
+
+		void write_element(const String& name, const Value& value)
+		{
+			switch(value.type())
+			{
+				case Type::null:
+					write_header(0x0A, name);
+					break;
+
+				case Type::string:
+					write_header(0x02, name);
+					write_string(value.as_string());
+					break;
+
+				case Type::number:
+					write_number(name, value);
+					break;
+
+				case Type::boolean:
+					write_header(0x08, name);
+					_output += value.as_boolean() ? '\x01' : '\x00';
+					break;
+
+				case Type::object:
+					if(!write_extended(name, value.as_object()))
+					{
+						write_header(0x03, name);
+						write_document(value.as_object());
+					}
+					break;
+
+				case Type::array:
+					write_header(0x04, name);
+					write_array(value.as_array());
+					break;
+			}
+		}
+
+		void write_number(const String& name, const Value& value)
+		{
+			switch(value.number_kind())
+			{
+				case NumberKind::integer:
+				{
+					auto number = value.as_integer();
+
+					if(number >= std::numeric_limits<std::int32_t>::min() && number <= std::numeric_limits<std::int32_t>::max())
+					{
+						write_header(0x10, name);
+						write_uint32(static_cast<std::uint32_t>(number));
+					}
+					else
+					{
+						write_header(0x12, name);
+						write_uint64(static_cast<std::uint64_t>(number));
+					}
+					break;
+				}
+
+				case NumberKind::unsigned_integer:
+				{
+					auto number = value.as_unsigned();
+
+					if(number <= static_cast<Unsigned>(std::numeric_limits<Integer>::max()))
+					{
+						write_number(name, Value(static_cast<Integer>(number)));
+					}
+					else
+					{
+						// bson has no unsigned 64 bit type
+						write_header(0x01, name);
+						write_double(static_cast<Real>(number));
+					}
+					break;
+				}
+
+				case NumberKind::real:
+					write_header(0x01, name);
+					write_double(value.as_real());
+					break;
+			}
+		}
+
+		bool write_extended(const String& name, const Object& object)
+		{
+			if(object.empty() || object.size() > 2 || object.begin()->first.str()[0] != '$')
+			{
+				return false;
+			}
+
+			if(auto id = wrapped(object, "$oid"))
+			{
+				if(!id->is_string() || id->as_string().size() != 24 || !is_hex(id->as_string()))
+				{
+					return false;
+				}
+
+				write_header(0x07, name);
+
+				auto& text = id->as_string();
+
+				for(std::size_t i = 0; i < 24; i += 2)
+				{
+					_output += static_cast<char>(hex_value(text[i]) << 4 | hex_value(text[i+1]));
+				}
+
+				return true;
+			}
+
+			if(auto date = wrapped(object, "$date"))
+			{
+				if(!date->is_number() || date->number_kind() != NumberKind::integer)
+				{
+					return false;
+				}
+
+				write_header(0x09, name);
+				write_uint64(static_cast<std::uint64_t>(date->as_integer()));
+				return true;
+			}
+
+			if(auto number = wrapped(object, "$numberLong"))
+			{
+				if(!number->is_string() || number->as_string().empty())
+				{
+					return false;
+				}
+
+				auto& text = number->as_string();
+				Integer parsed;
+
+				if(from_chars(text.data(), text.data() + text.size(), parsed) != text.data() + text.size())
+				{
+					return false;
+				}
+
+				write_header(0x12, name);
+				write_uint64(static_cast<std::uint64_t>(parsed));
+				return true;
+			}
+
+			if(auto timestamp = wrapped(object, "$timestamp"))
+			{
+				if(!timestamp->is_object() || timestamp->as_object().size() != 2)
+				{
+					return false;
+				}
+
+				auto time = member(timestamp->as_object(), "t", Type::number);
+				auto increment = member(timestamp->as_object(), "i", Type::number);
+
+				if(!time || !increment)
+				{
+					return false;
+				}
 
-void write_bson(const Value& value, std::ostream& input)
+				write_header(0x11, name);
+				write_uint32(static_cast<std::uint32_t>(increment->as_unsigned()));
+				write_uint32(static_cast<std::uint32_t>(time->as_unsigned()));
+				return true;
+			}
+
+			if(wrapped(object, "$minKey"))
+			{
+				write_header(0xFF, name);
+				return true;
+			}
+
+			if(wrapped(object, "$maxKey"))
+			{
+				write_header(0x7F, name);
+				return true;
+			}
+
+			if(object.size() != 2)
+			{
+				return false;
+			}
+
+			if(auto pattern = member(object, "$regex", Type::string))
+			{
+				auto options = member(object, "$options", Type::string);
+
+				if(!options)
+				{
+					return false;
+				}
+
+				write_header(0x0B, name);
+				write_cstring(pattern->as_string());
+				write_cstring(options->as_string());
+				return true;
+			}
+
+			if(auto data = member(object, "$binary", Type::string))
+			{
+				auto subtype = member(object, "$type", Type::string);
+
+				if(!subtype || subtype->as_string().size() != 2 || !is_hex(subtype->as_string()))
+				{
+					return false;
+				}
+
+				return write_binary(name, data->as_string(), static_cast<char>(hex_value(subtype->as_string()[0]) << 4 | hex_value(subtype->as_string()[1])));
+			}
+
+			return false;
+		}
+
+		bool write_binary(const String& name, const String& text, char subtype)
+		{
+			if(text.size() % 4 != 0)
+			{
+				return false;
+			}
+
+			std::string data;
+			data.reserve(text.size() / 4 * 3);
+
+			for(std::size_t i = 0; i < text.size(); i += 4)
+			{
+				int digits[4];
+				std::size_t padding = 0;
+
+				for(std::size_t j = 0; j < 4; ++j)
+				{
+					if(text[i+j] == '=' && i + 4 == text.size() && j >= 2)
+					{
+						digits[j] = 0;
+						++padding;
+						continue;
+					}
+
+					digits[j] = base64_value(text[i+j]);
+
+					if(digits[j] < 0 || padding > 0)
+					{
+						return false;
+					}
+				}
+
+				unsigned long group = digits[0] << 18 | digits[1] << 12 | digits[2] << 6 | digits[3];
+
+				data += static_cast<char>(group >> 16);
+				if(padding < 2) data += static_cast<char>((group >> 8) & 0xFF);
+				if(padding < 1) data += static_cast<char>(group & 0xFF);
+			}
+
+			write_header(0x05, name);
+			write_uint32(static_cast<std::uint32_t>(data.size()));
+			_output += subtype;
+			_output += data;
+			return true;
+		}
+
+		std::size_t begin_document()
+		{
+			auto start = _output.size();
+			_output.append(4, '\0');
+			return start;
+		}
+
+		void end_document(std::size_t start)
+		{
+			_output += '\0';
+
+			auto size = _output.size() - start;
+
+			if(size > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+			{
+				throw std::runtime_error("document too large for bson");
+			}
+
+			for(std::size_t i = 0; i < 4; ++i)
+			{
+				_output[start + i] = static_cast<char>((size >> (i * 8)) & 0xFF);
+			}
+		}
+
+		void write_header(unsigned char type, const String& name)
+		{
+			_output += static_cast<char>(type);
+			write_cstring(name);
+		}
+
+		void write_cstring(const String& text)
+		{
+			if(text.find('\0') != String::npos)
+			{
+				throw std::runtime_error("bson keys and patterns must not contain null characters");
+			}
+
+			_output.append(text.c_str(), text.size() + 1);
+		}
+
+		void write_string(const String& text)
+		{
+			write_uint32(static_cast<std::uint32_t>(text.size() + 1));
+			_output.append(text.c_str(), text.size() + 1);
+		}
+
+		void write_uint32(std::uint32_t value)
+		{
+			for(std::size_t i = 0; i < 4; ++i)
+			{
+				_output += static_cast<char>((value >> (i * 8)) & 0xFF);
+			}
+		}
+
+		void write_uint64(std::uint64_t value)
+		{
+			write_uint32(static_cast<std::uint32_t>(value));
+			write_uint32(static_cast<std::uint32_t>(value >> 32));
+		}
+
+		void write_double(Real value)
+		{
+			std::uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			write_uint64(bits);
+		}
+
+		std::string& _output;
+	};
+}
+
+std::string write_bson(const Value& value)
+{
+	if(!value.is_object())
+	{
+		throw std::runtime_error("bson requires an object as top level value");
+	}
+
+	std::string output;
+	Encoder(output).write_document(value.as_object());
+	return output;
+}
+
+void write_bson(const Value& value, std::ostream& output)
 {
-	input.exceptions( std::ofstream::failbit | std::ofstream::badbit );
-	throw std::runtime_error("not implemented");
+	output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+
+	auto data = write_bson(value);
+	output.write(data.data(), data.size());
 }
 
-void write_bson(const Value& value, boost::filesystem::path input)
+void write_bson(const Value& value, boost::filesystem::path output)
 {
 	std::ofstream stream;
 	stream.exceptions( std::ofstream::failbit | std::ofstream::badbit );
-	stream.open( input.string() );
+	stream.open( output.string(), std::ios::binary );
 
-	return write_bson(value, stream);
+	write_bson(value, stream);
 }
 
+#if !defined(_WIN32)
+
 mongo::BSONObj to_mongo_bson(const Value& value)
 {
-	return mongo::fromjson(write_json(value));
+	auto data = write_bson(value);
+
+	// the temporary buffer is copied into a buffer the object owns
+	return mongo::BSONObj(data.data()).getOwned();
 }
 
 #endif
@@ -1,182 +1,773 @@
 #include "uon.hpp"
+#include "utf8.hpp"
 
 #include <fstream>
-#include <sstream>
-#include <iomanip>
-#include <json_spirit/json_spirit_writer.h>
-#include <boost/regex.hpp>
+#include <cmath>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 namespace uon {
 
-/*
-static std::string utf8_invalid_characters =
-"("
-    "[\\xC0-\\xC1]" // Invalid UTF-8 Bytes
-    "|" "[\\xF5-\\xFF]" // Invalid UTF-8 Bytes
-    "|" "\\xE0[\\x80-\\x9F]" // Overlong encoding of prior code point
-    "|" "\\xF0[\\x80-\\x8F]" // Overlong encoding of prior code point
-    "|" "[\\xC2-\\xDF](?![\\x80-\\xBF])" // Invalid UTF-8 Sequence Start
-    "|" "[\\xE0-\\xEF](?![\\x80-\\xBF]{2})" // Invalid UTF-8 Sequence Start
-    "|" "[\\xF0-\\xF4](?![\\x80-\\xBF]{3})" // Invalid UTF-8 Sequence Start
-    "|" "(?<=[\\x0-\\x7F\\xF5-\\xFF])[\\x80-\\xBF]" // Invalid UTF-8 Sequence Middle
-//    "|" "(?<![\\xC2-\\xDF]|[\\xE0-\\xEF]|[\\xE0-\\xEF][\\x80-\\xBF]|[\\xF0-\\xF4]|[\\xF0-\\xF4][\\x80-\\xBF]|[\\xF0-\\xF4][\\x80-\\xBF]{2})[\\x80-\\xBF]" // Overlong Sequence
-    "|" "(?<=[\\xE0-\\xEF])[\\x80-\\xBF](?![\\x80-\\xBF])" // Short 3 byte sequence
-    "|" "(?<=[\\xF0-\\xF4])[\\x80-\\xBF](?![\\x80-\\xBF]{2})" // Short 4 byte sequence
-    "|" "(?<=[\\xF0-\\xF4][\\x80-\\xBF])[\\x80-\\xBF](?![\\x80-\\xBF])" // Short 4 byte sequence (2)
-")";
-
-static std::string utf8_replacement_character = "\uFFFD";
-*/
-
-std::string hex_byte(unsigned char value) {
-	std::stringstream str;
-	str << std::noshowbase << std::hex << std::setw(2) << std::setfill('0') << (unsigned int)value << std::flush;
-	return str.str();
-}
-
-std::string utf8_remove_illegal_chars(std::string value)
+namespace
 {
-	std::string result;
-	result.reserve(value.length()+1);
+	struct StringOutput
+	{
+		explicit StringOutput(std::string& target)
+			: target(target)
+		{ }
 
-	for(std::size_t i = 0, j = value.length(); i < j;)
+		void write(const char* data, std::size_t length)
+		{
+			target.append(data, length);
+		}
+
+		void put(char c)
+		{
+			target += c;
+		}
+
+		void flush()
+		{
+		}
+
+		std::string& target;
+	};
+
+	// collects output and passes it to the stream in large blocks
+	struct StreamOutput
 	{
-		if( (value[i] & 0x80) < 0x80 )
+		static const std::size_t capacity = 64 * 1024;
+
+		explicit StreamOutput(std::ostream& stream)
+			: stream(stream)
+		{
+			buffer.reserve(capacity);
+		}
+
+		void write(const char* data, std::size_t length)
+		{
+			if(buffer.size() + length > capacity)
+			{
+				flush();
+
+				if(length >= capacity)
+				{
+					stream.write(data, length);
+					return;
+				}
+			}
+
+			buffer.append(data, length);
+		}
+
+		void put(char c)
+		{
+			if(buffer.size() == capacity)
+			{
+				flush();
+			}
+
+			buffer += c;
+		}
+
+		void flush()
+		{
+			stream.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+
+		std::ostream& stream;
+		std::string buffer;
+	};
+
+	// writes values straight to the output; the pretty format is the one
+	// json_spirit used to produce (four spaces indentation, arrays without
+	// objects or arrays inside on a single line)
+	template<typename Output>
+	class Writer
+	{
+	public:
+		Writer(Output& output, bool compact, int level = 0)
+			: _output(output)
+			, _compact(compact)
+			, _level(level)
+		{ }
+
+		void write(const Value& value)
 		{
-			if( value[i] <= 0x1F || value[i] == 0x7F )
+			switch(value.type())
 			{
-		        switch( value[i] )
-		        {
-		            case '\b':
-		            case '\f':
-		            case '\n':
-		            case '\r':
-		            case '\t':
-						result += value.substr(i, 1);
-						break;
-		        }
+				case Type::null:
+					write_literal("null");
+					break;
+
+				case Type::string:
+					write_string(value.as_string());
+					break;
+
+				case Type::number:
+					write_number(value);
+					break;
+
+				case Type::boolean:
+					write_literal(value.as_boolean() ? "true" : "false");
+					break;
+
+				case Type::object:
+					write_object(value.as_object());
+					break;
+
+				case Type::array:
+					write_array(value.as_array());
+					break;
+			}
+		}
+
+		// members or elements [begin, end) of an object or array, as they
+		// appear inside it
+		void write_range(const Value& container, std::size_t begin, std::size_t end)
+		{
+			if(container.is_object())
+			{
+				write_members(container.as_object(), begin, end);
 			}
 			else
 			{
-				result += value.substr(i, 1);
+				auto& array = container.as_array();
+				write_elements(array, begin, end, single_line(array));
 			}
-			i += 1;
 		}
-		else
-		if( (value[i] & 0xE0) == 0xC0 && (j-i-1) >= 1 && (value[i+1] & 0xC0) == 0x80 )
+
+		// like write(), but leaves ranges of members and elements of large
+		// containers to splitter.defer(), see ParallelWriter
+		template<typename Splitter>
+		void write_split(const Value& value, Splitter& splitter)
 		{
-			result += value.substr(i, 2);
-			i += 2;
+			if(!splitter.large(value))
+			{
+				write(value);
+				return;
+			}
+
+			if(value.is_object())
+			{
+				auto& object = value.as_object();
+
+				_output.put('{');
+				++_level;
+
+				split(value, object.size(), splitter, [&](std::size_t i)
+				{
+					write_member(object, i);
+					return &object.begin()[i].second;
+				});
+
+				--_level;
+				new_line();
+				_output.put('}');
+			}
+			else
+			{
+				auto& array = value.as_array();
+				bool single = single_line(array);
+
+				_output.put('[');
+
+				if(!single)
+				{
+					++_level;
+				}
+
+				split(value, array.size(), splitter, [&](std::size_t i)
+				{
+					write_separator(i, single);
+					return &array[i];
+				});
+
+				if(!single)
+				{
+					--_level;
+					new_line();
+				}
+				else
+				{
+					space();
+				}
+
+				_output.put(']');
+			}
 		}
-		else
-		if( (value[i] & 0xF0) == 0xE0 && (j-i-1) >= 2 && (value[i+1] & 0xC0) == 0x80 && (value[i+2] & 0xC0) == 0x80 )
+
+	private:
+		// large children are split further, the others are deferred in
+		// groups of about the splitter's chunk size; prefix(i) writes what
+		// precedes child i and returns it
+		template<typename Splitter, typename Prefix>
+		void split(const Value& container, std::size_t size, Splitter& splitter, Prefix prefix)
 		{
-			result += value.substr(i, 3);
-			i += 3;
+			std::size_t group = 0;
+			std::size_t weight = 0;
+
+			for(std::size_t i = 0; i < size; ++i)
+			{
+				auto& child = child_at(container, i);
+
+				if(splitter.large(child))
+				{
+					if(group < i)
+					{
+						splitter.defer(container, group, i, _level);
+					}
+
+					write_split(*prefix(i), splitter);
+					group = i + 1;
+					weight = 0;
+					continue;
+				}
+
+				weight += splitter.weight(child);
+
+				if(weight >= splitter.chunk())
+				{
+					splitter.defer(container, group, i + 1, _level);
+					group = i + 1;
+					weight = 0;
+				}
+			}
+
+			if(group < size)
+			{
+				splitter.defer(container, group, size, _level);
+			}
 		}
-		else
-		if( (value[i] & 0xF8) == 0xF0 && (j-i-1) >= 3 && (value[i+1] & 0xC0) == 0x80 && (value[i+2] & 0xC0) == 0x80 && (value[i+3] & 0xC0) == 0x80 )
+
+		static const Value& child_at(const Value& container, std::size_t i)
 		{
-			result += value.substr(i, 4);
-			i += 4;
+			return container.is_object() ? container.as_object().begin()[i].second : container.as_array()[i];
+		}
+
+		void write_object(const Object& object)
+		{
+			_output.put('{');
+			++_level;
+
+			write_members(object, 0, object.size());
+
+			--_level;
+			new_line();
+			_output.put('}');
 		}
-		else
+
+		void write_members(const Object& object, std::size_t begin, std::size_t end)
 		{
-			while( (value[i] & 0x80) == 0x80 )
+			for(auto i = begin; i != end; ++i)
 			{
-				i += 1;
+				write_member(object, i);
+				write(object.begin()[i].second);
 			}
 		}
-	}
 
-	return result;
-}
+		void write_member(const Object& object, std::size_t i)
+		{
+			if(i != 0)
+			{
+				_output.put(',');
+			}
 
-std::string write_json(const Value& value, bool compact)
-{
-	std::stringstream stream;
-	write_json(value, stream, compact);
-	return stream.str();
-}
+			new_line();
+			write_string(object.begin()[i].first);
+			write_literal(_compact ? ":" : " : ");
+		}
 
-void write_json(const Value& value, std::ostream& output, bool compact)
-{
-	//boost::regex utf8_illegal_characters_regex(utf8_invalid_characters, boost::regex::perl);
+		bool single_line(const Array& array) const
+		{
+			if(_compact)
+			{
+				return true;
+			}
 
-	output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+			for(auto& i : array)
+			{
+				if(i.is_object() || i.is_array())
+				{
+					return false;
+				}
+			}
 
-	std::function<json_spirit::Value(const Value& val)> convert = [&convert /*,&utf8_illegal_characters_regex*/](const Value& val) -> json_spirit::Value
-	{
-		switch(val.type())
+			return true;
+		}
+
+		void write_array(const Array& array)
+		{
+			bool single = single_line(array);
+
+			_output.put('[');
+
+			if(!single)
+			{
+				++_level;
+				write_elements(array, 0, array.size(), false);
+				--_level;
+				new_line();
+			}
+			else
+			{
+				write_elements(array, 0, array.size(), true);
+				space();
+			}
+
+			_output.put(']');
+		}
+
+		void write_elements(const Array& array, std::size_t begin, std::size_t end, bool single)
+		{
+			for(auto i = begin; i != end; ++i)
+			{
+				write_separator(i, single);
+				write(array[i]);
+			}
+		}
+
+		void write_separator(std::size_t i, bool single)
+		{
+			if(i != 0)
+			{
+				_output.put(',');
+			}
+
+			if(single)
+			{
+				space();
+			}
+			else
+			{
+				new_line();
+			}
+		}
+
+		void write_number(const Value& value)
+		{
+			char buffer[max_number_chars];
+			char* end = buffer;
+
+			switch(value.number_kind())
+			{
+				case NumberKind::integer:
+					end = to_chars(buffer, value.as_integer());
+					break;
+
+				case NumberKind::unsigned_integer:
+					end = to_chars(buffer, value.as_unsigned());
+					break;
+
+				case NumberKind::real:
+				{
+					auto number = value.as_real();
+
+					if(!std::isfinite(number))
+					{
+						// not representable in json
+						write_literal("null");
+						return;
+					}
+
+					end = to_chars(buffer, number);
+
+					// keep reals recognizable, so they are read back as reals
+					if(std::find_if(buffer, end, [](char c) { return c == '.' || c == 'e'; }) == end)
+					{
+						*end++ = '.';
+						*end++ = '0';
+					}
+
+					break;
+				}
+			}
+
+			_output.write(buffer, end - buffer);
+		}
+
+		void write_string(const std::string& value)
 		{
-			case Type::null:
+			if(utf8_valid_prefix(value.data(), value.size()) != value.size())
 			{
-				return json_spirit::Value();
+				write_escaped(utf8_remove_illegal_chars(value));
+				return;
 			}
 
-			case Type::string:
+			write_escaped(value);
+		}
+
+		void write_escaped(const std::string& value)
+		{
+			_output.put('"');
+
+			auto run = value.data();
+			auto end = value.data() + value.size();
+
+			for(auto i = run; i != end; ++i)
 			{
-				return json_spirit::Value(
-					utf8_remove_illegal_chars(val.as_string())
-					/*boost::regex_replace(val.as_string(), utf8_illegal_characters_regex, utf8_replacement_character, boost::match_default)*/);
+				const char* escaped = nullptr;
+
+				switch(*i)
+				{
+					case '"':  escaped = "\\\""; break;
+					case '\\': escaped = "\\\\"; break;
+					case '\b': escaped = "\\b"; break;
+					case '\f': escaped = "\\f"; break;
+					case '\n': escaped = "\\n"; break;
+					case '\r': escaped = "\\r"; break;
+					case '\t': escaped = "\\t"; break;
+					default: continue;
+				}
+
+				_output.write(run, i - run);
+				_output.write(escaped, 2);
+				run = i + 1;
 			}
 
-			case Type::number:
+			_output.write(run, end - run);
+			_output.put('"');
+		}
+
+		void write_literal(const char* literal)
+		{
+			_output.write(literal, std::char_traits<char>::length(literal));
+		}
+
+		void new_line()
+		{
+			if(_compact)
+			{
+				return;
+			}
+
+			_output.put('\n');
+
+			for(int i = 0; i < _level; ++i)
+			{
+				_output.write("    ", 4);
+			}
+		}
+
+		void space()
+		{
+			if(!_compact)
+			{
+				_output.put(' ');
+			}
+		}
+
+		Output& _output;
+		bool _compact;
+		int _level;
+	};
+
+	// writes the structure around deferred ranges into separate pieces
+	struct PieceOutput
+	{
+		PieceOutput()
+			: pieces(1)
+		{ }
+
+		void write(const char* data, std::size_t length)
+		{
+			pieces.back().append(data, length);
+		}
+
+		void put(char c)
+		{
+			pieces.back() += c;
+		}
+
+		void cut()
+		{
+			pieces.emplace_back();
+		}
+
+		std::vector<std::string> pieces;
+	};
+
+	// Ranges of members and elements are written by a pool of threads into
+	// buffers of their own, which are passed to the output in document
+	// order. Only large containers are split, into ranges of roughly the
+	// chunk size (estimated output bytes). Workers stay at most a window of
+	// ranges ahead of the output, which bounds the memory held in buffers.
+	class ParallelWriter
+	{
+	public:
+		static const std::size_t minimum_chunk = 64 * 1024;
+
+		ParallelWriter(const Value& value, bool compact, unsigned int threads)
+			: _value(value)
+			, _compact(compact)
+			, _threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+			, _chunk(minimum_chunk)
+			, _next(0)
+			, _consumed(0)
+			, _stop(false)
+		{ }
+
+		template<typename Output>
+		void write(Output& output)
+		{
+			auto total = (_threads > 1) ? measure(_value) : 0;
+
+			if(total < 2 * minimum_chunk)
 			{
-				auto num = val.as_number();
+				Writer<Output>(output, _compact).write(_value);
+				return;
+			}
+
+			_chunk = std::max<std::size_t>(minimum_chunk, total / (_threads * 8));
+
+			Writer<PieceOutput>(_structure, _compact).write_split(_value, *this);
+
+			std::vector<std::thread> workers;
 
-				long double i = 0.0;
-				long double f = std::modf(num, &i);
+			try
+			{
+				for(unsigned int i = 0; i < _threads; ++i)
+				{
+					workers.emplace_back([this]() { work(); });
+				}
 
-				if(f == 0.0)
+				for(std::size_t i = 0; i < _ranges.size(); ++i)
 				{
-					if(f >= 0)
+					auto& piece = _structure.pieces[i];
+					output.write(piece.data(), piece.size());
+					std::string().swap(piece);
+
+					std::string result;
 					{
-						return json_spirit::Value(static_cast<std::uint64_t>(i));
+						std::unique_lock<std::mutex> lock(_mutex);
+						_changed.wait(lock, [&]() { return _ranges[i].done || _error; });
+
+						if(_error)
+						{
+							std::rethrow_exception(_error);
+						}
+
+						result.swap(_ranges[i].output);
+						++_consumed;
 					}
+					_changed.notify_all();
 
-					return json_spirit::Value(static_cast<std::int64_t>(i));
+					output.write(result.data(), result.size());
 				}
 
-				return json_spirit::Value(static_cast<double>(num));
+				auto& piece = _structure.pieces.back();
+				output.write(piece.data(), piece.size());
+			}
+			catch(...)
+			{
+				finish(workers);
+				throw;
 			}
 
-			case Type::boolean:
+			finish(workers);
+		}
+
+		// used by Writer::write_split
+		bool large(const Value& value) const
+		{
+			auto i = _weights.find(&value);
+			return i != _weights.end() && i->second >= _chunk;
+		}
+
+		std::size_t weight(const Value& value) const
+		{
+			auto i = _weights.find(&value);
+			return (i != _weights.end()) ? i->second : estimate(value);
+		}
+
+		std::size_t chunk() const
+		{
+			return _chunk;
+		}
+
+		void defer(const Value& container, std::size_t begin, std::size_t end, int level)
+		{
+			Range range = { &container, begin, end, level, std::string(), false };
+			_ranges.push_back(std::move(range));
+			_structure.cut();
+		}
+
+	private:
+		struct Range
+		{
+			const Value* container;
+			std::size_t begin;
+			std::size_t end;
+			int level;
+			std::string output;
+			bool done;
+		};
+
+		// estimated output bytes; remembered for containers that may have to
+		// be split
+		std::size_t measure(const Value& value)
+		{
+			if(!value.is_object() && !value.is_array())
 			{
-				return json_spirit::Value(val.as_boolean());
+				return estimate(value);
 			}
 
-			case Type::object:
+			std::size_t weight = 2;
+
+			if(value.is_object())
+			{
+				for(auto& i : value.as_object())
+				{
+					weight += i.first.str().size() + 8 + measure(i.second);
+				}
+			}
+			else
 			{
-				json_spirit::Object spobj;
-				for(auto& e : val.as_object())
+				for(auto& i : value.as_array())
 				{
-					spobj.push_back(json_spirit::Pair(
-						//boost::regex_replace(e.first, utf8_illegal_characters_regex, utf8_replacement_character, boost::match_default),
-						utf8_remove_illegal_chars(e.first),
-						convert(e.second)));
+					weight += 4 + measure(i);
 				}
-				return json_spirit::Value(spobj);
 			}
 
-			case Type::array:
+			if(weight >= minimum_chunk)
 			{
-				json_spirit::Array sparr;
-				for(auto& e : val.as_array())
+				_weights[&value] = weight;
+			}
+
+			return weight;
+		}
+
+		static std::size_t estimate(const Value& value)
+		{
+			switch(value.type())
+			{
+				case Type::string:
+					return value.as_string().size() + 2;
+
+				case Type::number:
+					return 8;
+
+				case Type::object:
 				{
-					sparr.push_back(convert(e));
+					std::size_t weight = 2;
+
+					for(auto& i : value.as_object())
+					{
+						weight += i.first.str().size() + 8 + estimate(i.second);
+					}
+
+					return weight;
 				}
-				return json_spirit::Value(sparr);
+
+				case Type::array:
+				{
+					std::size_t weight = 2;
+
+					for(auto& i : value.as_array())
+					{
+						weight += 4 + estimate(i);
+					}
+
+					return weight;
+				}
+
+				default:
+					return 5;
 			}
+		}
+
+		void work()
+		{
+			for(;;)
+			{
+				Range* range;
+				{
+					std::unique_lock<std::mutex> lock(_mutex);
+					_changed.wait(lock, [this]() { return _stop || _next == _ranges.size() || _next < _consumed + 4 * _threads; });
 
+					if(_stop || _next == _ranges.size())
+					{
+						return;
+					}
+
+					range = &_ranges[_next++];
+				}
+
+				try
+				{
+					std::string result;
+					StringOutput output(result);
+					Writer<StringOutput>(output, _compact, range->level).write_range(*range->container, range->begin, range->end);
+
+					std::lock_guard<std::mutex> lock(_mutex);
+					range->output.swap(result);
+					range->done = true;
+				}
+				catch(...)
+				{
+					std::lock_guard<std::mutex> lock(_mutex);
+					_error = std::current_exception();
+					_stop = true;
+				}
+
+				_changed.notify_all();
+			}
+		}
+
+		void finish(std::vector<std::thread>& workers)
+		{
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_stop = true;
+			}
+			_changed.notify_all();
+
+			for(auto& worker : workers)
+			{
+				worker.join();
+			}
 		}
 
-		throw std::runtime_error("invalid type");
+		const Value& _value;
+		bool _compact;
+		unsigned int _threads;
+		std::size_t _chunk;
+
+		std::unordered_map<const Value*, std::size_t> _weights;
+		PieceOutput _structure;
+		std::vector<Range> _ranges;
+
+		std::mutex _mutex;
+		std::condition_variable _changed;
+		std::size_t _next;
+		std::size_t _consumed;
+		bool _stop;
+		std::exception_ptr _error;
 	};
 
-	auto spval = convert(value);
+	const std::size_t ParallelWriter::minimum_chunk;
+}
+
+std::string write_json(const Value& value, bool compact)
+{
+	std::string result;
+	StringOutput output(result);
+	Writer<StringOutput>(output, compact).write(value);
+	return result;
+}
+
+void write_json(const Value& value, std::ostream& output, bool compact)
+{
+	output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
 
-	json_spirit::write(spval, output, json_spirit::raw_utf8 | (compact ? json_spirit::none : (json_spirit::pretty_print | json_spirit::single_line_arrays)));
+	StreamOutput buffered(output);
+	Writer<StreamOutput>(buffered, compact).write(value);
+	buffered.flush();
 }
 
 void write_json(const Value& value, boost::filesystem::path output, bool compact)
@@ -185,7 +776,33 @@ void write_json(const Value& value, boost::filesystem::path output, bool compact
 	stream.exceptions( std::ofstream::failbit | std::ofstream::badbit );
 	stream.open( output.string() );
 
-	return write_json(value, stream);
+	return write_json(value, stream, compact);
+}
+
+std::string write_json_parallel(const Value& value, bool compact, unsigned int threads)
+{
+	std::string result;
+	StringOutput output(result);
+	ParallelWriter(value, compact, threads).write(output);
+	return result;
+}
+
+void write_json_parallel(const Value& value, std::ostream& output, bool compact, unsigned int threads)
+{
+	output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+
+	StreamOutput buffered(output);
+	ParallelWriter(value, compact, threads).write(buffered);
+	buffered.flush();
+}
+
+void write_json_parallel(const Value& value, boost::filesystem::path output, bool compact, unsigned int threads)
+{
+	std::ofstream stream;
+	stream.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+	stream.open( output.string() );
+
+	return write_json_parallel(value, stream, compact, threads);
 }
 
 }
@@ -0,0 +1,256 @@
+#include "uon.hpp"
+
+#include <fstream>
+#include <limits>
+#include <cstring>
+
+namespace uon {
+
+namespace
+{
+	// always picks the smallest encoding, so equal values encode to equal
+	// bytes
+	class Encoder
+	{
+	public:
+		explicit Encoder(std::string& output)
+			: _output(output)
+		{ }
+
+		void write(const Value& value)
+		{
+			switch(value.type())
+			{
+				case Type::null:
+					_output += '\xC0';
+					break;
+
+				case Type::string:
+					write_string(value.as_string());
+					break;
+
+				case Type::number:
+					write_number(value);
+					break;
+
+				case Type::boolean:
+					_output += value.as_boolean() ? '\xC3' : '\xC2';
+					break;
+
+				case Type::object:
+				{
+					auto& object = value.as_object();
+					write_header(object.size(), 0x80, 0xDE);
+
+					for(auto& i : object)
+					{
+						write_string(i.first.str());
+						write(i.second);
+					}
+					break;
+				}
+
+				case Type::array:
+				{
+					auto& array = value.as_array();
+					write_header(array.size(), 0x90, 0xDC);
+
+					for(auto& i : array)
+					{
+						write(i);
+					}
+					break;
+				}
+			}
+		}
+
+	private:
+		void write_number(const Value& value)
+		{
+			switch(value.number_kind())
+			{
+				case NumberKind::integer:
+				{
+					auto number = value.as_integer();
+
+					if(number >= 0)
+					{
+						write_unsigned(static_cast<Unsigned>(number));
+					}
+					else
+					if(number >= -32)
+					{
+						_output += static_cast<char>(number);
+					}
+					else
+					if(number >= std::numeric_limits<std::int8_t>::min())
+					{
+						_output += '\xD0';
+						write_uint(static_cast<std::uint8_t>(number), 1);
+					}
+					else
+					if(number >= std::numeric_limits<std::int16_t>::min())
+					{
+						_output += '\xD1';
+						write_uint(static_cast<std::uint16_t>(number), 2);
+					}
+					else
+					if(number >= std::numeric_limits<std::int32_t>::min())
+					{
+						_output += '\xD2';
+						write_uint(static_cast<std::uint32_t>(number), 4);
+					}
+					else
+					{
+						_output += '\xD3';
+						write_uint(static_cast<std::uint64_t>(number), 8);
+					}
+					break;
+				}
+
+				case NumberKind::unsigned_integer:
+					write_unsigned(value.as_unsigned());
+					break;
+
+				case NumberKind::real:
+				{
+					auto number = value.as_real();
+					std::uint64_t bits;
+					std::memcpy(&bits, &number, sizeof(bits));
+
+					_output += '\xCB';
+					write_uint(bits, 8);
+					break;
+				}
+			}
+		}
+
+		void write_unsigned(Unsigned number)
+		{
+			if(number <= 0x7F)
+			{
+				_output += static_cast<char>(number);
+			}
+			else
+			if(number <= std::numeric_limits<std::uint8_t>::max())
+			{
+				_output += '\xCC';
+				write_uint(number, 1);
+			}
+			else
+			if(number <= std::numeric_limits<std::uint16_t>::max())
+			{
+				_output += '\xCD';
+				write_uint(number, 2);
+			}
+			else
+			if(number <= std::numeric_limits<std::uint32_t>::max())
+			{
+				_output += '\xCE';
+				write_uint(number, 4);
+			}
+			else
+			{
+				_output += '\xCF';
+				write_uint(number, 8);
+			}
+		}
+
+		void write_string(const String& text)
+		{
+			auto length = text.size();
+
+			if(length < 32)
+			{
+				_output += static_cast<char>(0xA0 | length);
+			}
+			else
+			if(length <= std::numeric_limits<std::uint8_t>::max())
+			{
+				_output += '\xD9';
+				write_uint(length, 1);
+			}
+			else
+			if(length <= std::numeric_limits<std::uint16_t>::max())
+			{
+				_output += '\xDA';
+				write_uint(length, 2);
+			}
+			else
+			{
+				check_size(length);
+				_output += '\xDB';
+				write_uint(length, 4);
+			}
+
+			_output += text;
+		}
+
+		// fix is the type of the short form holding up to 15 items, the 16
+		// and 32 bit forms follow at wide and wide + 1
+		void write_header(std::size_t size, unsigned char fix, unsigned char wide)
+		{
+			if(size < 16)
+			{
+				_output += static_cast<char>(fix | size);
+			}
+			else
+			if(size <= std::numeric_limits<std::uint16_t>::max())
+			{
+				_output += static_cast<char>(wide);
+				write_uint(size, 2);
+			}
+			else
+			{
+				check_size(size);
+				_output += static_cast<char>(wide + 1);
+				write_uint(size, 4);
+			}
+		}
+
+		void check_size(std::size_t size)
+		{
+			if(size > std::numeric_limits<std::uint32_t>::max())
+			{
+				throw std::runtime_error("value too large for messagepack");
+			}
+		}
+
+		// big endian
+		void write_uint(std::uint64_t value, std::size_t size)
+		{
+			for(std::size_t i = size; i > 0; --i)
+			{
+				_output += static_cast<char>((value >> ((i - 1) * 8)) & 0xFF);
+			}
+		}
+
+		std::string& _output;
+	};
+}
+
+std::string write_msgpack(const Value& value)
+{
+	std::string output;
+	Encoder(output).write(value);
+	return output;
+}
+
+void write_msgpack(const Value& value, std::ostream& output)
+{
+	output.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+
+	auto data = write_msgpack(value);
+	output.write(data.data(), data.size());
+}
+
+void write_msgpack(const Value& value, boost::filesystem::path output)
+{
+	std::ofstream stream;
+	stream.exceptions( std::ofstream::failbit | std::ofstream::badbit );
+	stream.open( output.string(), std::ios::binary );
+
+	write_msgpack(value, stream);
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <uon/uon.hpp>
+
+namespace bench {
+
+	// A benchmark is a function of measure() calls, registered under its
+	// name by OAK_BENCHMARK.
+	struct Benchmark
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	std::vector<Benchmark>& benchmarks();
+
+	struct Registration
+	{
+		Registration(const char* name, void (*run)());
+	};
+
+	// Calls body once to warm up, then repeatedly for about a quarter of a
+	// second, and prints the mean time per call, as well as the throughput
+	// if the call processes bytes of input or output.
+	void measure(const std::string& label, const std::function<void()>& body, std::size_t bytes = 0);
+
+	// keeps the compiler from dropping a result as unused
+	void keep(const void* result);
+
+	// a document shaped like oak's report, with tasks of lines of build
+	// output and the warnings parsed from them
+	uon::Value report(std::size_t tasks, std::size_t lines);
+
+} // namespace: bench
+
+#define OAK_BENCHMARK(name) \
+	static void name##_benchmark(); \
+	static ::bench::Registration name##_registration(#name, &name##_benchmark); \
+	static void name##_benchmark()
@@ -0,0 +1,40 @@
+#include "bench.hpp"
+
+#include "config.hpp"
+
+// the builtin configurations as oak decodes them on start, and as json
+// text, which was parsed on every start before they were compiled
+OAK_BENCHMARK(builtin)
+{
+	using config::builtin::blobs;
+	using config::builtin::blob_count;
+
+	std::vector<std::string> json;
+	std::size_t msgpackBytes = 0;
+	std::size_t jsonBytes = 0;
+
+	for(std::size_t i = 0; i < blob_count; ++i)
+	{
+		json.push_back(uon::write_json(uon::read_msgpack(reinterpret_cast<const char*>(blobs[i].data), blobs[i].size)));
+		msgpackBytes += blobs[i].size;
+		jsonBytes += json.back().size();
+	}
+
+	bench::measure("read_msgpack of the blobs", [&]()
+		{
+			for(std::size_t i = 0; i < blob_count; ++i)
+			{
+				auto value = uon::read_msgpack(reinterpret_cast<const char*>(blobs[i].data), blobs[i].size);
+				bench::keep(&value);
+			}
+		}, msgpackBytes);
+
+	bench::measure("read_json of the same configurations", [&]()
+		{
+			for(auto& text : json)
+			{
+				auto value = uon::read_json(text.data(), text.size());
+				bench::keep(&value);
+			}
+		}, jsonBytes);
+}
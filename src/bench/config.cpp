@@ -0,0 +1,126 @@
+#include "bench.hpp"
+
+#include "config.hpp"
+
+namespace {
+
+	using Priority = config::Config::Priority;
+
+	// the tasks of the c++ variant, repeated under numbered names
+	uon::Value tasks(std::size_t count)
+	{
+		auto& variant = config::builtin::variants().at("c++").getref("tasks").as_object();
+		uon::Object::container_type tasks;
+
+		for(std::size_t i = 0; tasks.size() < count; ++i)
+		{
+			for(auto& task : variant)
+			{
+				if(tasks.size() < count)
+				{
+					tasks.emplace_back(task.first.str() + std::to_string(i), task.second);
+				}
+			}
+		}
+
+		return uon::Value(uon::Object(std::move(tasks)));
+	}
+
+	// The applies and lookups of oak's startup up to --printconf, with a
+	// build gap of 20 commits. If remerge is set, every apply is followed by
+	// merging and resolving all snippets from scratch, as apply() did before
+	// merging became lazy and incremental.
+	void startup(bool remerge, std::size_t taskCount = 4)
+	{
+		config::Config conf;
+
+		auto apply = [&](Priority priority, const std::string& path, uon::Value value)
+			{
+				conf.apply(priority, path, std::move(value));
+
+				if(remerge)
+				{
+					config::Config fresh;
+					fresh.restore(conf.layers());
+					bench::keep(&fresh.getref("meta"));
+				}
+			};
+
+		conf.apply(Priority::Base, config::builtin::base());
+
+		apply(Priority::Environment, "meta.system.name", "build-42");
+		apply(Priority::Environment, "meta.system.arch.family", "x86");
+		apply(Priority::Environment, "meta.system.arch.bitness", uon::Number(64));
+		apply(Priority::Environment, "meta.system.arch.os", "linux");
+		apply(Priority::Environment, "meta.system.arch.distribution", "debian");
+		apply(Priority::Environment, "meta.system.user", "jenkins");
+		apply(Priority::Arguments, "meta.input", "/src/project");
+		apply(Priority::Arguments, "meta.output", "/src/project/report.json");
+		bench::keep(&conf.getref("meta.configs.cache"));
+
+		apply(Priority::Project, "meta.project.name", "project");
+		apply(Priority::Variant, "tasks", tasks(taskCount));
+
+		const char* commit[] = { "repository", "branch", "commit.id.long", "commit.timestamp.default", "commit.timestamp.compact",
+			"commit.committer.name", "commit.committer.email", "commit.author.name", "commit.author.email" };
+
+		for(auto key : commit)
+		{
+			bench::keep(&conf.getref("tools.git.binary"));
+			apply(Priority::Environment, std::string("meta.") + key, "value of " + std::string(key));
+		}
+
+		uon::Array buildGap;
+
+		for(int i = 0; i < 20; ++i)
+		{
+			bench::keep(&conf.getref("tools.git.binary"));
+
+			uon::Value entry;
+			entry.set("id.long", "0f8fad5bd9cb469fa16570867728950e0f8fad5b" + std::to_string(i));
+			entry.set("timestamp.default", "2016-01-01 12:00:00");
+			buildGap.push_back(std::move(entry));
+		}
+
+		apply(Priority::Environment, "meta.buildgap", std::move(buildGap));
+		apply(Priority::Environment, "meta.commit.id.short", conf.get("meta.commit.id.long").to_string().substr(0, 7));
+		apply(Priority::Computed, "meta.cache.status", "disabled");
+		apply(Priority::Computed, "meta.id", "0f8fad5b-d9cb-469f-a165-70867728950e");
+		apply(Priority::Computed, "meta.input", "/src/project");
+		apply(Priority::Computed, "meta.output", "/src/project/report.json");
+
+		std::map<std::string, uon::Value> taskDefaults;
+
+		for(auto& task : conf.getref("tasks").as_object())
+		{
+			taskDefaults[std::string("tasks.") + task.first.str()] = conf.get(std::string("taskdefs.") + task.second.get("type").to_string());
+		}
+
+		conf.apply(Priority::Base, taskDefaults);
+
+		auto printed = uon::write_json(conf.resolved());
+		bench::keep(&printed);
+	}
+
+} // namespace: <anonymous>
+
+OAK_BENCHMARK(config_startup)
+{
+	bench::measure("lazy, incremental merge", []()
+		{
+			startup(false);
+		});
+
+	bench::measure("full merge after each apply", []()
+		{
+			startup(true);
+		});
+
+	for(std::size_t tasks : { 40, 300 })
+	{
+		bench::measure("lazy, incremental merge, " + std::to_string(tasks) + " tasks", [tasks]()
+			{
+				startup(false, tasks);
+			});
+	}
+}
@@ -0,0 +1,53 @@
+#include "bench.hpp"
+
+// lookups on a task of the report as birch's consolidate() does them,
+// where most optional members are missing
+OAK_BENCHMARK(lookup)
+{
+	auto report = bench::report(1, 10);
+	const uon::Value& task = report.getref("tasks.0");
+
+	const uon::Path hit("output.make.output");
+	const uon::Path miss("output.make.details");
+	const uon::Path deep("output.cmake.details.summary");
+	const uon::Value fallback = uon::Array();
+
+	bench::measure("find, present", [&]()
+		{
+			bench::keep(task.find(hit));
+		});
+
+	bench::measure("find, missing", [&]()
+		{
+			bench::keep(task.find(miss));
+			bench::keep(task.find(deep));
+		});
+
+	bench::measure("get with default, missing", [&]()
+		{
+			auto a = task.get(miss, fallback);
+			auto b = task.get(deep, fallback);
+			bench::keep(&a);
+			bench::keep(&b);
+		});
+
+	// how get(path, default) was built before find()
+	bench::measure("getref catching NotFound, missing", [&]()
+		{
+			for(auto path : { &miss, &deep })
+			{
+				uon::Value value;
+
+				try
+				{
+					value = task.getref(*path);
+				}
+				catch(const uon::NotFound&)
+				{
+					value = fallback;
+				}
+
+				bench::keep(&value);
+			}
+		});
+}
@@ -0,0 +1,139 @@
+#include "bench.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+// Runs the named benchmarks, or all of them without arguments. Build with
+// optimizations; the numbers are only comparable on the same machine.
+//
+//   oak_bench [benchmark]...
+
+namespace bench {
+
+	namespace {
+
+		const void* volatile kept = nullptr;
+
+	} // namespace: <anonymous>
+
+	std::vector<Benchmark>& benchmarks()
+	{
+		static std::vector<Benchmark> registered;
+		return registered;
+	}
+
+	Registration::Registration(const char* name, void (*run)())
+	{
+		benchmarks().push_back(Benchmark{ name, run });
+	}
+
+	void measure(const std::string& label, const std::function<void()>& body, std::size_t bytes)
+	{
+		using clock = std::chrono::steady_clock;
+
+		body();
+
+		std::size_t calls = 0;
+		auto start = clock::now();
+		auto elapsed = clock::duration::zero();
+
+		do
+		{
+			body();
+			++calls;
+			elapsed = clock::now() - start;
+		}
+		while(elapsed < std::chrono::milliseconds(250));
+
+		double seconds = std::chrono::duration<double>(elapsed).count() / calls;
+
+		std::cout << "  " << std::left << std::setw(40) << label << std::right << std::fixed
+			<< std::setprecision(3) << std::setw(12) << seconds * 1e6 << " us";
+
+		if(bytes > 0)
+		{
+			std::cout << std::setprecision(2) << std::setw(10) << bytes / seconds / 1e9 << " GB/s";
+		}
+
+		std::cout << std::endl;
+	}
+
+	void keep(const void* result)
+	{
+		kept = result;
+	}
+
+	uon::Value report(std::size_t tasks, std::size_t lines)
+	{
+		uon::Value result;
+		uon::Array results;
+
+		result.set("meta.id", "0f8fad5b-d9cb-469f-a165-70867728950e");
+		result.set("meta.hostname", "build-42");
+
+		for(std::size_t t = 0; t < tasks; ++t)
+		{
+			uon::Value task;
+			uon::Array output;
+			uon::Array details;
+
+			for(std::size_t l = 0; l < lines; ++l)
+			{
+				auto file = "src/module" + std::to_string(l % 17) + "/source" + std::to_string(l % 101) + ".cpp";
+				auto message = "unused variable 'value" + std::to_string(l) + "' [-Wunused-variable]";
+
+				uon::Array line;
+				line.push_back(uon::Value(static_cast<std::int64_t>(1000 + l)));
+				line.push_back(uon::Value(file + ":" + std::to_string(l % 300) + ":12: warning: " + message));
+				output.push_back(uon::Value(std::move(line)));
+
+				if(l % 10 == 0)
+				{
+					uon::Value detail;
+					detail.set("file", file);
+					detail.set("row", static_cast<std::int64_t>(l % 300));
+					detail.set("column", static_cast<std::int64_t>(12));
+					detail.set("type", "warning");
+					detail.set("message", message);
+					details.push_back(std::move(detail));
+				}
+			}
+
+			task.set("name", "task" + std::to_string(t));
+			task.set("status", "warning");
+			task.set("duration", 1.25 * t);
+			task.set("output.make.output", uon::Value(std::move(output)));
+			task.set("output.results", uon::Value(std::move(details)));
+			results.push_back(std::move(task));
+		}
+
+		result.set("tasks", uon::Value(std::move(results)));
+		return result;
+	}
+
+} // namespace: bench
+
+int main( int argc, const char* const* argv )
+{
+	using namespace bench;
+
+	for(auto& benchmark : benchmarks())
+	{
+		bool selected = (argc == 1);
+
+		for(int i = 1; i < argc; ++i)
+		{
+			selected = selected || std::strcmp(benchmark.name, argv[i]) == 0;
+		}
+
+		if(selected)
+		{
+			std::cout << benchmark.name << std::endl;
+			benchmark.run();
+		}
+	}
+
+	return 0;
+}
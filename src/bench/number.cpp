@@ -0,0 +1,144 @@
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+namespace {
+
+	// the conversions before from_chars and to_chars: format_real's
+	// snprintf/strtod search, std::stold, and streams
+	std::string format_snprintf(uon::Real value)
+	{
+		char buffer[32];
+
+		for(int precision = 15; precision <= 17; ++precision)
+		{
+			std::snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+
+			if(std::strtod(buffer, nullptr) == value)
+			{
+				break;
+			}
+		}
+
+		return buffer;
+	}
+
+	std::string format_stream(uon::Real value)
+	{
+		std::ostringstream stream;
+		stream.imbue(std::locale::classic());
+		stream.precision(17);
+		stream << value;
+		return stream.str();
+	}
+
+	uon::Real parse_stream(const std::string& text)
+	{
+		std::istringstream stream(text);
+		stream.imbue(std::locale::classic());
+
+		uon::Real value = 0;
+		stream >> value;
+		return value;
+	}
+
+	void compare(const std::string& kind, const std::vector<uon::Real>& values)
+	{
+		std::vector<std::string> texts;
+		std::size_t bytes = 0;
+
+		for(auto value : values)
+		{
+			texts.push_back(uon::format_real(value));
+			bytes += texts.back().size();
+		}
+
+		bench::measure(kind + ": to_chars", [&]()
+			{
+				char buffer[uon::max_number_chars];
+
+				for(auto value : values)
+				{
+					bench::keep(uon::to_chars(buffer, value));
+				}
+			}, bytes);
+
+		bench::measure(kind + ": snprintf search", [&]()
+			{
+				for(auto value : values)
+				{
+					auto text = format_snprintf(value);
+					bench::keep(&text);
+				}
+			}, bytes);
+
+		bench::measure(kind + ": ostringstream", [&]()
+			{
+				for(auto value : values)
+				{
+					auto text = format_stream(value);
+					bench::keep(&text);
+				}
+			}, bytes);
+
+		bench::measure(kind + ": from_chars", [&]()
+			{
+				uon::Real value;
+
+				for(auto& text : texts)
+				{
+					bench::keep(uon::from_chars(text.data(), text.data() + text.size(), value));
+				}
+			}, bytes);
+
+		bench::measure(kind + ": std::stold", [&]()
+			{
+				for(auto& text : texts)
+				{
+					auto value = std::stold(text);
+					bench::keep(&value);
+				}
+			}, bytes);
+
+		bench::measure(kind + ": istringstream", [&]()
+			{
+				for(auto& text : texts)
+				{
+					auto value = parse_stream(text);
+					bench::keep(&value);
+				}
+			}, bytes);
+	}
+
+} // namespace: <anonymous>
+
+// 10000 numbers per call, short decimals as durations and timestamps in
+// reports, and random doubles over the whole range
+OAK_BENCHMARK(number)
+{
+	std::mt19937_64 random(20);
+	std::vector<uon::Real> decimals;
+	std::vector<uon::Real> doubles;
+
+	while(doubles.size() < 10000)
+	{
+		decimals.push_back((random() % 10000000) / 1000.0);
+
+		auto bits = random();
+		uon::Real value;
+		std::memcpy(&value, &bits, sizeof(value));
+
+		if(std::isfinite(value))
+		{
+			doubles.push_back(value);
+		}
+	}
+
+	compare("short decimals", decimals);
+	compare("random doubles", doubles);
+}
@@ -0,0 +1,59 @@
+#include "bench.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+// Two consecutive reports of a branch, as birch consolidates them: the
+// second has a new id, new durations and a few changed lines and status.
+// The consolidated document is written either as the update from diff()
+// or as a whole with $set.
+OAK_BENCHMARK(patch)
+{
+	auto previous = bench::report(20, 10000);
+	// the previous one is read from the database, it shares no nodes
+	auto next = previous.copy();
+
+	next.set("meta.id", "7c9e6679-7425-40de-944b-e07fc1f90ae7");
+
+	for(std::size_t t = 0; t < 20; ++t)
+	{
+		auto& task = next.getref("tasks." + std::to_string(t));
+		task.set("duration", 1.5 * t);
+
+		if(t % 5 == 0)
+		{
+			task.set("status", "ok");
+			task.getref("output.make.output.17.1") = "src/module0/source17.cpp:17:12: warning: unused parameter 'value' [-Wunused-parameter]";
+		}
+	}
+
+	previous.escape_mongo();
+	next.escape_mongo();
+
+	auto update = [&]()
+		{
+			return uon::write_bson(uon::to_mongo_update(uon::diff(previous, next), "consolidated"));
+		};
+
+	auto replace = [&]()
+		{
+			uon::Value op;
+			op.set(std::vector<std::string>{ "$set", "consolidated" }, next);
+			return uon::write_bson(op);
+		};
+
+	std::cout << "  " << std::left << std::setw(40) << "bytes of the update" << std::right << std::setw(12) << update().size() << std::endl;
+	std::cout << "  " << std::left << std::setw(40) << "bytes of the full $set" << std::right << std::setw(12) << replace().size() << std::endl;
+
+	bench::measure("diff and to_mongo_update", [&]()
+		{
+			auto bson = update();
+			bench::keep(&bson);
+		});
+
+	bench::measure("full $set", [&]()
+		{
+			auto bson = replace();
+			bench::keep(&bson);
+		});
+}
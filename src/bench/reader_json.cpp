@@ -0,0 +1,41 @@
+#include "bench.hpp"
+
+#include <sstream>
+
+OAK_BENCHMARK(reader_json)
+{
+	auto json = uon::write_json(bench::report(20, 10000));
+
+	bench::measure("read_json from memory", [&]()
+		{
+			auto value = uon::read_json(json.data(), json.size());
+			bench::keep(&value);
+		}, json.size());
+
+	bench::measure("read_json from a stream", [&]()
+		{
+			std::istringstream input(json);
+			auto value = uon::read_json(input);
+			bench::keep(&value);
+		}, json.size());
+
+	bench::measure("read_json into a handler", [&]()
+		{
+			struct Ignore : uon::Handler
+			{
+				void null() override { }
+				void boolean(uon::Boolean) override { }
+				void integer(uon::Integer) override { }
+				void unsigned_integer(uon::Unsigned) override { }
+				void real(uon::Real) override { }
+				void string(const char*, std::size_t) override { }
+				void begin_object() override { }
+				void key(const char*, std::size_t) override { }
+				void end_object() override { }
+				void begin_array() override { }
+				void end_array() override { }
+			} handler;
+
+			uon::read_json(json.data(), json.size(), handler);
+		}, json.size());
+}
@@ -0,0 +1,110 @@
+#include "bench.hpp"
+
+#include <iomanip>
+#include <iostream>
+
+#include "task_utils.hpp"
+#include "tasks.hpp"
+
+namespace {
+
+	process::TextProcessResult build_log(std::size_t lines)
+	{
+		process::TextProcessResult log;
+
+		for(std::size_t i = 0; i < lines; ++i)
+		{
+			log.output.emplace_back(process::TextProcessResult::INFO_LINE,
+				"[ " + std::to_string(i % 100) + "%] Building CXX object src/CMakeFiles/oak.dir/source_" + std::to_string(i) + ".cpp.o");
+		}
+
+		return log;
+	}
+
+	// the first line of the log below path, through the const overloads
+	// so shared nodes stay shared
+	const char* first_line(const uon::Value& value, const char* path)
+	{
+		return value.getref(path).as_string().data();
+	}
+
+	// A make log from executeTextProcess on its way through the task result
+	// into the report, copying or moving it at each step; counts the steps
+	// at which the lines were copied.
+	template<bool Move>
+	std::size_t into_report(process::TextProcessResult& log, uon::Value& report)
+	{
+		const char* data = log.output.front().second.data();
+		std::size_t copies = 0;
+
+		auto copied = [&](const char* current)
+			{
+				copies += (current != data);
+				data = current;
+			};
+
+		tasks::TaskResult result;
+
+		if(Move)
+			result.output.set("make", task_utils::createTaskOutput("make", {}, "/", std::move(log)));
+		else
+			result.output.set("make", task_utils::createTaskOutput("make", {}, "/", log));
+
+		copied(first_line(result.output, "make.output.0.1"));
+
+		uon::Value taskResult;
+		uon::Value taskResults;
+
+		if(Move)
+		{
+			taskResult.set("details", std::move(result.output));
+			taskResults.set("make", std::move(taskResult));
+			report.set("tasks", std::move(taskResults));
+		}
+		else
+		{
+			taskResult.set("details", result.output);
+			copied(first_line(taskResult, "details.make.output.0.1"));
+			taskResults.set("make", taskResult);
+			copied(first_line(taskResults, "make.details.make.output.0.1"));
+			report.set("tasks", taskResults);
+		}
+
+		copied(first_line(report, "tasks.make.details.make.output.0.1"));
+		return copies;
+	}
+
+	template<bool Move>
+	void run(const std::string& label, std::size_t lines)
+	{
+		auto log = build_log(lines);
+		uon::Value report;
+
+		std::cout << "  " << std::left << std::setw(40) << label + ", copies of the log" << std::right
+			<< std::setw(12) << into_report<Move>(log, report) << std::endl;
+
+		bench::measure(label, [&]()
+			{
+				auto log = build_log(lines);
+				uon::Value report;
+				into_report<Move>(log, report);
+				bench::keep(first_line(report, "tasks.make.details.make.output.0.1"));
+			});
+	}
+
+} // namespace: <anonymous>
+
+// a 100000 line build log from the make task to the report
+OAK_BENCHMARK(task_output)
+{
+	const std::size_t lines = 100000;
+
+	bench::measure("building the log", [&]()
+		{
+			auto log = build_log(lines);
+			bench::keep(log.output.data());
+		});
+
+	run<false>("copied", lines);
+	run<true>("moved", lines);
+}
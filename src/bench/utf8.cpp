@@ -0,0 +1,53 @@
+#include "bench.hpp"
+
+#include <uon/utf8.hpp>
+
+namespace {
+
+	// 16 MB of build output, with every nth line carrying a non-ASCII
+	// character and a line of dirt if dirty
+	std::string build_log(std::size_t every, bool dirty)
+	{
+		std::string log;
+
+		for(std::size_t line = 0; log.size() < 16 * 1024 * 1024; ++line)
+		{
+			log += "src/module" + std::to_string(line % 17) + "/source.cpp:" + std::to_string(line % 300) + ":12: warning: unused variable";
+
+			if(every > 0 && line % every == 0)
+			{
+				log += dirty ? " \x1B[0m\xC3" : " \xE2\x80\x98value\xE2\x80\x99";
+			}
+
+			log += "\n";
+		}
+
+		return log;
+	}
+
+} // namespace: <anonymous>
+
+OAK_BENCHMARK(utf8)
+{
+	auto ascii = build_log(0, false);
+	auto quoted = build_log(10, false);
+	auto dirty = build_log(100, true);
+
+	bench::measure("utf8_valid_prefix ascii", [&]()
+		{
+			auto valid = uon::utf8_valid_prefix(ascii.data(), ascii.size());
+			bench::keep(&valid);
+		}, ascii.size());
+
+	bench::measure("utf8_valid_prefix 10% quoted", [&]()
+		{
+			auto valid = uon::utf8_valid_prefix(quoted.data(), quoted.size());
+			bench::keep(&valid);
+		}, quoted.size());
+
+	bench::measure("utf8_remove_illegal_chars 1% dirty", [&]()
+		{
+			auto clean = uon::utf8_remove_illegal_chars(dirty);
+			bench::keep(&clean);
+		}, dirty.size());
+}
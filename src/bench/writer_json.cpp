@@ -0,0 +1,68 @@
+#include "bench.hpp"
+
+OAK_BENCHMARK(writer_json)
+{
+	auto report = bench::report(20, 10000);
+	auto pretty = uon::write_json(report).size();
+	auto compact = uon::write_json(report, true).size();
+
+	bench::measure("write_json pretty", [&]()
+		{
+			auto json = uon::write_json(report);
+			bench::keep(&json);
+		}, pretty);
+
+	bench::measure("write_json compact", [&]()
+		{
+			auto json = uon::write_json(report, true);
+			bench::keep(&json);
+		}, compact);
+
+	// one thread per core
+	bench::measure("write_json_parallel pretty", [&]()
+		{
+			auto json = uon::write_json_parallel(report);
+			bench::keep(&json);
+		}, pretty);
+
+	bench::measure("write_json_parallel compact", [&]()
+		{
+			auto json = uon::write_json_parallel(report, true);
+			bench::keep(&json);
+		}, compact);
+}
+
+// a report of several hundred megabytes, as from a large build with many
+// warnings, written to a file as oak does
+OAK_BENCHMARK(writer_json_large)
+{
+	auto report = bench::report(40, 100000);
+	auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("oak_bench-%%%%-%%%%.json");
+
+	uon::write_json(report, path);
+	auto pretty = boost::filesystem::file_size(path);
+	uon::write_json(report, path, true);
+	auto compact = boost::filesystem::file_size(path);
+
+	bench::measure("write_json pretty to a file", [&]()
+		{
+			uon::write_json(report, path);
+		}, pretty);
+
+	bench::measure("write_json_parallel pretty to a file", [&]()
+		{
+			uon::write_json_parallel(report, path);
+		}, pretty);
+
+	bench::measure("write_json compact to a file", [&]()
+		{
+			uon::write_json(report, path, true);
+		}, compact);
+
+	bench::measure("write_json_parallel compact to a file", [&]()
+		{
+			uon::write_json_parallel(report, path, true);
+		}, compact);
+
+	boost::filesystem::remove(path);
+}
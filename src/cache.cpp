@@ -0,0 +1,286 @@
+#include "cache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace config {
+
+namespace {
+
+	// entries beyond the newest are removed on store, as are temporary
+	// files left behind by interrupted runs
+	const std::size_t max_entries = 32;
+	const std::time_t max_temporary_age = 60 * 60;
+
+	// 64 bit FNV-1a, stable across builds and platforms
+	const std::uint64_t fnv_offset = 14695981039346656037ULL;
+	const std::uint64_t fnv_prime = 1099511628211ULL;
+
+	std::uint64_t hash(std::uint64_t seed, const char* data, std::size_t size)
+	{
+		for( std::size_t i = 0; i < size; ++i )
+		{
+			seed = (seed ^ static_cast<unsigned char>(data[i])) * fnv_prime;
+		}
+
+		return seed;
+	}
+
+	// the size goes first, so consecutive inputs cannot run into each other
+	std::uint64_t hash(std::uint64_t seed, const std::string& data)
+	{
+		auto size = std::to_string(data.size()) + ":";
+		return hash(hash(seed, size.data(), size.size()), data.data(), data.size());
+	}
+
+	std::string to_hex(std::uint64_t value)
+	{
+		char buffer[17];
+		std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+		return buffer;
+	}
+
+	std::string fingerprint(const boost::filesystem::path& file)
+	{
+		if(!boost::filesystem::is_regular_file(file))
+		{
+			return "none";
+		}
+
+		std::ifstream stream;
+		stream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
+		stream.open( file.string(), std::ios::binary );
+
+		std::stringstream content;
+		content << stream.rdbuf();
+
+		return to_hex(hash(fnv_offset, content.str()));
+	}
+
+	// whether nobody but the current user could have written the file;
+	// the cache directory must not be open to others either, as they
+	// could swap its entries
+	bool is_private(const boost::filesystem::path& file, bool follow)
+	{
+#ifdef _WIN32
+		return true;
+#else
+		struct stat status;
+
+		if((follow ? ::stat(file.c_str(), &status) : ::lstat(file.c_str(), &status)) != 0)
+		{
+			return false;
+		}
+
+		return status.st_uid == ::geteuid() && (status.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+	}
+
+	void create_private_directory(const boost::filesystem::path& directory)
+	{
+#ifdef _WIN32
+		boost::filesystem::create_directories(directory);
+#else
+		if(directory.has_parent_path())
+		{
+			boost::filesystem::create_directories(directory.parent_path());
+		}
+
+		if(::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST)
+		{
+			throw boost::filesystem::filesystem_error("could not create cache directory", directory,
+				boost::system::error_code(errno, boost::system::system_category()));
+		}
+
+		if(!is_private(directory, true))
+		{
+			throw std::runtime_error("cache directory " + directory.string() + " is not private to the user");
+		}
+#endif
+	}
+
+	void prune(const boost::filesystem::path& directory)
+	{
+		boost::system::error_code error;
+		boost::system::error_code ignored;
+		std::vector<std::pair<std::time_t, boost::filesystem::path>> entries;
+		auto now = std::time(nullptr);
+
+		for( boost::filesystem::directory_iterator file(directory, error), end; !error && file != end; file.increment(error) )
+		{
+			auto modified = boost::filesystem::last_write_time(file->path(), ignored);
+
+			if(ignored)
+			{
+				continue;
+			}
+
+			if(file->path().extension() == ".bin")
+			{
+				entries.emplace_back(modified, file->path());
+			}
+			else if(file->path().extension() == ".tmp" && now - modified > max_temporary_age)
+			{
+				boost::filesystem::remove(file->path(), ignored);
+			}
+		}
+
+		if(entries.size() <= max_entries)
+		{
+			return;
+		}
+
+		std::sort(entries.begin(), entries.end());
+
+		for( std::size_t i = 0; i < entries.size() - max_entries; ++i )
+		{
+			boost::filesystem::remove(entries[i].second, ignored);
+		}
+	}
+
+} // namespace: <anonymous>
+
+Cache::Cache(boost::filesystem::path directory)
+	: _directory(std::move(directory))
+	, _hash(fnv_offset)
+{ }
+
+void Cache::add(const std::string& data)
+{
+	_hash = hash(_hash, data);
+}
+
+void Cache::add(const uon::Value& value)
+{
+	add(uon::write_msgpack(value));
+}
+
+void Cache::add_file(const boost::filesystem::path& file)
+{
+	add(file.string());
+	add(fingerprint(file));
+}
+
+boost::filesystem::path Cache::default_directory()
+{
+#ifdef _WIN32
+	const char* local = std::getenv("LOCALAPPDATA");
+
+	if(local != NULL && *local != '\0')
+	{
+		return boost::filesystem::path(local) / "oak";
+	}
+#else
+	// relative values are to be ignored, as for the other XDG variables
+	const char* cache = std::getenv("XDG_CACHE_HOME");
+
+	if(cache != NULL && *cache == '/')
+	{
+		return boost::filesystem::path(cache) / "oak";
+	}
+
+	const char* home = std::getenv("HOME");
+
+	if(home != NULL && *home != '\0')
+	{
+		return boost::filesystem::path(home) / ".cache" / "oak";
+	}
+#endif
+
+	return boost::filesystem::path();
+}
+
+std::string Cache::key() const
+{
+	return to_hex(_hash);
+}
+
+boost::optional<uon::Value> Cache::load() const
+{
+	try
+	{
+		if(!is_private(_directory, true) || !is_private(entry(), false) || !boost::filesystem::is_regular_file(boost::filesystem::symlink_status(entry())))
+		{
+			return boost::none;
+		}
+
+		auto cached = uon::read_msgpack(entry());
+
+		if(cached.get("key").to_string() != key())
+		{
+			return boost::none;
+		}
+
+		for( auto& file : cached.getref("files").as_array() )
+		{
+			if(fingerprint(file.get("path").to_string()) != file.get("fingerprint").to_string())
+			{
+				return boost::none;
+			}
+		}
+
+		return cached.get("layers");
+	}
+	catch( const std::exception& )
+	{
+		return boost::none;
+	}
+}
+
+void Cache::store(const uon::Value& layers, const std::vector<boost::filesystem::path>& files) const
+{
+	uon::Value cached;
+	uon::Array dependencies;
+
+	for( auto& file : files )
+	{
+		uon::Value dependency;
+		dependency.set("path", file.string());
+		dependency.set("fingerprint", fingerprint(file));
+		dependencies.push_back(std::move(dependency));
+	}
+
+	cached.set("key", key());
+	cached.set("files", uon::Value(std::move(dependencies)));
+	cached.set("layers", layers);
+
+	// written aside and renamed, so concurrent runs never see half an entry
+	create_private_directory(_directory);
+
+	auto temporary = _directory / boost::filesystem::unique_path(key() + "-%%%%-%%%%.tmp");
+	uon::write_msgpack(cached, temporary);
+
+	try
+	{
+		// independent of the umask, which may leave it group writable
+		boost::filesystem::permissions(temporary, boost::filesystem::owner_read | boost::filesystem::owner_write);
+		boost::filesystem::rename(temporary, entry());
+	}
+	catch( ... )
+	{
+		boost::system::error_code ignored;
+		boost::filesystem::remove(temporary, ignored);
+		throw;
+	}
+
+	prune(_directory);
+}
+
+boost::filesystem::path Cache::entry() const
+{
+	return _directory / (key() + ".bin");
+}
+
+} // namespace: config
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+#define BOOST_NO_CXX11_SCOPED_ENUMS
+#include <boost/filesystem.hpp>
+#undef BOOST_NO_CXX11_SCOPED_ENUMS
+
+#include <uon/uon.hpp>
+
+namespace config {
+
+	// hash of the sources and compiler settings oak was built from, which
+	// keys the cache; generated by cmake/build_id.cmake
+	extern const char* const build_id;
+
+	// On-disk store of configuration layers (see Config::layers()) for a
+	// fingerprint of their inputs: everything added before load() or
+	// store() makes up the key. An entry also records files it depends on
+	// that could not be part of the key, and is only loaded while they are
+	// unchanged.
+	class Cache
+	{
+	public:
+		explicit Cache(boost::filesystem::path directory);
+
+		// the per-user cache directory: $XDG_CACHE_HOME/oak or ~/.cache/oak,
+		// %LOCALAPPDATA%\oak on windows; empty if there is none
+		static boost::filesystem::path default_directory();
+
+		void add(const std::string& data);
+		void add(const uon::Value& value);
+
+		// the content of the file, or that there is none
+		void add_file(const boost::filesystem::path& file);
+
+		std::string key() const;
+
+		// the layers stored under the key; unreadable entries, and entries
+		// anybody but the current user could have written, count as missing
+		boost::optional<uon::Value> load() const;
+
+		// creates the directory private to the user, and removes all but
+		// the newest entries
+		void store(const uon::Value& layers, const std::vector<boost::filesystem::path>& files) const;
+
+	private:
+		boost::filesystem::path entry() const;
+
+		boost::filesystem::path _directory;
+		std::uint64_t _hash;
+	};
+
+} // namespace: config
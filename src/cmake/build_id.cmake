@@ -0,0 +1,36 @@
+# Writes OUTPUT with the build id of oak, a hash of the sources in
+# SOURCE_DIR and ../libs/uon and of the compiler SETTINGS. Unlike the
+# time of the build it is the same for the same sources, and it changes
+# whichever file changed. The file is only rewritten if the id changed.
+#
+#   cmake -DOUTPUT=<build_id.cpp> -DSOURCE_DIR=<src> -DSETTINGS=<...> -P build_id.cmake
+
+get_filename_component(root ${SOURCE_DIR}/.. ABSOLUTE)
+
+file(GLOB sources RELATIVE ${root}
+	${SOURCE_DIR}/*.cpp ${SOURCE_DIR}/*.hpp
+	${root}/libs/uon/*.cpp ${root}/libs/uon/*.hpp)
+
+# generated files, when building in the source directory
+file(RELATIVE_PATH generated_sources ${root} ${SOURCE_DIR})
+list(REMOVE_ITEM sources ${generated_sources}/build_id.cpp ${generated_sources}/config_builtin.cpp)
+list(SORT sources)
+
+set(content "${SETTINGS}")
+
+foreach(source ${sources})
+	file(SHA1 ${root}/${source} hash)
+	set(content "${content}\n${source} ${hash}")
+endforeach()
+
+string(SHA1 id "${content}")
+
+set(generated "// generated by cmake/build_id.cmake, do not edit\n\n#include \"cache.hpp\"\n\nnamespace config {\n\nconst char* const build_id = \"${id}\";\n\n} // namespace: config\n")
+
+if(EXISTS ${OUTPUT})
+	file(READ ${OUTPUT} existing)
+endif()
+
+if(NOT "${existing}" STREQUAL "${generated}")
+	file(WRITE ${OUTPUT} "${generated}")
+endif()
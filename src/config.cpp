@@ -2,30 +2,208 @@
 
 #include <sstream>
 #include <fstream>
-
-#define BUILTIN_CONFIG(name) \
-	extern unsigned char configs_builtin_##name##_json[]; \
-	extern unsigned int configs_builtin_##name##_json_len;
-
-BUILTIN_CONFIG(base)
-BUILTIN_CONFIG(variant_greenfield)
-BUILTIN_CONFIG(variant_c__)
+#include <algorithm>
 
 namespace config {
 
 namespace builtin {
 
-	const std::string base { configs_builtin_base_json, configs_builtin_base_json + configs_builtin_base_json_len };
+	namespace {
 
-	const std::map<std::string, std::string> variants =
+		uon::Value decode(const Blob& blob)
 		{
-			std::pair<std::string, std::string> { "greenfield", std::string(configs_builtin_variant_greenfield_json, configs_builtin_variant_greenfield_json + configs_builtin_variant_greenfield_json_len) },
-			std::pair<std::string, std::string> { "c++", std::string(configs_builtin_variant_c___json, configs_builtin_variant_c___json + configs_builtin_variant_c___json_len) }
-		};
+			return uon::read_msgpack(reinterpret_cast<const char*>(blob.data), blob.size);
+		}
+
+	} // namespace: <anonymous>
+
+	const uon::Value& base()
+	{
+		static const uon::Value config = []() -> uon::Value
+			{
+				for( std::size_t i = 0; i < blob_count; ++i )
+				{
+					if(std::string(blobs[i].name) == "base")
+						return decode(blobs[i]);
+				}
+
+				throw std::runtime_error("builtin base configuration is missing");
+			}();
+
+		return config;
+	}
+
+	const std::map<std::string, uon::Value>& variants()
+	{
+		static const std::map<std::string, uon::Value> configs = []() -> std::map<std::string, uon::Value>
+			{
+				const std::string prefix = "variant-";
+				std::map<std::string, uon::Value> result;
+
+				for( std::size_t i = 0; i < blob_count; ++i )
+				{
+					std::string name = blobs[i].name;
+
+					if(name.compare(0, prefix.size(), prefix) == 0)
+						result[name.substr(prefix.size())] = decode(blobs[i]);
+				}
+
+				return result;
+			}();
+
+		return configs;
+	}
 
 } // namespace: builtin
 
+namespace {
+
+	const std::vector<Config::Priority> priorities {
+			Config::Priority::Base,
+			Config::Priority::Variant,
+			Config::Priority::Project,
+			Config::Priority::System,
+			Config::Priority::Environment,
+			Config::Priority::Arguments,
+			Config::Priority::Computed
+		};
+
+	// by level, as used in layers
+	const std::vector<std::string> priority_names {
+			"base",
+			"variant",
+			"project",
+			"system",
+			"environment",
+			"arguments",
+			"computed"
+		};
+
+	std::size_t level(Config::Priority priority)
+	{
+		return std::find(priorities.begin(), priorities.end(), priority) - priorities.begin();
+	}
+
+	using Location = std::vector<std::string>;
+
+	Location to_location(const uon::Path& path)
+	{
+		Location location;
+
+		for( auto& segment : path )
+		{
+			location.push_back(segment);
+		}
+
+		return location;
+	}
+
+	Location to_location(const uon::VisitPath& path)
+	{
+		Location location;
+
+		for( auto& segment : path )
+		{
+			location.push_back(segment.key ? *segment.key : std::to_string(segment.index));
+		}
+
+		return location;
+	}
+
+	// segments of a json pointer as used in patches
+	Location parse_pointer(const std::string& pointer)
+	{
+		Location location;
+
+		for( std::size_t i = 0; i < pointer.size(); ++i )
+		{
+			if(pointer[i] == '/')
+			{
+				location.emplace_back();
+			}
+			else
+			if(pointer[i] == '~' && i + 1 < pointer.size())
+			{
+				location.back() += (pointer[++i] == '0') ? '~' : '/';
+			}
+			else
+			{
+				location.back() += pointer[i];
+			}
+		}
+
+		return location;
+	}
+
+	// the value at location in target replaced by the one in source, or
+	// removed if there is none; the parent exists in both
+	void update(uon::Value& target, const uon::Value& source, const Location& location)
+	{
+		auto value = source.find( uon::Path(location) );
+
+		if(location.empty())
+		{
+			target = value ? *value : uon::Value();
+			return;
+		}
+
+		auto parent = target.find( uon::Path(Location(location.begin(), location.end() - 1)) );
+
+		if(parent->is_array())
+		{
+			(*parent->find( uon::Path({ location.back() }) )) = *value;
+			return;
+		}
+
+		auto object = std::move(*parent).as_object();
+
+		if(value)
+		{
+			object[location.back()] = *value;
+		}
+		else
+		{
+			object.erase(location.back());
+		}
+
+		*parent = std::move(object);
+	}
+
+	bool starts_with(const Location& location, const Location& prefix)
+	{
+		return location.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), location.begin());
+	}
+
+	// calls function for the entries of locations at location itself,
+	// above or below it
+	template<typename Map, typename Function>
+	void for_each_related(const Map& locations, const Location& location, Function function)
+	{
+		Location prefix;
+
+		for( std::size_t i = 0; i < location.size(); ++i )
+		{
+			auto entry = locations.find(prefix);
+
+			if(entry != locations.end())
+			{
+				function(entry->second);
+			}
+
+			prefix.push_back(location[i]);
+		}
+
+		for( auto entry = locations.lower_bound(location); entry != locations.end() && starts_with(entry->first, location); ++entry )
+		{
+			function(entry->second);
+		}
+	}
+
+} // namespace: <anonymous>
+
 Config::Config()
+	: _merged(priorities.size(), std::make_pair(uon::Value(uon::Object()), std::size_t(0)))
+	, _dirty(0)
 { }
 
 void Config::apply( Priority priority, std::vector<std::string> variables )
@@ -98,96 +276,408 @@ void Config::apply( Priority priority, std::string path, uon::Value value )
 void Config::apply( Priority priority, uon::Value config )
 {
 	_snippets[priority].push_back(config);
-	merge();
+	_dirty = std::min(_dirty, level(priority));
 }
 
-void Config::merge()
+void Config::merge() const
 {
-	// combine snippets
-	_unresolved = uon::Object();
+	if(_dirty == priorities.size())
+	{
+		return;
+	}
 
-	for( auto priority : std::vector<Priority> {
-			Priority::Base,
-			Priority::Variant,
-			Priority::Project,
-			Priority::System,
-			Priority::Environment,
-			Priority::Arguments,
-			Priority::Computed
-		} )
+	// combine snippets; the first outdated priority only lacks its new
+	// snippets, the ones above are merged onto it again
+	for( auto i = _dirty; i < priorities.size(); ++i )
 	{
-		for( auto snippet : _snippets[priority] )
+		auto& merged = _merged[i];
+
+		if(i != _dirty)
+		{
+			merged = std::make_pair(_merged[i-1].first, std::size_t(0));
+		}
+
+		auto snippets = _snippets.find(priorities[i]);
+
+		if(snippets == _snippets.end())
 		{
-			_unresolved.merge(snippet);
+			continue;
+		}
+
+		for( ; merged.second < snippets->second.size(); ++merged.second )
+		{
+			merged.first.merge(snippets->second[merged.second]);
 		}
 	}
 
-	// resolve variables
-	_resolved = _unresolved;
+	auto previous = _unresolved;
+	_unresolved = _merged.back().first;
 
-	std::function<uon::Value(std::string)> resolve = [&resolve, this](std::string value) -> uon::Value
+	resolve(previous);
+
+	_dirty = priorities.size();
+}
+
+void Config::resolve(const uon::Value& previous) const
+{
+	try
 	{
-		auto i = value.find("${");
+		// the changes since the last resolution, none below another
+		auto patch = uon::diff(previous, _unresolved);
+		std::set<Location> changed;
 
-		if(i == std::string::npos)
+		// more changes than strings with references, e.g. when the task
+		// defaults are added, are resolved faster from scratch
+		if(patch.as_array().size() > _nodes.size())
 		{
-			return uon::Value(value);
+			_nodes.clear();
+			_dependents.clear();
+			changed.insert(Location());
+		}
+		else
+		{
+			for( auto& operation : patch.as_array() )
+			{
+				changed.insert( parse_pointer(operation.getref("path").as_string()) );
+			}
 		}
 
-		auto j = value.find("}", i);
+		// strings with references in there are compiled again
+		const uon::Value& unresolved = _unresolved;
+		std::vector<Location> outdated;
 
-		if( i == 0 && j == (value.length() - 1) )
+		for( auto& location : changed )
 		{
-			auto result = _resolved.get( value.substr(2, value.length()-3), uon::null );
+			auto node = _nodes.lower_bound(location);
+
+			while(node != _nodes.end() && starts_with(node->first, location))
+			{
+				for( auto& reference : node->second.references )
+				{
+					// the same path may be referenced more than once
+					auto dependents = _dependents.find(reference);
+
+					if(dependents == _dependents.end())
+					{
+						continue;
+					}
 
-			if(result.is_string())
+					dependents->second.erase(node->first);
+
+					if(dependents->second.empty())
+					{
+						_dependents.erase(dependents);
+					}
+				}
+
+				node = _nodes.erase(node);
+			}
+
+			auto value = unresolved.find( uon::Path(location) );
+
+			if(!value)
 			{
-				result = resolve(result.as_string());
+				continue;
 			}
 
-			return result;
+			value->visit([&] (const uon::Value& string, const uon::VisitPath& path) -> uon::Visit
+			{
+				if(string.as_string().find("${") != std::string::npos)
+				{
+					auto full = location;
+					auto relative = to_location(path);
+					full.insert(full.end(), relative.begin(), relative.end());
+
+					auto& node = _nodes.emplace(full, compile(full, string.as_string())).first->second;
+
+					for( auto& reference : node.references )
+					{
+						_dependents[reference].insert(full);
+					}
+
+					outdated.push_back(full);
+				}
+
+				return uon::Visit::next;
+			},
+			uon::types(uon::Type::string));
+		}
+
+		// strings referencing changed or outdated values are outdated as well
+		std::vector<Location> affected(changed.begin(), changed.end());
+
+		while(!affected.empty())
+		{
+			auto location = std::move(affected.back());
+			affected.pop_back();
+
+			for_each_related(_dependents, location, [&](const std::set<Location>& dependents)
+			{
+				for( auto& dependent : dependents )
+				{
+					auto& node = _nodes.at(dependent);
+
+					if(node.state == Node::State::done)
+					{
+						node.state = Node::State::outdated;
+						outdated.push_back(dependent);
+						affected.push_back(dependent);
+					}
+				}
+			});
+		}
+
+		// evaluate each outdated string once, in dependency order
+		for( auto& location : changed )
+		{
+			update(_resolved, unresolved, location);
+		}
+
+		for( auto& location : outdated )
+		{
+			auto& node = _nodes.at(location);
+			*_resolved.find(node.path) = evaluate(location, node);
 		}
+	}
+	catch( ... )
+	{
+		// start over on the next access
+		_nodes.clear();
+		_dependents.clear();
+		_evaluating.clear();
+		_unresolved = uon::Value();
+		_resolved = uon::Value();
+		throw;
+	}
+}
 
-		return resolve( value.substr(0, i) + _resolved.get( value.substr(i+2, j-i-2), uon::null ).to_string() + value.substr(j+1) );
-	};
+Config::Node Config::compile(const Location& location, const std::string& text)
+{
+	Node node;
+	node.path = uon::Path(location);
+	node.text = text;
+	node.state = Node::State::outdated;
+
+	std::size_t i = 0;
 
-	_resolved.traverse([&resolve] (uon::Value& value, std::vector<std::string>)
+	for(;;)
 	{
-		if(value.is_string())
+		auto begin = text.find("${", i);
+		auto end = (begin == std::string::npos) ? std::string::npos : text.find("}", begin);
+
+		// an unterminated reference is taken literally
+		if(end == std::string::npos)
 		{
-			value = resolve(value.as_string());
+			node.literals.push_back(text.substr(i));
+			break;
 		}
-	});
+
+		node.literals.push_back(text.substr(i, begin - i));
+		node.paths.emplace_back(text.substr(begin + 2, end - begin - 2));
+		node.references.push_back(to_location(node.paths.back()));
+		i = end + 1;
+	}
+
+	return node;
 }
 
-uon::Value Config::get(std::string path) const
+uon::Value Config::lookup(const Location& location, const uon::Path& path) const
 {
-	return _resolved.get(path);
+	if(location.empty())
+	{
+		return uon::null;
+	}
+
+	const uon::Value* value = &_unresolved;
+
+	for( std::size_t i = 0; i < path.size(); ++i )
+	{
+		if(value->is_object())
+		{
+			auto& object = value->as_object();
+			auto member = object.find(path[i]);
+
+			if(member == object.end())
+			{
+				return uon::null;
+			}
+
+			value = &member->second;
+		}
+		else
+		if(value->is_array())
+		{
+			auto& array = value->as_array();
+			auto index = path.index(i);
+
+			if(index == uon::Path::no_index || index >= array.size())
+			{
+				return uon::null;
+			}
+
+			value = &array[index];
+		}
+		else
+		{
+			// below a string with references, the rest is looked up in its value
+			Location prefix(location.begin(), location.begin() + i);
+			auto node = _nodes.find(prefix);
+
+			if(node == _nodes.end())
+			{
+				return uon::null;
+			}
+
+			auto result = evaluate(prefix, node->second).find( uon::Path(Location(location.begin() + i, location.end())) );
+			return result ? *result : uon::Value(uon::null);
+		}
+	}
+
+	if(value->is_string())
+	{
+		auto node = _nodes.find(location);
+		return (node != _nodes.end()) ? evaluate(location, node->second) : *value;
+	}
+
+	if(!value->is_object() && !value->is_array())
+	{
+		return *value;
+	}
+
+	// objects and arrays are resolved as a whole
+	uon::Value result = *value;
+
+	for( auto i = _nodes.lower_bound(location); i != _nodes.end() && starts_with(i->first, location); ++i )
+	{
+		*result.find( uon::Path(Location(i->first.begin() + location.size(), i->first.end())) ) = evaluate(i->first, i->second);
+	}
+
+	return result;
+}
+
+const uon::Value& Config::evaluate(const Location& location, Node& node) const
+{
+	if(node.state == Node::State::done)
+	{
+		return node.value;
+	}
+
+	if(node.state == Node::State::evaluating)
+	{
+		std::string cycle;
+
+		for( auto i = std::find(_evaluating.begin(), _evaluating.end(), location); i != _evaluating.end(); ++i )
+		{
+			cycle += uon::Path(*i).to_string() + " -> ";
+		}
+
+		throw std::runtime_error("cyclic reference in configuration: " + cycle + uon::Path(location).to_string());
+	}
+
+	node.state = Node::State::evaluating;
+	_evaluating.push_back(location);
+
+	// a single reference is replaced by the value, anything else by text
+	if(node.references.size() == 1 && node.literals[0].empty() && node.literals[1].empty())
+	{
+		node.value = lookup(node.references[0], node.paths[0]);
+	}
+	else
+	{
+		std::string text = node.literals[0];
+
+		for( std::size_t i = 0; i < node.references.size(); ++i )
+		{
+			text += lookup(node.references[i], node.paths[i]).to_string();
+			text += node.literals[i+1];
+		}
+
+		node.value = text;
+	}
+
+	_evaluating.pop_back();
+	node.state = Node::State::done;
+
+	return node.value;
 }
 
-uon::Value Config::get(std::vector<std::string> path) const
+uon::Value Config::get(const uon::Path& path) const
 {
+	merge();
 	return _resolved.get(path);
 }
 
-uon::Value Config::get(std::string path, const uon::Value& defaultValue) const
+uon::Value Config::get(const uon::Path& path, const uon::Value& defaultValue) const
 {
+	merge();
 	return _resolved.get(path, defaultValue);
 }
 
-uon::Value Config::get(std::vector<std::string> path, const uon::Value& defaultValue) const
+const uon::Value& Config::getref(const uon::Path& path) const
 {
-	return _resolved.get(path, defaultValue);
+	merge();
+
+	// through the const overloads, which leave shared nodes shared
+	const uon::Value& resolved = _resolved;
+	return resolved.getref(path);
+}
+
+const uon::Value* Config::find(const uon::Path& path) const
+{
+	merge();
+
+	const uon::Value& resolved = _resolved;
+	return resolved.find(path);
 }
 
 uon::Value Config::unresolved()
 {
+	merge();
 	return _unresolved;
 }
 
 uon::Value Config::resolved()
 {
+	merge();
 	return _resolved;
 }
 
+uon::Value Config::layers() const
+{
+	uon::Object layers;
+
+	for( auto& snippets : _snippets )
+	{
+		layers[priority_names[level(snippets.first)]] = uon::Array(snippets.second.begin(), snippets.second.end());
+	}
+
+	return uon::Value(std::move(layers));
+}
+
+void Config::restore(const uon::Value& layers)
+{
+	_snippets.clear();
+
+	for( auto& layer : layers.as_object() )
+	{
+		auto name = std::find(priority_names.begin(), priority_names.end(), layer.first.str());
+
+		if(name == priority_names.end())
+		{
+			throw std::runtime_error("unknown configuration priority: " + layer.first.str());
+		}
+
+		auto& snippets = _snippets[priorities[name - priority_names.begin()]];
+
+		for( auto& snippet : layer.second.as_array() )
+		{
+			snippets.push_back(snippet);
+		}
+	}
+
+	// merged again from the bottom, resolution stays incremental
+	_merged[0] = std::make_pair(uon::Value(uon::Object()), std::size_t(0));
+	_dirty = 0;
+}
+
 } // namespace: config
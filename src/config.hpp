@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <set>
 
 #define BOOST_NO_CXX11_SCOPED_ENUMS
 #include <boost/filesystem.hpp>
@@ -12,8 +13,21 @@ namespace config {
 
 	namespace builtin {
 
-		extern const std::string base;
-		extern const std::map<std::string, std::string> variants;
+		// configs/builtin/*.json as msgpack, generated by config_compiler
+		struct Blob
+		{
+			const char* name;
+			const unsigned char* data;
+			std::size_t size;
+		};
+
+		extern const Blob blobs[];
+		extern const std::size_t blob_count;
+
+		// decoded on first use; variants are keyed by name without the
+		// "variant-" prefix of their file
+		const uon::Value& base();
+		const std::map<std::string, uon::Value>& variants();
 
 	}  // namespace: builtin
 
@@ -40,27 +54,71 @@ namespace config {
 		void apply( Priority priority, std::string path, uon::Value value );
 		void apply( Priority priority, uon::Value config );
 
-		uon::Value get(std::string path) const;
-		uon::Value get(std::vector<std::string> path) const;
+		// merging and resolution are done on first access after changes
+		uon::Value get(const uon::Path& path) const;
+		uon::Value get(const uon::Path& path, const uon::Value& defaultValue) const;
 
-		uon::Value get(std::string path, const uon::Value& defaultValue) const;
-		uon::Value get(std::vector<std::string> path, const uon::Value& defaultValue) const;
+		const uon::Value& getref(const uon::Path& path) const;
+		const uon::Value* find(const uon::Path& path) const;
 
 		uon::Value unresolved();
 		uon::Value resolved();
 
+		// the applied snippets as object of arrays by priority name, e.g.
+		// for the cache; restore() replaces all snippets by such layers
+		uon::Value layers() const;
+		void restore(const uon::Value& layers);
+
 		Config();
 		Config(const Config& other);
 
 		Config& operator=(const Config& other);
 
 	protected:
-		void merge();
+		using Location = std::vector<std::string>;
+
+		// a string with ${...} references, split into the literal text
+		// around them (one more than references) and the referenced paths
+		struct Node
+		{
+			enum class State { outdated, evaluating, done };
+
+			uon::Path path;
+			std::string text;
+			std::vector<std::string> literals;
+			std::vector<Location> references;
+			std::vector<uon::Path> paths;
+
+			State state;
+			uon::Value value;
+		};
+
+		static Node compile(const Location& location, const std::string& text);
+
+		void merge() const;
+		void resolve(const uon::Value& previous) const;
+
+		uon::Value lookup(const Location& location, const uon::Path& path) const;
+		const uon::Value& evaluate(const Location& location, Node& node) const;
 
 	protected:
 		std::map< Priority, std::vector<uon::Value> > _snippets;
-		uon::Value _unresolved;
-		uon::Value _resolved;
+
+		// snippets merged up to and including each priority, and how many
+		// snippets of that priority are in; priorities from _dirty on are
+		// outdated
+		mutable std::vector< std::pair<uon::Value, std::size_t> > _merged;
+		mutable std::size_t _dirty;
+
+		mutable uon::Value _unresolved;
+		mutable uon::Value _resolved;
+
+		// every string with references in _unresolved, by path, and the
+		// ones referencing each path; values are kept until something they
+		// depend on changes
+		mutable std::map< Location, Node > _nodes;
+		mutable std::map< Location, std::set<Location> > _dependents;
+		mutable std::vector<Location> _evaluating;
 	};
 
 } // namespace: config
@@ -0,0 +1,94 @@
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+#define BOOST_NO_CXX11_SCOPED_ENUMS
+#include <boost/filesystem.hpp>
+#undef BOOST_NO_CXX11_SCOPED_ENUMS
+
+#include <uon/uon.hpp>
+
+// Build step for the builtin configurations: each json file is parsed
+// here and stored as msgpack in a generated source file, so oak only
+// decodes binary data on start and broken json fails the build.
+//
+//   config_compiler <output.cpp> <config.json>...
+//
+// The blobs are named after the files, without extension.
+
+namespace {
+
+	void write_blob(std::ostream& output, std::size_t index, const std::string& data)
+	{
+		output << "const unsigned char blob" << index << "[] = {";
+
+		for(std::size_t i = 0; i < data.size(); ++i)
+		{
+			output << ((i % 16 == 0) ? "\n\t" : " ");
+			output << "0x" << std::hex << std::setw(2) << std::setfill('0') << static_cast<unsigned int>(static_cast<unsigned char>(data[i])) << std::dec << ",";
+		}
+
+		output << "\n};\n\n";
+	}
+
+} // namespace: <anonymous>
+
+int main( int argc, const char* const* argv )
+{
+	if(argc < 2)
+	{
+		std::cerr << "usage: " << argv[0] << " <output.cpp> <config.json>..." << std::endl;
+		return 1;
+	}
+
+	std::ostringstream output;
+
+	output << "// generated by config_compiler, do not edit\n\n";
+	output << "#include \"config.hpp\"\n\n";
+	output << "namespace config {\n\nnamespace builtin {\n\nnamespace {\n\n";
+
+	std::vector<std::string> names;
+
+	for(int i = 2; i < argc; ++i)
+	{
+		boost::filesystem::path input(argv[i]);
+		uon::Value config;
+
+		try
+		{
+			config = uon::read_json(input);
+		}
+		catch(const std::exception& e)
+		{
+			std::cerr << input.string() << ": " << e.what() << std::endl;
+			return 1;
+		}
+
+		write_blob(output, names.size(), uon::write_msgpack(config));
+		names.push_back(input.stem().string());
+	}
+
+	output << "} // namespace: <anonymous>\n\n";
+	output << "const Blob blobs[] = {\n";
+
+	for(std::size_t i = 0; i < names.size(); ++i)
+	{
+		output << "\t{ \"" << names[i] << "\", blob" << i << ", sizeof(blob" << i << ") },\n";
+	}
+
+	output << "};\n\n";
+	output << "const std::size_t blob_count = " << names.size() << ";\n\n";
+	output << "} // namespace: builtin\n\n} // namespace: config\n";
+
+	std::ofstream file(argv[1], std::ios::binary);
+	file << output.str();
+
+	if(!file)
+	{
+		std::cerr << "could not write " << argv[1] << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -25,6 +25,7 @@
 
 #include "tasks.hpp"
 #include "process.hpp"
+#include "cache.hpp"
 
 namespace environment
 {
@@ -122,10 +123,7 @@ int main( int argc, const char* const* argv )
 
 		// read base configuration
 		std::cout << "Load builtin base configuration..." << std::endl;
-		conf.apply(config::Config::Priority::Base, config::builtin::base);
-
-		// generate report id
-		conf.apply(config::Config::Priority::Computed, "meta.id", boost::lexical_cast<std::string>(boost::uuids::random_generator()()));
+		conf.apply(config::Config::Priority::Base, config::builtin::base());
 
 		// read arguments
 		std::cout << "Reading arguments..." << std::endl;
@@ -142,6 +140,9 @@ int main( int argc, const char* const* argv )
 				("output,o", boost::program_options::value<std::string>(&argOutput), "output directory")
 				("options,O", boost::program_options::value<std::vector<std::string>>(&argOptions)->multitoken(), "options: key=value ...")
 				("printconf,p", "print configuration and exit")
+				("binary,b", "also write the report as messagepack (oak.bin)")
+				("parallel", "write the report on several threads, one per core")
+				("no-cache", "neither load nor store the configuration cache")
 				("help,h", "show this text")
 				;
 
@@ -199,22 +200,7 @@ int main( int argc, const char* const* argv )
 		conf.apply(config::Config::Priority::Environment, "meta.system.arch.bitness", (uon::Number)32);
 #endif
 
-#if defined(__linux__) or defined(__APPLE__)
-		{
-			// lsb release id
-			process::TextProcessResult getConfLongBit = process::executeTextProcess("getconf", {"LONG_BIT"}, boost::filesystem::current_path());
-
-			if(getConfLongBit.exitCode == 0 && getConfLongBit.output.size() == 1 && getConfLongBit.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
-			{
-				conf.apply(config::Config::Priority::Environment, "meta.system.arch.bitness", std::stold(getConfLongBit.output[0].second));
-			}
-			else
-			{
-				std::cerr << "Could not detect long bit value via getconf" << std::endl;
-				return 1;
-			}
-		}
-#elif defined(_WIN64)
+#if defined(_WIN64)
 		conf.apply(config::Config::Priority::Environment, "meta.system.arch.bitness", (uon::Number)64);
 #elif defined(__MINGW32__) or defined(_WIN32)
 		{
@@ -237,41 +223,7 @@ int main( int argc, const char* const* argv )
 		conf.apply(config::Config::Priority::Environment, "meta.system.arch.os", std::string("macos"));
 #endif
 
-#if defined(__linux__)
-		{
-			std::string distribution;
-
-			// lsb release id
-			process::TextProcessResult lsbReleaseId = process::executeTextProcess("lsb_release", {"-s", "-i"}, boost::filesystem::current_path());
-
-			if(lsbReleaseId.exitCode == 0 && lsbReleaseId.output.size() == 1 && lsbReleaseId.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
-			{
-				distribution += lsbReleaseId.output[0].second;
-			}
-			else
-			{
-				std::cerr << "Could not detect lsb release id" << std::endl;
-				return 1;
-			}
-
-			// lsb release version
-			process::TextProcessResult lsbReleaseVersion = process::executeTextProcess("lsb_release", {"-s", "-r"}, boost::filesystem::current_path());
-
-			if(lsbReleaseVersion.exitCode == 0 && lsbReleaseVersion.output.size() == 1 && lsbReleaseVersion.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
-			{
-				distribution += std::string("-") + lsbReleaseVersion.output[0].second;
-			}
-			else
-			{
-				std::cerr << "Could not detect lsb release version" << std::endl;
-				return 1;
-			}
-
-			// meta.system.arch.distribution
-			std::transform(distribution.begin(), distribution.end(), distribution.begin(), ::tolower);
-			conf.apply(config::Config::Priority::Environment, "meta.system.arch.distribution", distribution);
-		}
-#elif defined(__MINGW32__) or defined(_WIN32)
+#if defined(__MINGW32__) or defined(_WIN32)
 		{
 			std::string distribution;
 
@@ -320,27 +272,143 @@ int main( int argc, const char* const* argv )
 
 		conf.apply(config::Config::Priority::Arguments, argOptions);
 
-		// apply system configuration
-		boost::filesystem::path sysconf = conf.get("meta.configs.system").to_string();
+		// the detected system properties and the system, project and variant
+		// layers are cached per fingerprint of everything they derive from;
+		// the configuration files are checked when an entry is loaded
+		boost::filesystem::path cacheDirectory = conf.get("meta.configs.cache").to_string();
 
-		if(boost::filesystem::exists(sysconf))
+		if(cacheDirectory.empty())
 		{
-			std::cout << "Load system configuration..." << std::endl;
-			conf.apply(config::Config::Priority::System, sysconf);
+			cacheDirectory = config::Cache::default_directory();
 		}
 
-		// apply project configuration
-		boost::filesystem::path projectconf = conf.get("meta.configs.project").to_string();
+		bool cacheEnabled = vm.count("no-cache") == 0 && !cacheDirectory.empty();
+		config::Cache cache(cacheDirectory);
+
+		// the build, as detection and merging may change without a new version
+		cache.add(std::string(config::build_id));
+
+		for(std::size_t i = 0; i < config::builtin::blob_count; ++i)
+		{
+			cache.add(std::string(reinterpret_cast<const char*>(config::builtin::blobs[i].data), config::builtin::blobs[i].size));
+		}
+
+		cache.add(conf.layers());
+#if defined(__linux__)
+		cache.add_file("/etc/os-release");
+		cache.add_file("/etc/lsb-release");
+#endif
+
+		boost::optional<uon::Value> cachedLayers;
 
-		if(boost::filesystem::exists(projectconf))
+		if(cacheEnabled)
 		{
-			std::cout << "Load project configuration..." << std::endl;
-			conf.apply(config::Config::Priority::Project, projectconf);
+			cachedLayers = cache.load();
 		}
 
-		// apply variant configuration
-		std::cout << "Load variant configuration..." << std::endl;
-		conf.apply(config::Config::Priority::Variant, config::builtin::variants.at(conf.get("meta.variant").to_string()));
+		if(cachedLayers)
+		{
+			std::cout << "Load cached configuration " << cache.key() << "..." << std::endl;
+			conf.restore(*cachedLayers);
+		}
+		else
+		{
+#if defined(__linux__) or defined(__APPLE__)
+			{
+				// lsb release id
+				process::TextProcessResult getConfLongBit = process::executeTextProcess("getconf", {"LONG_BIT"}, boost::filesystem::current_path());
+
+				if(getConfLongBit.exitCode == 0 && getConfLongBit.output.size() == 1 && getConfLongBit.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
+				{
+					conf.apply(config::Config::Priority::Environment, "meta.system.arch.bitness", uon::Value(getConfLongBit.output[0].second).to_number());
+				}
+				else
+				{
+					std::cerr << "Could not detect long bit value via getconf" << std::endl;
+					return 1;
+				}
+			}
+#endif
+
+#if defined(__linux__)
+			{
+				std::string distribution;
+
+				// lsb release id
+				process::TextProcessResult lsbReleaseId = process::executeTextProcess("lsb_release", {"-s", "-i"}, boost::filesystem::current_path());
+
+				if(lsbReleaseId.exitCode == 0 && lsbReleaseId.output.size() == 1 && lsbReleaseId.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
+				{
+					distribution += lsbReleaseId.output[0].second;
+				}
+				else
+				{
+					std::cerr << "Could not detect lsb release id" << std::endl;
+					return 1;
+				}
+
+				// lsb release version
+				process::TextProcessResult lsbReleaseVersion = process::executeTextProcess("lsb_release", {"-s", "-r"}, boost::filesystem::current_path());
+
+				if(lsbReleaseVersion.exitCode == 0 && lsbReleaseVersion.output.size() == 1 && lsbReleaseVersion.output[0].first == process::TextProcessResult::LineType::INFO_LINE)
+				{
+					distribution += std::string("-") + lsbReleaseVersion.output[0].second;
+				}
+				else
+				{
+					std::cerr << "Could not detect lsb release version" << std::endl;
+					return 1;
+				}
+
+				// meta.system.arch.distribution
+				std::transform(distribution.begin(), distribution.end(), distribution.begin(), ::tolower);
+				conf.apply(config::Config::Priority::Environment, "meta.system.arch.distribution", distribution);
+			}
+#endif
+
+			// apply system configuration
+			boost::filesystem::path sysconf = conf.get("meta.configs.system").to_string();
+
+			if(boost::filesystem::exists(sysconf))
+			{
+				std::cout << "Load system configuration..." << std::endl;
+				conf.apply(config::Config::Priority::System, sysconf);
+			}
+
+			// apply project configuration
+			boost::filesystem::path projectconf = conf.get("meta.configs.project").to_string();
+
+			if(boost::filesystem::exists(projectconf))
+			{
+				std::cout << "Load project configuration..." << std::endl;
+				conf.apply(config::Config::Priority::Project, projectconf);
+			}
+
+			// apply variant configuration
+			std::cout << "Load variant configuration..." << std::endl;
+			conf.apply(config::Config::Priority::Variant, config::builtin::variants().at(conf.get("meta.variant").to_string()));
+
+			if(cacheEnabled)
+			{
+				try
+				{
+					cache.store(conf.layers(), { sysconf, projectconf });
+				}
+				catch(const std::exception& e)
+				{
+					std::cerr << "Could not store configuration in cache: " << e.what() << std::endl;
+				}
+			}
+		}
+
+		std::string cacheStatus = !cacheEnabled ? "disabled" : (cachedLayers ? "hit" : "miss");
+
+		std::cout << "Configuration cache " << cacheStatus << ": " << cache.key() << std::endl;
+		conf.apply(config::Config::Priority::Computed, "meta.cache.status", cacheStatus);
+		conf.apply(config::Config::Priority::Computed, "meta.cache.key", cache.key());
+
+		// generate report id
+		conf.apply(config::Config::Priority::Computed, "meta.id", boost::lexical_cast<std::string>(boost::uuids::random_generator()()));
 
 		// detect meta data
 		std::cout << "Detecting meta data..." << std::endl;
@@ -765,14 +833,15 @@ int main( int argc, const char* const* argv )
 
 		conf.apply(config::Config::Priority::Computed, "meta.report",  fs_utils::normalize(conf.get("meta.report").to_string() ).string());
 
-		// task defaults
-		for( auto task : conf.get("tasks").as_object() )
+		// task defaults, applied at once so the config is merged only once
+		std::map<std::string, uon::Value> taskDefaults;
+
+		for( auto& task : conf.getref("tasks").as_object() )
 		{
-			conf.apply(config::Config::Priority::Base,
-				std::string("tasks.") + task.first,
-				conf.get( std::string("taskdefs.") + task.second.get("type").to_string() )
-			);
+			taskDefaults[std::string("tasks.") + task.first.str()] = conf.get( std::string("taskdefs.") + task.second.get("type").to_string() );
 		}
+
+		conf.apply(config::Config::Priority::Base, taskDefaults);
 	}
 	catch ( const std::exception& e )
 	{
@@ -834,9 +903,7 @@ int main( int argc, const char* const* argv )
 			if(taskResolved.find(task) != taskResolved.end())
 				return;
 
-			auto deps = conf.get(std::string("tasks.")+task+std::string(".dependencies")).as_object();
-
-			for(auto dep : deps)
+			for(auto& dep : conf.getref(std::string("tasks.")+task+std::string(".dependencies")).as_object())
 			{
 				if(dep.second.to_boolean())
 				{
@@ -849,7 +916,7 @@ int main( int argc, const char* const* argv )
 			std::cout << task << " ";
 		};
 
-		for ( auto task : conf.get("tasks").as_object() )
+		for ( auto& task : conf.getref("tasks").as_object() )
 		{
 			resolve(task.first);
 		}
@@ -928,14 +995,14 @@ int main( int argc, const char* const* argv )
 
 				taskResult.set("type", taskType );
 				taskResult.set("name", task );
-				taskResult.set("message", result.message );
+				taskResult.set("message", std::move(result.message) );
 				taskResult.set("warnings", uon::Number(result.warnings));
 				taskResult.set("errors",   uon::Number(result.errors));
 				taskResult.set("status", toString(result.status));
-				taskResult.set("details", result.output );
-				taskResult.set("config",  taskConfig);
+				taskResult.set("details", std::move(result.output) );
+				taskResult.set("config",  std::move(taskConfig));
 
-				taskResults.set(task, taskResult);
+				taskResults.set(task, std::move(taskResult));
 			}
 			else
 				throw std::runtime_error(std::string("invalid task type: ") + taskType);
@@ -961,7 +1028,7 @@ int main( int argc, const char* const* argv )
 	{
 		// assemble result
 		output.set("meta", conf.get("meta"));
-		output.set("tasks", taskResults);
+		output.set("tasks", std::move(taskResults));
 
 		// ensure parent directory is created
 		boost::filesystem::create_directories(resultPath.branch_path());
@@ -969,7 +1036,21 @@ int main( int argc, const char* const* argv )
 		// write file
 		std::ofstream stream(resultPath.string());
 		stream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-		uon::write_json(output, stream, false);
+
+		if(vm.count("parallel") > 0)
+		{
+			uon::write_json_parallel(output, stream, false);
+		}
+		else
+		{
+			uon::write_json(output, stream, false);
+		}
+
+		// binary copy for tools that would otherwise parse the json again
+		if(vm.count("binary") > 0)
+		{
+			uon::write_msgpack(output, boost::filesystem::path(resultPath).replace_extension(".bin"));
+		}
 	}
 	catch ( const std::exception& e )
 	{
@@ -1013,7 +1094,7 @@ void publish( const config::Config& conf )
 
 	std::string remote = conf.get("publish.destination.remote").to_string();
 
-	for( auto source : conf.get("publish.sources").as_object() )
+	for( auto& source : conf.getref("publish.sources").as_object() )
 	{
 		std::string srcpath = source.second.to_string();
 		std::string destpath = conf.get("publish.destination.path").to_string() + std::string("/") + source.first;
@@ -149,7 +149,6 @@ TextProcessResult executeTextProcess(boost::filesystem::path binary, std::vector
 						std::getline(lineStream, line);
 
 						boost::replace_all(line, "\033", "");
-						result.output.push_back(std::make_pair(lineType, line));
 
 						if(lineType != TextProcessResult::ERROR_LINE)
 						{
@@ -160,6 +159,8 @@ TextProcessResult executeTextProcess(boost::filesystem::path binary, std::vector
 							std::cerr << line << std::endl;
 						}
 
+						result.output.emplace_back(lineType, std::move(line));
+
 						readLine(pipeEnd, lineBuf, lineType);
 					}
 				});
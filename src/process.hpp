@@ -25,8 +25,6 @@ struct TextProcessResult
 	int exitCode;
 
 	TextProcessResult() : exitCode(0) { }
-	TextProcessResult(const TextProcessResult& o)
-		: output(o.output), exitCode(o.exitCode) { }
 };
 
 std::string toString(TextProcessResult::LineType lineType);
@@ -0,0 +1,46 @@
+#include "schema.hpp"
+
+namespace config {
+
+namespace {
+
+	bool is_scalar(const uon::Value& value)
+	{
+		return !value.is_object() && !value.is_array();
+	}
+
+} // namespace: <anonymous>
+
+void convert(const uon::Value& value, std::string& field)
+{
+	if(!is_scalar(value))
+		throw std::invalid_argument("expected a string");
+
+	field = value.to_string();
+}
+
+void convert(const uon::Value& value, bool& field)
+{
+	if(!is_scalar(value))
+		throw std::invalid_argument("expected a boolean");
+
+	field = value.to_boolean();
+}
+
+void convert(const uon::Value& value, Variables& field)
+{
+	if(!value.is_object())
+		throw std::invalid_argument("expected an object");
+
+	field.clear();
+
+	for(auto& variable : value.as_object())
+	{
+		if(!is_scalar(variable.second))
+			throw std::invalid_argument("expected a string for " + variable.first.str());
+
+		field.emplace_back(variable.first.str(), variable.second.to_string());
+	}
+}
+
+} // namespace: config
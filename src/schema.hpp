@@ -0,0 +1,126 @@
+#pragma once
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <uon/uon.hpp>
+
+namespace config {
+
+	// conversions of config values to field types; they throw
+	// std::invalid_argument naming what was expected
+	using Variables = std::vector<std::pair<std::string, std::string>>;
+
+	void convert(const uon::Value& value, std::string& field);
+	void convert(const uon::Value& value, bool& field);
+	void convert(const uon::Value& value, Variables& field);
+
+	// Binds config values to the members of a plain struct. The fields
+	// are declared once, with their paths parsed then; bind() fills a
+	// struct in one pass and reports all missing or mistyped fields
+	// together, so the consumer needs no further lookups.
+	template<typename Settings>
+	class Schema
+	{
+	public:
+		// a required field, converted by convert() above
+		template<typename T>
+		Schema& field(const uon::Path& path, T Settings::*member);
+
+		// a required field, converted by convert(value) -> T
+		template<typename T, typename Convert>
+		Schema& field(const uon::Path& path, T Settings::*member, Convert convert);
+
+		// a field that keeps defaultValue if it is missing
+		template<typename T>
+		Schema& optional(const uon::Path& path, T Settings::*member, T defaultValue);
+
+		Settings bind(const uon::Value& config) const;
+
+	private:
+		struct Field
+		{
+			uon::Path path;
+			bool required;
+
+			// sets the member from the value, or the default if it is missing
+			std::function<void(Settings&, const uon::Value*)> assign;
+		};
+
+		std::vector<Field> _fields;
+	};
+
+	template<typename Settings>
+	template<typename T>
+	Schema<Settings>& Schema<Settings>::field(const uon::Path& path, T Settings::*member)
+	{
+		_fields.push_back(Field{ path, true, [member](Settings& settings, const uon::Value* value)
+			{
+				convert(*value, settings.*member);
+			} });
+
+		return *this;
+	}
+
+	template<typename Settings>
+	template<typename T, typename Convert>
+	Schema<Settings>& Schema<Settings>::field(const uon::Path& path, T Settings::*member, Convert convert)
+	{
+		_fields.push_back(Field{ path, true, [member, convert](Settings& settings, const uon::Value* value)
+			{
+				settings.*member = convert(*value);
+			} });
+
+		return *this;
+	}
+
+	template<typename Settings>
+	template<typename T>
+	Schema<Settings>& Schema<Settings>::optional(const uon::Path& path, T Settings::*member, T defaultValue)
+	{
+		_fields.push_back(Field{ path, false, [member, defaultValue](Settings& settings, const uon::Value* value)
+			{
+				if(value)
+					convert(*value, settings.*member);
+				else
+					settings.*member = defaultValue;
+			} });
+
+		return *this;
+	}
+
+	template<typename Settings>
+	Settings Schema<Settings>::bind(const uon::Value& config) const
+	{
+		Settings settings;
+		std::string errors;
+
+		for(auto& field : _fields)
+		{
+			auto value = config.find(field.path);
+
+			try
+			{
+				if(!value && field.required)
+					throw std::invalid_argument("missing");
+
+				field.assign(settings, value);
+			}
+			catch(const std::exception& e)
+			{
+				errors += (errors.empty() ? "" : ", ") + field.path.to_string() + ": " + e.what();
+			}
+		}
+
+		if(!errors.empty())
+		{
+			throw std::runtime_error("invalid task configuration: " + errors);
+		}
+
+		return settings;
+	}
+
+} // namespace: config
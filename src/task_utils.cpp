@@ -7,6 +7,11 @@
 namespace task_utils {
 
 uon::Value createTaskOutput(const std::string& binary, const std::vector<std::string>& arguments, const std::string& workingDirectory, const process::TextProcessResult& processResult)
+{
+	return createTaskOutput(binary, arguments, workingDirectory, process::TextProcessResult(processResult));
+}
+
+uon::Value createTaskOutput(const std::string& binary, const std::vector<std::string>& arguments, const std::string& workingDirectory, process::TextProcessResult&& processResult)
 {
 	uon::Value result;
 	result.set("binary", binary);
@@ -14,15 +19,20 @@ uon::Value createTaskOutput(const std::string& binary, const std::vector<std::st
 	result.set("working_dir", workingDirectory);
 
 	uon::Array output_lines;
+	output_lines.reserve(processResult.output.size());
+
 	for(auto& i : processResult.output)
 	{
 		uon::Array line;
-		line.push_back( toString(i.first));  // LineStatus
-		line.push_back( i.second);           // line's content
-		output_lines.push_back( line );
+		line.reserve(2);
+		line.emplace_back( toString(i.first));       // LineStatus
+		line.emplace_back( std::move(i.second));     // line's content
+		output_lines.emplace_back( std::move(line) );
 	}
 
-	result.set("output", output_lines );
+	processResult.output.clear();
+
+	result.set("output", std::move(output_lines) );
 	result.set("exitcode", static_cast<uon::Number>(processResult.exitCode));
 
 	return result;
@@ -6,6 +6,8 @@
 namespace task_utils {
 
 uon::Value createTaskOutput(const std::string& binary, const std::vector<std::string>& arguments, const std::string& workingDirectory, const process::TextProcessResult& processResult);
+// moves the captured lines into the output, processResult.output is left empty
+uon::Value createTaskOutput(const std::string& binary, const std::vector<std::string>& arguments, const std::string& workingDirectory, process::TextProcessResult&& processResult);
 std::string createTaskMessage(const process::TextProcessResult& processResult);
 
 } // namespace: task_utils
@@ -12,22 +12,204 @@
 #include <boost/property_tree/xml_parser.hpp>
 
 #include "tasks.hpp"
+#include "schema.hpp"
 #include "process.hpp"
 #include "task_utils.hpp"
 
 namespace tasks {
 
-TaskResult task_build_cmake             ( uon::Value config );
-TaskResult task_test_googletest         ( uon::Value config );
-TaskResult task_analysis_cppcheck       ( uon::Value config );
-TaskResult task_doc_doxygen             ( uon::Value config );
+// paths used inside the per-line loops, parsed once
+namespace paths {
+
+const uon::Path type("type");
+const uon::Path message("message");
+const uon::Path filename("filename");
+const uon::Path row("row");
+const uon::Path column("column");
+
+} // namespace: paths
+
+struct CMakeVariable
+{
+	std::string name;
+	std::string type;
+	std::string value;
+};
+
+struct BuildCMakeSettings
+{
+	std::string cmakeBinary;
+	std::string cmakeGenerator;
+	std::vector<CMakeVariable> cmakeVariables;
+
+	std::string makeBinary;
+	config::Variables makeVariables;
+
+	std::string hostCompilerC;
+	std::string hostCompilerCXX;
+	std::string hostOS;
+	std::string hostDistribution;
+	std::string hostFamily;
+	std::string hostBitness;
+	std::string hostMisc;
+	std::string hostDescriptor;
+
+	std::string buildCompilerC;
+	std::string buildCompilerCXX;
+	std::string buildOS;
+	std::string buildDistribution;
+	std::string buildFamily;
+	std::string buildBitness;
+	std::string buildMisc;
+	std::string buildDescriptor;
+
+	std::string sourceInput;
+	std::string sourceBase;
+	std::string buildOutput;
+
+	bool installEnabled;
+	std::string installBase;
+	std::string installOutput;
+
+	bool verbose;
+
+	static const config::Schema<BuildCMakeSettings>& schema();
+};
+
+struct TestGoogletestSettings
+{
+	std::string binary;
+	std::string output;
+	std::string filter;
+
+	static const config::Schema<TestGoogletestSettings>& schema();
+};
+
+struct AnalysisCppcheckSettings
+{
+	std::string binary;
+	std::string source;
+	std::string base;
+	std::string output;
+
+	static const config::Schema<AnalysisCppcheckSettings>& schema();
+};
+
+struct DocDoxygenSettings
+{
+	std::string binary;
+	std::string source;
+	std::string output;
+	config::Variables doxyfile;
+
+	static const config::Schema<DocDoxygenSettings>& schema();
+};
+
+const config::Schema<BuildCMakeSettings>& BuildCMakeSettings::schema()
+{
+	static const auto schema = config::Schema<BuildCMakeSettings>()
+		.field("cmake.binary", &BuildCMakeSettings::cmakeBinary)
+		.field("cmake.generator", &BuildCMakeSettings::cmakeGenerator)
+		.field("cmake.variables", &BuildCMakeSettings::cmakeVariables, [](const uon::Value& value)
+			{
+				if(!value.is_object())
+					throw std::invalid_argument("expected an object");
+
+				std::vector<CMakeVariable> variables;
+
+				for(auto& variable : value.as_object())
+				{
+					CMakeVariable bound;
+					bound.name = variable.first.str();
+					config::convert(variable.second.get("type"), bound.type);
+					config::convert(variable.second.get("value"), bound.value);
+					variables.push_back(std::move(bound));
+				}
+
+				return variables;
+			})
+		.field("make.binary", &BuildCMakeSettings::makeBinary)
+		.field("make.variables", &BuildCMakeSettings::makeVariables)
+		.field("arch.host.c.binary", &BuildCMakeSettings::hostCompilerC)
+		.field("arch.host.c++.binary", &BuildCMakeSettings::hostCompilerCXX)
+		.field("arch.host.os", &BuildCMakeSettings::hostOS)
+		.field("arch.host.distribution", &BuildCMakeSettings::hostDistribution)
+		.field("arch.host.family", &BuildCMakeSettings::hostFamily)
+		.field("arch.host.bitness", &BuildCMakeSettings::hostBitness)
+		.field("arch.host.misc", &BuildCMakeSettings::hostMisc)
+		.field("arch.host.descriptor", &BuildCMakeSettings::hostDescriptor)
+		.field("arch.build.c.binary", &BuildCMakeSettings::buildCompilerC)
+		.field("arch.build.c++.binary", &BuildCMakeSettings::buildCompilerCXX)
+		.field("arch.build.os", &BuildCMakeSettings::buildOS)
+		.field("arch.build.distribution", &BuildCMakeSettings::buildDistribution)
+		.field("arch.build.family", &BuildCMakeSettings::buildFamily)
+		.field("arch.build.bitness", &BuildCMakeSettings::buildBitness)
+		.field("arch.build.misc", &BuildCMakeSettings::buildMisc)
+		.field("arch.build.descriptor", &BuildCMakeSettings::buildDescriptor)
+		.field("source.input", &BuildCMakeSettings::sourceInput)
+		.field("source.base", &BuildCMakeSettings::sourceBase)
+		.field("build.output", &BuildCMakeSettings::buildOutput)
+		.field("install.enabled", &BuildCMakeSettings::installEnabled)
+		.optional("install.base", &BuildCMakeSettings::installBase, std::string())
+		.field("install.output", &BuildCMakeSettings::installOutput)
+		.field("verbose", &BuildCMakeSettings::verbose);
+
+	return schema;
+}
+
+const config::Schema<TestGoogletestSettings>& TestGoogletestSettings::schema()
+{
+	static const auto schema = config::Schema<TestGoogletestSettings>()
+		.field("binary", &TestGoogletestSettings::binary)
+		.field("output", &TestGoogletestSettings::output)
+		.field("filter", &TestGoogletestSettings::filter);
+
+	return schema;
+}
+
+const config::Schema<AnalysisCppcheckSettings>& AnalysisCppcheckSettings::schema()
+{
+	static const auto schema = config::Schema<AnalysisCppcheckSettings>()
+		.field("binary", &AnalysisCppcheckSettings::binary)
+		.field("source", &AnalysisCppcheckSettings::source)
+		.field("base", &AnalysisCppcheckSettings::base)
+		.field("output", &AnalysisCppcheckSettings::output);
+
+	return schema;
+}
+
+const config::Schema<DocDoxygenSettings>& DocDoxygenSettings::schema()
+{
+	static const auto schema = config::Schema<DocDoxygenSettings>()
+		.field("binary", &DocDoxygenSettings::binary)
+		.field("source", &DocDoxygenSettings::source)
+		.field("output", &DocDoxygenSettings::output)
+		.field("doxyfile", &DocDoxygenSettings::doxyfile);
+
+	return schema;
+}
+
+// the task config is bound to the settings of the task once, before it runs
+template<typename Settings>
+std::function<TaskResult(uon::Value)> bound( TaskResult (*task)(const Settings&) )
+{
+	return [task](uon::Value config)
+		{
+			return task(Settings::schema().bind(config));
+		};
+}
+
+TaskResult task_build_cmake             ( const BuildCMakeSettings& settings );
+TaskResult task_test_googletest         ( const TestGoogletestSettings& settings );
+TaskResult task_analysis_cppcheck       ( const AnalysisCppcheckSettings& settings );
+TaskResult task_doc_doxygen             ( const DocDoxygenSettings& settings );
 
 std::map<std::string, std::function<TaskResult(uon::Value)>> taskTypes =
 {
-	{ "build:cmake",             task_build_cmake },
-	{ "test:googletest",         task_test_googletest },
-	{ "analysis:cppcheck",       task_analysis_cppcheck },
-	{ "doc:doxygen",             task_doc_doxygen }
+	{ "build:cmake",             bound(task_build_cmake) },
+	{ "test:googletest",         bound(task_test_googletest) },
+	{ "analysis:cppcheck",       bound(task_analysis_cppcheck) },
+	{ "doc:doxygen",             bound(task_doc_doxygen) }
 };
 
 bool copyDir(
@@ -109,68 +291,68 @@ bool copyDir(
     return true;
 }
 
-TaskResult task_build_cmake( uon::Value config )
+TaskResult task_build_cmake( const BuildCMakeSettings& settings )
 {
 	// create directories
-	boost::filesystem::create_directories(config.get("build.output").to_string());
-	boost::filesystem::create_directories(config.get("install.output").to_string());
+	boost::filesystem::create_directories(settings.buildOutput);
+	boost::filesystem::create_directories(settings.installOutput);
 
 	// run cmake
 	TaskResult result;
 
 	std::vector<std::string> cmakeParams {
-		std::string("-DCMAKE_C_COMPILER:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.host.c.binary").to_string(), "\\", "/"),
-		std::string("-DCMAKE_CXX_COMPILER:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.host.c++.binary").to_string(), "\\", "/"),
-		std::string("-DCMAKE_INSTALL_PREFIX:STRING=") + boost::algorithm::replace_all_copy(config.get("install.output").to_string(), "\\", "/"),
-
-		std::string("-DARCH_HOST_COMPILER_C:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.host.c.binary").to_string(), "\\", "/"),
-		std::string("-DARCH_HOST_COMPILER_CXX:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.host.c++.binary").to_string(), "\\", "/"),
-		std::string("-DARCH_HOST_OS:STRING=") + config.get("arch.host.os").to_string(),
-		std::string("-DARCH_HOST_DISTRIBUTION:STRING=") + config.get("arch.host.distribution").to_string(),
-		std::string("-DARCH_HOST_FAMILY:STRING=") + config.get("arch.host.family").to_string(),
-		std::string("-DARCH_HOST_BITNESS:STRING=") + config.get("arch.host.bitness").to_string(),
-		std::string("-DARCH_HOST_MISC:STRING=") + config.get("arch.host.misc").to_string(),
-		std::string("-DARCH_HOST_DESCRIPTOR:STRING=") + config.get("arch.host.descriptor").to_string(),
-
-		std::string("-DARCH_BUILD_COMPILER_C:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.build.c.binary").to_string(), "\\", "/"),
-		std::string("-DARCH_BUILD_COMPILER_CXX:STRING=") + boost::algorithm::replace_all_copy(config.get("arch.build.c++.binary").to_string(), "\\", "/"),
-		std::string("-DARCH_BUILD_OS:STRING=") + config.get("arch.build.os").to_string(),
-		std::string("-DARCH_BUILD_DISTRIBUTION:STRING=") + config.get("arch.build.distribution").to_string(),
-		std::string("-DARCH_BUILD_FAMILY:STRING=") + config.get("arch.build.family").to_string(),
-		std::string("-DARCH_BUILD_BITNESS:STRING=") + config.get("arch.build.bitness").to_string(),
-		std::string("-DARCH_BUILD_MISC:STRING=") + config.get("arch.build.misc").to_string(),
-		std::string("-DARCH_BUILD_DESCRIPTOR:STRING=") + config.get("arch.build.descriptor").to_string()
+		std::string("-DCMAKE_C_COMPILER:STRING=") + boost::algorithm::replace_all_copy(settings.hostCompilerC, "\\", "/"),
+		std::string("-DCMAKE_CXX_COMPILER:STRING=") + boost::algorithm::replace_all_copy(settings.hostCompilerCXX, "\\", "/"),
+		std::string("-DCMAKE_INSTALL_PREFIX:STRING=") + boost::algorithm::replace_all_copy(settings.installOutput, "\\", "/"),
+
+		std::string("-DARCH_HOST_COMPILER_C:STRING=") + boost::algorithm::replace_all_copy(settings.hostCompilerC, "\\", "/"),
+		std::string("-DARCH_HOST_COMPILER_CXX:STRING=") + boost::algorithm::replace_all_copy(settings.hostCompilerCXX, "\\", "/"),
+		std::string("-DARCH_HOST_OS:STRING=") + settings.hostOS,
+		std::string("-DARCH_HOST_DISTRIBUTION:STRING=") + settings.hostDistribution,
+		std::string("-DARCH_HOST_FAMILY:STRING=") + settings.hostFamily,
+		std::string("-DARCH_HOST_BITNESS:STRING=") + settings.hostBitness,
+		std::string("-DARCH_HOST_MISC:STRING=") + settings.hostMisc,
+		std::string("-DARCH_HOST_DESCRIPTOR:STRING=") + settings.hostDescriptor,
+
+		std::string("-DARCH_BUILD_COMPILER_C:STRING=") + boost::algorithm::replace_all_copy(settings.buildCompilerC, "\\", "/"),
+		std::string("-DARCH_BUILD_COMPILER_CXX:STRING=") + boost::algorithm::replace_all_copy(settings.buildCompilerCXX, "\\", "/"),
+		std::string("-DARCH_BUILD_OS:STRING=") + settings.buildOS,
+		std::string("-DARCH_BUILD_DISTRIBUTION:STRING=") + settings.buildDistribution,
+		std::string("-DARCH_BUILD_FAMILY:STRING=") + settings.buildFamily,
+		std::string("-DARCH_BUILD_BITNESS:STRING=") + settings.buildBitness,
+		std::string("-DARCH_BUILD_MISC:STRING=") + settings.buildMisc,
+		std::string("-DARCH_BUILD_DESCRIPTOR:STRING=") + settings.buildDescriptor
 	};
 
-	if(config.get("verbose").to_boolean())
+	if(settings.verbose)
 		{ cmakeParams.push_back(std::string("-DCMAKE_VERBOSE_MAKEFILE:BOOLEAN=ON")); }
 
-	for(auto variable : config.get("cmake.variables").as_object())
+	for(auto& variable : settings.cmakeVariables)
 	{
-		cmakeParams.push_back( std::string("-D") + variable.first + std::string(":")
-			+ variable.second.get("type").to_string() + std::string("=")
-			+ variable.second.get("value").to_string() );
+		cmakeParams.push_back( std::string("-D") + variable.name + std::string(":")
+			+ variable.type + std::string("=")
+			+ variable.value );
 	}
 
-	cmakeParams.push_back(boost::algorithm::replace_all_copy(config.get("source.input").to_string(), "\\", "/"));
+	cmakeParams.push_back(boost::algorithm::replace_all_copy(settings.sourceInput, "\\", "/"));
 
 #ifdef _WIN32
 	cmakeParams.push_back("-G");
-	cmakeParams.push_back(config.get("cmake.generator").to_string());
+	cmakeParams.push_back(settings.cmakeGenerator);
 #endif
 
 	process::TextProcessResult cmakeResult = process::executeTextProcess(
-		config.get("cmake.binary").to_string(),
+		settings.cmakeBinary,
 		cmakeParams,
-		config.get("build.output").to_string());
+		settings.buildOutput);
+
+	result.message = task_utils::createTaskMessage(cmakeResult);
 
 	result.output.set("cmake", task_utils::createTaskOutput(
-		config.get("cmake.binary").to_string(),
+		settings.cmakeBinary,
 		cmakeParams,
-		config.get("build.output").to_string(),
-		cmakeResult));
-
-	result.message = task_utils::createTaskMessage(cmakeResult);
+		settings.buildOutput,
+		std::move(cmakeResult)));
 	result.warnings = 0;
 	result.errors = (cmakeResult.exitCode != 0 ? 1 : 0);
 	result.status = (cmakeResult.exitCode != 0 ? TaskResult::STATUS_ERROR : TaskResult::STATUS_OK);
@@ -180,21 +362,21 @@ TaskResult task_build_cmake( uon::Value config )
 	{
 		std::vector<std::string> makeParams;
 
-		for(auto variable : config.get("make.variables").as_object())
+		for(auto& variable : settings.makeVariables)
 		{
-			makeParams.push_back( variable.first + std::string("=") + variable.second.to_string() );
+			makeParams.push_back( variable.first + std::string("=") + variable.second );
 		}
 
 		process::TextProcessResult makeResult = process::executeTextProcess(
-			config.get("make.binary").to_string(),
+			settings.makeBinary,
 			makeParams,
-			config.get("build.output").to_string());
+			settings.buildOutput);
 
 		uon::Array details;
 
-		auto basePath = boost::algorithm::replace_all_copy(config.get("source.base").to_string(), "\\", "/");
+		auto basePath = boost::algorithm::replace_all_copy(settings.sourceBase, "\\", "/");
 
-		for(auto line : makeResult.output)
+		for(const auto& line : makeResult.output)
 		{
 			auto i_filename = line.second.find(":");
 			auto i_row = line.second.find(":", i_filename+1);
@@ -230,52 +412,54 @@ TaskResult task_build_cmake( uon::Value config )
 				boost::trim_left_if(filename, boost::is_any_of("/"));
 
 				uon::Value details_row;
-				details_row.set("type", type);
-				details_row.set("message", message);
-				details_row.set("filename", filename);
+				details_row.set(paths::type, type);
+				details_row.set(paths::message, message);
+				details_row.set(paths::filename, filename);
 
-                long double row_converted = 0.0;
-                long double column_converted = 0.0;
-                try
+                uon::Real row_converted = 0.0;
+                uon::Real column_converted = 0.0;
+
+                auto converted = [](const std::string& text, uon::Real& value)
                 {
-                    row_converted = std::stold(row);
-                    column_converted = std::stold(column);
-                }
-                catch( ... )
+                    return !text.empty() && uon::from_chars(text.data(), text.data() + text.size(), value) == text.data() + text.size();
+                };
+
+                if(!converted(row, row_converted) || !converted(column, column_converted))
                 {
-                    std::cout << "Could not convert " << row << " or " << column << " to long double" << std::endl;
+                    std::cout << "Could not convert " << row << " or " << column << " to a number" << std::endl;
                 }
 
-                details_row.set("row", row_converted);
-                details_row.set("column", column_converted);
+                details_row.set(paths::row, static_cast<uon::Number>(row_converted));
+                details_row.set(paths::column, static_cast<uon::Number>(column_converted));
                 
-				details.push_back(details_row);
+				details.push_back(std::move(details_row));
 			}
 		}
 
 		uon::unique(details);
-		result.output.set("results", details);
+
+		result.message = task_utils::createTaskMessage(makeResult);
 
 		result.output.set("make", task_utils::createTaskOutput(
-			config.get("make.binary").to_string(),
+			settings.makeBinary,
 			makeParams,
-			config.get("build.output").to_string(),
-			makeResult));
-
-		result.message = task_utils::createTaskMessage(makeResult);
+			settings.buildOutput,
+			std::move(makeResult)));
 
 		result.warnings = accumulate(
 			details.begin(), details.end(), 0,
 			[] (unsigned int count, const uon::Value& el) -> unsigned int {
-				return count + (el.get("type") == "warning" ? 1 : 0);
+				return count + (el.get(paths::type) == "warning" ? 1 : 0);
 			});
 
 		result.errors = accumulate(
 			details.begin(), details.end(), 0,
 			[] (unsigned int count, const uon::Value& el) -> unsigned int {
-				return count + (el.get("type") == "error" ? 1 : 0);
+				return count + (el.get(paths::type) == "error" ? 1 : 0);
 			});
 
+		result.output.set("results", std::move(details));
+
 		result.status =
 			((result.errors > 0 || makeResult.exitCode != 0)
 				? TaskResult::STATUS_ERROR
@@ -284,27 +468,30 @@ TaskResult task_build_cmake( uon::Value config )
 					: TaskResult::STATUS_OK));
 
 		// run install
-		if(makeResult.exitCode == 0 && config.get("install.enabled").to_boolean())
+		if(makeResult.exitCode == 0 && settings.installEnabled)
 		{
+			if(settings.installBase.empty())
+				throw std::runtime_error("invalid task configuration: install.base: missing");
+
 			std::vector<std::string> installParams{ "install" };
 
-			for(auto variable : config.get("make.variables").as_object())
+			for(auto& variable : settings.makeVariables)
 			{
-				installParams.push_back( variable.first + std::string("=") + variable.second.to_string() );
+				installParams.push_back( variable.first + std::string("=") + variable.second );
 			}
 
 			process::TextProcessResult installResult = process::executeTextProcess(
-				config.get("make.binary").to_string(),
+				settings.makeBinary,
 				installParams,
-				config.get("install.base").to_string());
+				settings.installBase);
+
+			result.message = task_utils::createTaskMessage(installResult);
 
 			result.output.set("install", task_utils::createTaskOutput(
-				config.get("make.binary").to_string(),
+				settings.makeBinary,
 				installParams,
-				config.get("install.base").to_string(),
-				installResult));
-
-			result.message = task_utils::createTaskMessage(installResult);
+				settings.installBase,
+				std::move(installResult)));
 			result.errors += (installResult.exitCode != 0 ? 1 : 0);
 
 			result.status =
@@ -320,23 +507,23 @@ TaskResult task_build_cmake( uon::Value config )
 }
 
 
-TaskResult task_test_googletest( uon::Value config )
+TaskResult task_test_googletest( const TestGoogletestSettings& settings )
 {
 	TaskResult result;
 
 	// prepare parameter and dirs
-	boost::filesystem::path xmlFilePath = config.get("output").to_string();
+	boost::filesystem::path xmlFilePath = settings.output;
 	boost::filesystem::path parentPath = xmlFilePath.branch_path();
 
 	boost::filesystem::create_directories(parentPath);
 
 	std::vector<std::string> arguments = {
 		"--gtest_output=xml:" + xmlFilePath.string(),
-		"--gtest_filter=" + config.get("filter").to_string()
+		"--gtest_filter=" + settings.filter
 	};
 
 	// run test
-	process::TextProcessResult testResult = process::executeTextProcess(config.get("binary").to_string(), arguments, parentPath.string());
+	process::TextProcessResult testResult = process::executeTextProcess(settings.binary, arguments, parentPath.string());
 
 	// read XML result file
 	boost::property_tree::ptree xmlTestResult;
@@ -412,7 +599,7 @@ TaskResult task_test_googletest( uon::Value config )
 	result.output.set("tests", table_details);
 
 	// generate console output
-	for(auto line : testResult.output)
+	for(auto& line : testResult.output)
 	{
 		if(line.second.find("[  FAILED  ]") != std::string::npos)
 		{
@@ -425,10 +612,10 @@ TaskResult task_test_googletest( uon::Value config )
 		}
 	}
 
-	result.output.set("googletest", task_utils::createTaskOutput(config.get("binary").to_string(), arguments, parentPath.string(), testResult));
-
 	// generate meta data
 	result.message = task_utils::createTaskMessage(testResult);
+
+	result.output.set("googletest", task_utils::createTaskOutput(settings.binary, arguments, parentPath.string(), std::move(testResult)));
 	result.warnings = 0;
 	result.errors = xmlTestResult.get<int>("testsuites.<xmlattr>.failures") + xmlTestResult.get<int>("testsuites.<xmlattr>.errors");
 	result.status = (result.errors > 0 ? TaskResult::STATUS_ERROR : TaskResult::STATUS_OK);
@@ -437,21 +624,21 @@ TaskResult task_test_googletest( uon::Value config )
 }
 
 
-TaskResult task_analysis_cppcheck( uon::Value config )
+TaskResult task_analysis_cppcheck( const AnalysisCppcheckSettings& settings )
 {
-	boost::filesystem::path xmlFilePath = config.get("output").to_string();
+	boost::filesystem::path xmlFilePath = settings.output;
 	boost::filesystem::path parentPath = xmlFilePath.branch_path();
 
 	boost::filesystem::create_directories(parentPath);
 
 	TaskResult result;
 
-	std::vector<std::string> arguments { "--xml-version=2", "--enable=all", "--suppress=missingIncludeSystem", "--quiet", config.get("source").to_string() };
+	std::vector<std::string> arguments { "--xml-version=2", "--enable=all", "--suppress=missingIncludeSystem", "--quiet", settings.source };
 
 	process::TextProcessResult checkResult = process::executeTextProcess(
-		config.get("binary").to_string(),
+		settings.binary,
 		arguments,
-		config.get("source").to_string());
+		settings.source);
 
 	if(checkResult.exitCode == 0)
 	{
@@ -473,7 +660,7 @@ TaskResult task_analysis_cppcheck( uon::Value config )
 		// write xml data
 		std::ofstream xmlCheckPersistStream;
 		xmlCheckPersistStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
-		xmlCheckPersistStream.open( config.get("output").to_string() );
+		xmlCheckPersistStream.open( settings.output );
 
 		xmlCheckPersistStream << xmlCheckData;
 		xmlCheckPersistStream.close();
@@ -488,7 +675,7 @@ TaskResult task_analysis_cppcheck( uon::Value config )
 
 		// interpret xml data
 
-		auto basePath = boost::algorithm::replace_all_copy(config.get("base").to_string(), "\\", "/");
+		auto basePath = boost::algorithm::replace_all_copy(settings.base, "\\", "/");
 
 		uon::Array errors;
 		for ( auto error : xmlCheckResult.get_child("results.errors") )
@@ -529,27 +716,27 @@ TaskResult task_analysis_cppcheck( uon::Value config )
 		result.errors = 1;
 	}
 
+	result.message = task_utils::createTaskMessage(checkResult);
+
 	result.output.set("cppcheck", task_utils::createTaskOutput(
-		config.get("binary").to_string(),
+		settings.binary,
 		arguments,
-		config.get("source").to_string(),
-		checkResult));
-
-	result.message = task_utils::createTaskMessage(checkResult);
+		settings.source,
+		std::move(checkResult)));
 	result.status = (result.errors > 0 ? TaskResult::STATUS_ERROR : (result.warnings > 0 ?  TaskResult::STATUS_WARNING : TaskResult::STATUS_OK));
 
 	return result;
 }
 
 
-TaskResult task_doc_doxygen( uon::Value config )
+TaskResult task_doc_doxygen( const DocDoxygenSettings& settings )
 {
 	TaskResult result;
 
 	// prepare arguments and dirs
 
-	const std::string sourcePath = config.get("source").to_string();
-	const std::string outputPath = config.get("output").to_string();
+	const std::string sourcePath = settings.source;
+	const std::string outputPath = settings.output;
 	const std::string doxyfilePath = (boost::filesystem::path(outputPath) / boost::filesystem::path("doxyfile")).string();
 
 	boost::filesystem::create_directories(outputPath);
@@ -560,9 +747,9 @@ TaskResult task_doc_doxygen( uon::Value config )
 	doxyfileStream.exceptions( std::ifstream::failbit | std::ifstream::badbit );
 	doxyfileStream.open( doxyfilePath );
 
-	for( auto data : config.get("doxyfile").as_object() )
+	for( auto& data : settings.doxyfile )
 	{
-		doxyfileStream << data.first << " = " << data.second.to_string() << '\n';
+		doxyfileStream << data.first << " = " << data.second << '\n';
 	}
 
 	doxyfileStream << "INPUT" << " = " << sourcePath << '\n';
@@ -571,11 +758,11 @@ TaskResult task_doc_doxygen( uon::Value config )
 	doxyfileStream.close();
 
 	// run doxygen
-	process::TextProcessResult doxygenResult = process::executeTextProcess(config.get("binary").to_string(), std::vector<std::string>{doxyfilePath}, outputPath);
-
-	result.output.set("doxygen", task_utils::createTaskOutput(config.get("binary").to_string(), std::vector<std::string>{doxyfilePath}, outputPath, doxygenResult));
+	process::TextProcessResult doxygenResult = process::executeTextProcess(settings.binary, std::vector<std::string>{doxyfilePath}, outputPath);
 
 	result.message = task_utils::createTaskMessage(doxygenResult);
+
+	result.output.set("doxygen", task_utils::createTaskOutput(settings.binary, std::vector<std::string>{doxyfilePath}, outputPath, std::move(doxygenResult)));
 	result.warnings = 0;
 	result.errors = (doxygenResult.exitCode != 0 ? 1 : 0);
 	result.status = (doxygenResult.exitCode != 0 ? TaskResult::STATUS_ERROR : TaskResult::STATUS_OK);
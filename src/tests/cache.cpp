@@ -0,0 +1,151 @@
+#include <uon/tests/check.hpp>
+
+#include "../cache.hpp"
+
+#include <fstream>
+
+namespace {
+
+	namespace fs = boost::filesystem;
+
+	void write(const fs::path& file, const std::string& content)
+	{
+		std::ofstream stream(file.string(), std::ios::binary | std::ios::trunc);
+		stream << content;
+	}
+
+	// a cache keyed as oak keys it: build, layers and a system file
+	config::Cache cache(const fs::path& directory, const uon::Value& layers, const fs::path& system)
+	{
+		config::Cache cache(directory);
+		cache.add(std::string("build"));
+		cache.add(layers);
+		cache.add_file(system);
+		return cache;
+	}
+
+	std::size_t entries(const fs::path& directory)
+	{
+		std::size_t count = 0;
+
+		for(fs::directory_iterator file(directory), end; file != end; ++file)
+		{
+			count += (file->path().extension() == ".bin") ? 1 : 0;
+		}
+
+		return count;
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(cache)
+{
+	auto root = fs::temp_directory_path() / fs::unique_path("oak-cache-%%%%-%%%%");
+	fs::create_directories(root);
+
+	auto directory = root / "cache";
+	auto system = root / "system.json";
+	auto project = root / "project.json";
+	write(system, "{\"a\":1}");
+	write(project, "{\"b\":2}");
+
+	auto layers = uon::read_json(std::string("{\"system\":{\"a\":1},\"project\":{\"b\":2,\"list\":[1,2.5,\"x\"]}}"));
+	auto arguments = uon::read_json(std::string("{\"meta\":{\"input\":\"/src\"}}"));
+
+	// a miss, also without a directory, then a hit
+	UON_CHECK(!cache(directory, arguments, system).load());
+
+	cache(directory, arguments, system).store(layers, { system, project });
+	UON_CHECK_EQUAL(entries(directory), 1u);
+
+	auto loaded = cache(directory, arguments, system).load();
+	UON_CHECK(loaded && *loaded == layers);
+
+	// the key follows every input, in order
+	UON_CHECK_EQUAL(cache(directory, arguments, system).key(), cache(directory, arguments, system).key());
+	UON_CHECK(!cache(directory, uon::read_json(std::string("{\"meta\":{\"input\":\"/other\"}}")), system).load());
+
+	config::Cache reordered(directory);
+	reordered.add(arguments);
+	reordered.add(std::string("build"));
+	reordered.add_file(system);
+	UON_CHECK(reordered.key() != cache(directory, arguments, system).key());
+
+	config::Cache joined(directory), split(directory);
+	joined.add(std::string("ab"));
+	split.add(std::string("a"));
+	split.add(std::string("b"));
+	UON_CHECK(joined.key() != split.key());
+
+	// a changed project file invalidates the entry, until it is stored again
+	write(project, "{\"b\":3}");
+	UON_CHECK(!cache(directory, arguments, system).load());
+	write(project, "{\"b\":2}");
+	UON_CHECK(cache(directory, arguments, system).load());
+
+	fs::remove(project);
+	UON_CHECK(!cache(directory, arguments, system).load());
+	cache(directory, arguments, system).store(layers, { system, project });
+	UON_CHECK(cache(directory, arguments, system).load());
+	write(project, "{\"b\":2}");
+	UON_CHECK(!cache(directory, arguments, system).load());
+	cache(directory, arguments, system).store(layers, { system, project });
+
+	// a changed system file is part of the key
+	auto before = cache(directory, arguments, system).key();
+	write(system, "{\"a\":2}");
+	UON_CHECK(cache(directory, arguments, system).key() != before);
+	UON_CHECK(!cache(directory, arguments, system).load());
+	write(system, "{\"a\":1}");
+	UON_CHECK(cache(directory, arguments, system).load());
+
+	// corrupt entries count as a miss and are replaced by the next store
+	auto entry = directory / (cache(directory, arguments, system).key() + ".bin");
+	std::string content;
+	{
+		std::ifstream stream(entry.string(), std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	for(auto& corrupt : { std::string(), content.substr(0, content.size() / 2), std::string("\xC1garbage"), content + "x" })
+	{
+		write(entry, corrupt);
+		UON_CHECK(!cache(directory, arguments, system).load());
+	}
+
+	// and so does an intact entry stored under another key
+	config::Cache other(directory);
+	other.add(std::string("other"));
+	other.store(layers, {});
+	fs::rename(directory / (other.key() + ".bin"), entry);
+	UON_CHECK(!cache(directory, arguments, system).load());
+
+	cache(directory, arguments, system).store(layers, { system, project });
+	loaded = cache(directory, arguments, system).load();
+	UON_CHECK(loaded && *loaded == layers);
+
+#ifndef _WIN32
+	// entries others could have written are not trusted
+	fs::permissions(entry, fs::owner_read | fs::owner_write | fs::group_write);
+	UON_CHECK(!cache(directory, arguments, system).load());
+	fs::permissions(entry, fs::owner_read | fs::owner_write);
+	UON_CHECK(cache(directory, arguments, system).load());
+
+	fs::permissions(directory, fs::owner_all | fs::others_write);
+	UON_CHECK(!cache(directory, arguments, system).load());
+	fs::permissions(directory, fs::owner_all);
+	UON_CHECK(cache(directory, arguments, system).load());
+#endif
+
+	// stores keep the newest entries
+	for(int i = 0; i < 40; ++i)
+	{
+		config::Cache numbered(directory);
+		numbered.add(std::to_string(i));
+		numbered.store(layers, {});
+	}
+
+	UON_CHECK_EQUAL(entries(directory), 32u);
+
+	fs::remove_all(root);
+}
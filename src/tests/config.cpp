@@ -0,0 +1,129 @@
+#include <uon/tests/check.hpp>
+
+#include "../config.hpp"
+
+#include <random>
+
+namespace {
+
+	using Priority = config::Config::Priority;
+
+	// the resolution of the same snippets from scratch
+	uon::Value fresh(const config::Config& conf)
+	{
+		config::Config fresh;
+		fresh.restore(conf.layers());
+		return fresh.resolved();
+	}
+
+	void check_resolved(config::Config& conf)
+	{
+		UON_CHECK(conf.resolved() == fresh(conf));
+	}
+
+	// a random snippet over a few keys, with references between them
+	uon::Value snippet(std::mt19937& random)
+	{
+		const char* const keys[] = { "a", "b", "c", "d.e", "d.f", "g.0", "g.1" };
+		auto pick = [&random](std::size_t n) { return static_cast<std::size_t>(random() % n); };
+
+		uon::Value snippet = uon::Object();
+
+		for(std::size_t i = pick(3) + 1; i > 0; --i)
+		{
+			uon::Value value;
+
+			switch(pick(6))
+			{
+				case 0: value = std::string("text") + std::to_string(pick(10)); break;
+				case 1: value = uon::Number(pick(10)); break;
+				case 2: value = std::string("${") + keys[pick(7)] + "}"; break;
+				case 3: value = std::string("x${") + keys[pick(7)] + "}y${" + keys[pick(7)] + "}"; break;
+				case 4: value = uon::read_json(std::string("{\"e\":\"${a}\",\"f\":1}")); break;
+				default: value = uon::read_json(std::string("[\"${b}\",\"${d}\"]")); break;
+			}
+
+			snippet.merge(keys[pick(7)], value);
+		}
+
+		return snippet;
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(config)
+{
+	config::Config conf;
+
+	conf.apply(Priority::Base, uon::read_json(std::string(
+		"{\"a\":\"x\",\"b\":\"${a}-y\",\"c\":\"${b}\",\"d\":{\"e\":\"${a}\",\"n\":1},\"n\":\"${d.n}\",\"l\":[\"${a}\",2],\"u\":\"${a\"}")));
+
+	UON_CHECK_EQUAL(conf.get("b").to_string(), "x-y");
+	UON_CHECK_EQUAL(conf.get("c").to_string(), "x-y");
+	UON_CHECK_EQUAL(conf.get("d.e").to_string(), "x");
+	UON_CHECK(conf.get("n") == uon::Value(uon::Number(1)));
+	UON_CHECK_EQUAL(conf.get("l.0").to_string(), "x");
+	UON_CHECK_EQUAL(conf.get("u").to_string(), "${a");
+
+	// a change re-evaluates the strings depending on it
+	conf.apply(Priority::Environment, "a", uon::Value("z"));
+	UON_CHECK_EQUAL(conf.get("c").to_string(), "z-y");
+	UON_CHECK_EQUAL(conf.get("l.0").to_string(), "z");
+	check_resolved(conf);
+
+	// more changes than references, which are resolved from scratch
+	std::map<std::string, uon::Value> many;
+
+	for(int i = 0; i < 100; ++i)
+	{
+		many["tasks.task" + std::to_string(i) + ".name"] = (i % 10 == 0) ? uon::Value("${a}") : uon::Value("task");
+	}
+
+	conf.apply(Priority::Base, many);
+	UON_CHECK_EQUAL(conf.get("tasks.task10.name").to_string(), "z");
+	UON_CHECK_EQUAL(conf.get("tasks.task11.name").to_string(), "task");
+	check_resolved(conf);
+
+	conf.apply(Priority::Computed, "a", uon::Value("w"));
+	UON_CHECK_EQUAL(conf.get("tasks.task10.name").to_string(), "w");
+	UON_CHECK_EQUAL(conf.get("c").to_string(), "w-y");
+	check_resolved(conf);
+
+	// cycles are reported, and resolution recovers once they are gone
+	conf.apply(Priority::Computed, "a", uon::Value("${c}"));
+
+	try
+	{
+		conf.resolved();
+		uon::tests::fail(__FILE__, __LINE__, "no error for a cycle");
+	}
+	catch(const std::runtime_error& e)
+	{
+		UON_CHECK(std::string(e.what()).find("cyclic reference in configuration: ") == 0);
+	}
+
+	conf.apply(Priority::Computed, "a", uon::Value("v"));
+	UON_CHECK_EQUAL(conf.get("c").to_string(), "v-y");
+	check_resolved(conf);
+
+	// random changes resolve as the same snippets do from scratch
+	for(unsigned int seed = 0; seed < 300; ++seed)
+	{
+		std::mt19937 random(seed);
+		config::Config randomized;
+
+		for(int step = 0; step < 12; ++step)
+		{
+			randomized.apply(static_cast<Priority>(random() % 7), snippet(random));
+
+			uon::Value incremental, expected;
+			bool incrementalFailed = false, expectedFailed = false;
+
+			try { incremental = randomized.resolved(); } catch(const std::runtime_error&) { incrementalFailed = true; }
+			try { expected = fresh(randomized); } catch(const std::runtime_error&) { expectedFailed = true; }
+
+			UON_CHECK_EQUAL(incrementalFailed, expectedFailed);
+			UON_CHECK(incremental == expected);
+		}
+	}
+}
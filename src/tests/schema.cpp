@@ -0,0 +1,138 @@
+#include <uon/tests/check.hpp>
+
+#include "../schema.hpp"
+
+namespace {
+
+	struct Variable
+	{
+		std::string name;
+		std::string type;
+	};
+
+	struct Settings
+	{
+		std::string binary;
+		bool enabled = false;
+		std::string base = "unset";
+		config::Variables variables;
+		std::vector<Variable> typed;
+	};
+
+	const config::Schema<Settings>& schema()
+	{
+		static const auto schema = config::Schema<Settings>()
+			.field("tool.binary", &Settings::binary)
+			.field("install.enabled", &Settings::enabled)
+			.optional("install.base", &Settings::base, std::string("/usr"))
+			.field("make.variables", &Settings::variables)
+			.field("cmake.variables", &Settings::typed, [](const uon::Value& value)
+				{
+					if(!value.is_object())
+						throw std::invalid_argument("expected an object");
+
+					std::vector<Variable> variables;
+
+					for(auto& variable : value.as_object())
+					{
+						Variable bound;
+						bound.name = variable.first.str();
+						config::convert(variable.second.get("type"), bound.type);
+						variables.push_back(std::move(bound));
+					}
+
+					return variables;
+				});
+
+		return schema;
+	}
+
+	uon::Value parse(const std::string& json)
+	{
+		return uon::read_json(json);
+	}
+
+	// the message of the error bind() reports, or "" if it binds
+	std::string error(const uon::Value& config)
+	{
+		try
+		{
+			schema().bind(config);
+		}
+		catch(const std::runtime_error& e)
+		{
+			return e.what();
+		}
+
+		return "";
+	}
+
+} // namespace: <anonymous>
+
+UON_TEST_SUITE(schema)
+{
+	// required fields, converted by convert()
+	auto settings = schema().bind(parse(
+		"{\"tool\":{\"binary\":\"/usr/bin/cmake\"},\"install\":{\"enabled\":true,\"base\":\"/opt\"},"
+		"\"make\":{\"variables\":{\"B\":2,\"A\":\"x\",\"C\":false}},"
+		"\"cmake\":{\"variables\":{\"CMAKE_BUILD_TYPE\":{\"type\":\"STRING\",\"value\":\"Release\"},\"BUILD_TESTS\":{\"type\":\"BOOL\"}}}}"));
+
+	UON_CHECK_EQUAL(settings.binary, "/usr/bin/cmake");
+	UON_CHECK(settings.enabled);
+	UON_CHECK_EQUAL(settings.base, "/opt");
+
+	// variables bind in key order, scalars as their text
+	UON_CHECK(settings.variables == (config::Variables{ { "A", "x" }, { "B", "2" }, { "C", "false" } }));
+
+	// custom conversion
+	UON_CHECK_EQUAL(settings.typed.size(), 2u);
+	UON_CHECK_EQUAL(settings.typed[0].name, "BUILD_TESTS");
+	UON_CHECK_EQUAL(settings.typed[0].type, "BOOL");
+	UON_CHECK_EQUAL(settings.typed[1].name, "CMAKE_BUILD_TYPE");
+	UON_CHECK_EQUAL(settings.typed[1].type, "STRING");
+
+	// an optional field that is missing keeps its default
+	auto minimal = parse("{\"tool\":{\"binary\":\"make\"},\"install\":{\"enabled\":false},\"make\":{\"variables\":{}},\"cmake\":{\"variables\":{}}}");
+	settings = schema().bind(minimal);
+	UON_CHECK(!settings.enabled);
+	UON_CHECK_EQUAL(settings.base, "/usr");
+	UON_CHECK(settings.variables.empty());
+	UON_CHECK(settings.typed.empty());
+
+	// scalars convert like to_string() and to_boolean()
+	auto scalars = minimal.copy();
+	scalars.set("tool.binary", std::uint64_t(42));
+	scalars.set("install.enabled", "true");
+	settings = schema().bind(scalars);
+	UON_CHECK_EQUAL(settings.binary, "42");
+	UON_CHECK(settings.enabled);
+
+	// a single error
+	auto missing = parse("{\"install\":{\"enabled\":false},\"make\":{\"variables\":{}},\"cmake\":{\"variables\":{}}}");
+	UON_CHECK_EQUAL(error(missing), "invalid task configuration: tool.binary: missing");
+
+	auto mistyped = minimal.copy();
+	mistyped.set("install.base", uon::Array{ uon::Value("/usr") });
+	UON_CHECK_EQUAL(error(mistyped), "invalid task configuration: install.base: expected a string");
+
+	// all errors are reported together, in the order of the fields
+	auto broken = parse(
+		"{\"tool\":{\"binary\":{\"path\":\"cmake\"}},\"install\":{\"base\":\"/opt\"},"
+		"\"make\":{\"variables\":{\"A\":[1]}},\"cmake\":{\"variables\":{\"X\":{\"type\":{}}}}}");
+
+	UON_CHECK_EQUAL(error(broken), "invalid task configuration: "
+		"tool.binary: expected a string, "
+		"install.enabled: missing, "
+		"make.variables: expected a string for A, "
+		"cmake.variables: expected a string");
+
+	UON_CHECK_EQUAL(error(parse("{}")), "invalid task configuration: "
+		"tool.binary: missing, install.enabled: missing, make.variables: missing, cmake.variables: missing");
+
+	auto arrays = minimal.copy();
+	arrays.set("make.variables", uon::Array());
+	arrays.set("cmake.variables", "none");
+	arrays.set("install.enabled", uon::Object());
+	UON_CHECK_EQUAL(error(arrays), "invalid task configuration: "
+		"install.enabled: expected a boolean, make.variables: expected an object, cmake.variables: expected an object");
+}